@@ -0,0 +1,145 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/buffer_reader.h>
+#include <libnode/buffer_writer.h>
+
+#include <libj/console.h>
+
+#include <gflags/gflags.h>
+#include <uv.h>
+
+#include <vector>
+
+DEFINE_int32(bytes, 1 << 20, "the size of a frame");
+DEFINE_int32(runs, 100, "the number of frames decoded per benchmark");
+
+namespace libj {
+namespace node {
+namespace example {
+
+// a record of the frame, 16 bytes in big endian
+struct Record {
+    UInt id;
+    UShort kind;
+    Short delta;
+    Double value;
+};
+
+static const Size RECORD_SIZE = 16;
+
+inline void report(const char* name, Size size, Size runs, ULong start) {
+    Double secs = static_cast<Double>(uv_hrtime() - start) / 1e9;
+    Double mbps = static_cast<Double>(size) * runs / secs / (1 << 20);
+    console::printf(
+        console::LEVEL_NORMAL,
+        "%-24s %10.1f MB/s\n",
+        name,
+        mbps);
+}
+
+inline Buffer::Ptr createFrame(Size count) {
+    Buffer::Ptr frame = Buffer::create(count * RECORD_SIZE);
+    BufferWriter writer(frame);
+    for (Size i = 0; i < count; i++) {
+        writer.writeUInt32BE(static_cast<UInt>(i));
+        writer.writeUInt16BE(static_cast<UShort>(i & 0xff));
+        writer.writeInt16BE(static_cast<Short>(-i));
+        writer.writeDoubleBE(static_cast<Double>(i) / 2);
+    }
+    return frame;
+}
+
+inline Double decodeAccessors(Buffer::CPtr frame, std::vector<Record>* out) {
+    Size count = frame->length() / RECORD_SIZE;
+    Double sum = 0;
+    for (Size i = 0; i < count; i++) {
+        Size offset = i * RECORD_SIZE;
+        Record& r = (*out)[i];
+        frame->readUInt32BE(offset, &r.id);
+        frame->readUInt16BE(offset + 4, &r.kind);
+        frame->readInt16BE(offset + 6, &r.delta);
+        frame->readDoubleBE(offset + 8, &r.value);
+        sum += r.value;
+    }
+    return sum;
+}
+
+inline Double decodeReader(Buffer::CPtr frame, std::vector<Record>* out) {
+    Size count = frame->length() / RECORD_SIZE;
+    BufferReader reader(frame);
+    if (!reader.canRead(count * RECORD_SIZE)) return 0;
+
+    Double sum = 0;
+    for (Size i = 0; i < count; i++) {
+        Record& r = (*out)[i];
+        r.id = reader.readUInt32BE();
+        r.kind = reader.readUInt16BE();
+        r.delta = reader.readInt16BE();
+        r.value = reader.readDoubleBE();
+        sum += r.value;
+    }
+    return sum;
+}
+
+inline void benchRecords(Buffer::CPtr frame) {
+    std::vector<Record> records(frame->length() / RECORD_SIZE);
+    Double sum = 0;
+
+    ULong start = uv_hrtime();
+    for (Int i = 0; i < FLAGS_runs; i++) {
+        sum += decodeAccessors(frame, &records);
+    }
+    report("records accessors", frame->length(), FLAGS_runs, start);
+
+    start = uv_hrtime();
+    for (Int i = 0; i < FLAGS_runs; i++) {
+        sum += decodeReader(frame, &records);
+    }
+    report("records reader", frame->length(), FLAGS_runs, start);
+
+    console::printf(console::LEVEL_DEBUG, "checksum %f\n", sum);
+}
+
+inline void benchArray(Buffer::CPtr frame) {
+    Size count = frame->length() / sizeof(UInt);
+    std::vector<UInt> values(count);
+
+    ULong start = uv_hrtime();
+    for (Int i = 0; i < FLAGS_runs; i++) {
+        for (Size j = 0; j < count; j++) {
+            frame->readUInt32BE(j * sizeof(UInt), &values[j]);
+        }
+    }
+    report("uint32be accessors", frame->length(), FLAGS_runs, start);
+
+    start = uv_hrtime();
+    for (Int i = 0; i < FLAGS_runs; i++) {
+        BufferReader reader(frame);
+        reader.readArray<UInt, false>(&values[0], count);
+    }
+    report("uint32be readArray", frame->length(), FLAGS_runs, start);
+}
+
+inline void bufferReader() {
+    Buffer::Ptr frame = createFrame(FLAGS_bytes / RECORD_SIZE);
+    benchRecords(frame);
+    benchArray(frame);
+}
+
+}  // namespace example
+}  // namespace node
+}  // namespace libj
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage(
+        "\n\nusage: buffer-reader [--bytes=N] [--runs=N]");
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    if (FLAGS_bytes < 16 || FLAGS_runs < 1) {
+        libj::console::log("bytes must be >= 16 and runs >= 1");
+        return 0;
+    }
+
+    namespace node = libj::node;
+    node::example::bufferReader();
+    return 0;
+}
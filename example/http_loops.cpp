@@ -0,0 +1,378 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/http.h>
+#include <libnode/loop.h>
+#include <libnode/message_queue.h>
+#include <libnode/node.h>
+#include <libnode/process.h>
+#include <libnode/url.h>
+
+#include <libj/console.h>
+#include <libj/js_array.h>
+#include <libj/string_builder.h>
+#include <libj/this.h>
+
+#include <gflags/gflags.h>
+#include <uv.h>
+
+DEFINE_int32(loops, 1, "the number of server loops");
+DEFINE_int32(clients, 4, "the number of client loops");
+DEFINE_int32(connections, 8, "the number of connections per client loop");
+DEFINE_int32(requests, 100000, "the total number of requests");
+DEFINE_int32(port, 10080, "the port to listen on");
+DEFINE_int32(headers, 1, "the number of fixed response headers (<= 10)");
+DEFINE_bool(header_template, false, "send the fixed headers by a template");
+
+namespace libj {
+namespace node {
+namespace example {
+
+enum Message {
+    LISTENING,
+    DONE,
+    CLOSE,
+};
+
+class CloseQueue : LIBJ_JS_FUNCTION(CloseQueue)
+ public:
+    CloseQueue(
+        MessageQueue::Ptr queue,
+        http::Server::Ptr server = http::Server::null())
+        : queue_(queue)
+        , server_(server) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (server_) server_->close();
+        queue_->close();
+        return UNDEFINED;
+    }
+
+ private:
+    MessageQueue::Ptr queue_;
+    http::Server::Ptr server_;
+};
+
+// the headers an API server sends on every response
+static const char* FIXED_HEADERS[][2] = {
+    { "Content-Type", "text/plain" },
+    { "Cache-Control", "no-cache, no-store, must-revalidate" },
+    { "Server", "libnode" },
+    { "Access-Control-Allow-Origin", "*" },
+    { "Access-Control-Allow-Methods", "GET, POST, OPTIONS" },
+    { "Access-Control-Allow-Headers", "Content-Type, Authorization" },
+    { "X-Content-Type-Options", "nosniff" },
+    { "X-Frame-Options", "DENY" },
+    { "Vary", "Origin" },
+    { "Strict-Transport-Security", "max-age=31536000" },
+};
+
+class OnRequest : LIBJ_JS_FUNCTION(OnRequest)
+ public:
+    OnRequest()
+        : names_(JsArray::create())
+        , values_(JsArray::create())
+        , template_(http::HeaderTemplate::null()) {
+        const Int max = sizeof(FIXED_HEADERS) / sizeof(FIXED_HEADERS[0]);
+        Int n = FLAGS_headers < max ? FLAGS_headers : max;
+        JsObject::Ptr headers = JsObject::create();
+        for (Int i = 0; i < n; i++) {
+            String::CPtr name = str(FIXED_HEADERS[i][0]);
+            String::CPtr value = str(FIXED_HEADERS[i][1]);
+            names_->push(name);
+            values_->push(value);
+            headers->put(name, value);
+        }
+        if (FLAGS_header_template) {
+            template_ = http::HeaderTemplate::create(headers);
+        }
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        LIBJ_STATIC_CONST_STRING_DEF(HELLO_WORLD, "Hello World\n");
+
+        http::ServerResponse::Ptr res = args->getPtr<http::ServerResponse>(1);
+        if (template_) {
+            res->setHeaderTemplate(template_);
+        } else {
+            Size len = names_->length();
+            for (Size i = 0; i < len; i++) {
+                res->setHeader(
+                    names_->getCPtr<String>(i),
+                    values_->getCPtr<String>(i));
+            }
+        }
+        res->end(HELLO_WORLD);
+        return UNDEFINED;
+    }
+
+ private:
+    JsArray::Ptr names_;
+    JsArray::Ptr values_;
+    http::HeaderTemplate::CPtr template_;
+};
+
+class OnServerMessage : LIBJ_JS_FUNCTION(OnServerMessage)
+ public:
+    OnServerMessage(MessageQueue::Ptr queue, http::Server::Ptr server)
+        : queue_(queue)
+        , server_(server) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (to<Int>(args->get(0)) == CLOSE) {
+            // the queue is being iterated
+            process::nextTick(
+                JsFunction::Ptr(new CloseQueue(queue_, server_)));
+        }
+        return UNDEFINED;
+    }
+
+ private:
+    MessageQueue::Ptr queue_;
+    http::Server::Ptr server_;
+};
+
+// every server loop listens on the same port with SO_REUSEPORT
+class ServerSetup : LIBJ_JS_FUNCTION(ServerSetup)
+ public:
+    ServerSetup(MessageQueue::Ptr main)
+        : main_(main)
+        , queue_(MessageQueue::create()) {}
+
+    MessageQueue::Ptr queue() const {
+        return queue_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        http::Server::Ptr srv =
+            http::Server::create(JsFunction::Ptr(new OnRequest()));
+        srv->setReusePort(true);
+        if (!srv->listen(FLAGS_port, str("127.0.0.1"))) {
+            console::error("listen failed");
+        }
+
+        queue_->on(
+            MessageQueue::EVENT_MESSAGE,
+            JsFunction::Ptr(new OnServerMessage(queue_, srv)));
+        queue_->open();
+        main_->postMessage(static_cast<Int>(LISTENING));
+        return UNDEFINED;
+    }
+
+ private:
+    MessageQueue::Ptr main_;
+    MessageQueue::Ptr queue_;
+};
+
+// keeps FLAGS_connections requests in flight over keep-alive sockets
+class Client : LIBJ_JS_FUNCTION(Client)
+ public:
+    Client(MessageQueue::Ptr main, Int requests)
+        : main_(main)
+        , agent_(http::Agent::null())
+        , options_(JsObject::null())
+        , remaining_(requests)
+        , pending_(0) {
+        JsObject::Ptr agentOptions = JsObject::create();
+        agentOptions->put(str("keepAlive"), true);
+        agentOptions->put(str("maxSockets"), FLAGS_connections);
+        agent_ = http::Agent::create(agentOptions);
+
+        StringBuilder::Ptr href = StringBuilder::create();
+        href->appendStr(str("http://127.0.0.1:"));
+        href->append(static_cast<Int>(FLAGS_port));
+        href->appendChar('/');
+        options_ = url::parse(href->toString());
+        options_->put(http::OPTION_AGENT, agent_);
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (!remaining_) return UNDEFINED;
+
+        remaining_--;
+        pending_++;
+        Ptr self = LIBJ_THIS_PTR(Client);
+        http::ClientRequest::Ptr req = http::request(
+            options_,
+            JsFunction::Ptr(new OnResponse(self)));
+        req->on(
+            http::ClientRequest::EVENT_ERROR,
+            JsFunction::Ptr(new OnEnd(self)));
+        req->end();
+        return UNDEFINED;
+    }
+
+ private:
+    void onEnd() {
+        pending_--;
+        if (remaining_) {
+            // the socket is returned to the agent after 'end'
+            process::nextTick(LIBJ_THIS_PTR(Client));
+        } else if (!pending_) {
+            agent_->destroy();
+            main_->postMessage(static_cast<Int>(DONE));
+        }
+    }
+
+    class OnEnd : LIBJ_JS_FUNCTION(OnEnd)
+     public:
+        OnEnd(Client::Ptr client) : client_(client) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            client_->onEnd();
+            return UNDEFINED;
+        }
+
+     private:
+        Client::Ptr client_;
+    };
+
+    class OnResponse : LIBJ_JS_FUNCTION(OnResponse)
+     public:
+        OnResponse(Client::Ptr client) : client_(client) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            http::ClientResponse::Ptr res =
+                args->getPtr<http::ClientResponse>(0);
+            res->on(
+                http::ClientResponse::EVENT_END,
+                JsFunction::Ptr(new OnEnd(client_)));
+            return UNDEFINED;
+        }
+
+     private:
+        Client::Ptr client_;
+    };
+
+    MessageQueue::Ptr main_;
+    http::Agent::Ptr agent_;
+    JsObject::Ptr options_;
+    Int remaining_;
+    Int pending_;
+};
+
+class ClientSetup : LIBJ_JS_FUNCTION(ClientSetup)
+ public:
+    ClientSetup(MessageQueue::Ptr main, Int requests)
+        : main_(main)
+        , requests_(requests) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        JsFunction::Ptr client(new Client(main_, requests_));
+        for (Int i = 0; i < FLAGS_connections; i++) {
+            (*client)();
+        }
+        return UNDEFINED;
+    }
+
+ private:
+    MessageQueue::Ptr main_;
+    Int requests_;
+};
+
+class OnMainMessage : LIBJ_JS_FUNCTION(OnMainMessage)
+ public:
+    OnMainMessage(MessageQueue::Ptr main, JsArray::Ptr loops)
+        : main_(main)
+        , loops_(loops)
+        , servers_(JsArray::create())
+        , listening_(0)
+        , done_(0)
+        , start_(0) {}
+
+    void addServer(MessageQueue::Ptr queue) {
+        servers_->push(queue);
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        switch (to<Int>(args->get(0))) {
+        case LISTENING:
+            if (++listening_ == FLAGS_loops) startClients();
+            break;
+        case DONE:
+            if (++done_ == FLAGS_clients) finish();
+            break;
+        default:
+            break;
+        }
+        return UNDEFINED;
+    }
+
+ private:
+    void startClients() {
+        start_ = uv_hrtime();
+        Int requests = FLAGS_requests / FLAGS_clients;
+        for (Int i = 0; i < FLAGS_clients; i++) {
+            Loop::Ptr loop = Loop::create();
+            loop->start(JsFunction::Ptr(new ClientSetup(main_, requests)));
+            loops_->push(loop);
+        }
+    }
+
+    void finish() {
+        Double msecs = static_cast<Double>(uv_hrtime() - start_) / 1e6;
+        Int requests = FLAGS_requests / FLAGS_clients * FLAGS_clients;
+        console::printf(
+            console::LEVEL_NORMAL,
+            "%d loops, %d headers%s: %d requests in %d ms (%d req/s)\n",
+            FLAGS_loops,
+            FLAGS_headers,
+            FLAGS_header_template ? " by template" : "",
+            requests,
+            static_cast<Int>(msecs),
+            static_cast<Int>(requests / msecs * 1000));
+
+        Size len = servers_->length();
+        for (Size i = 0; i < len; i++) {
+            MessageQueue::Ptr queue = servers_->getPtr<MessageQueue>(i);
+            queue->postMessage(static_cast<Int>(CLOSE));
+        }
+        process::nextTick(JsFunction::Ptr(new CloseQueue(main_)));
+    }
+
+    MessageQueue::Ptr main_;
+    JsArray::Ptr loops_;
+    JsArray::Ptr servers_;
+    Int listening_;
+    Int done_;
+    ULong start_;
+};
+
+inline void httpLoops() {
+    JsArray::Ptr loops = JsArray::create();
+    MessageQueue::Ptr main = MessageQueue::create();
+    OnMainMessage::Ptr onMessage(new OnMainMessage(main, loops));
+    main->on(MessageQueue::EVENT_MESSAGE, onMessage);
+    main->open();
+
+    for (Int i = 0; i < FLAGS_loops; i++) {
+        ServerSetup::Ptr setup(new ServerSetup(main));
+        onMessage->addServer(setup->queue());
+        Loop::Ptr loop = Loop::create();
+        loop->start(setup);
+        loops->push(loop);
+    }
+    node::run();
+
+    Size len = loops->length();
+    for (Size i = 0; i < len; i++) {
+        loops->getPtr<Loop>(i)->join();
+    }
+}
+
+}  // namespace example
+}  // namespace node
+}  // namespace libj
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage(
+        "\n\nusage: http-loops [--loops=N] [--headers=N] [--header_template]");
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    if (FLAGS_loops < 1 || FLAGS_clients < 1 || FLAGS_connections < 1) {
+        libj::console::log("loops, clients and connections must be > 0");
+        return 0;
+    }
+
+    namespace node = libj::node;
+    node::example::httpLoops();
+    return 0;
+}
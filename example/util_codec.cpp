@@ -0,0 +1,196 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/config.h>
+#include <libnode/util.h>
+#include <libnode/detail/util/codec.h>
+
+#include <libj/console.h>
+
+#include <gflags/gflags.h>
+#include <uv.h>
+
+#ifdef LIBNODE_USE_CRYPTO
+# include <openssl/bio.h>
+# include <openssl/buffer.h>
+# include <openssl/evp.h>
+#else
+# include <b64/b64.h>
+#endif
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+DEFINE_int32(bytes, 64 << 20, "the number of bytes encoded per run");
+
+namespace libj {
+namespace node {
+namespace example {
+
+namespace codec = detail::util;
+
+// -- the implementations replaced by detail::util --
+
+inline String::CPtr legacyHexEncode(const void* data, Size len) {
+    const UByte* bytes = static_cast<const UByte*>(data);
+    Buffer::Ptr encoded = Buffer::create(len * 2);
+    for (Size i = 0; i < len; i++) {
+        UByte byte = bytes[i];
+        const UByte msb = (byte >> 4) & 0x0f;
+        const UByte lsb = byte & 0x0f;
+        encoded->writeUInt8(
+            (msb < 10) ? msb + '0' : (msb - 10) + 'a', i * 2);
+        encoded->writeUInt8(
+            (lsb < 10) ? lsb + '0' : (lsb - 10) + 'a', i * 2 + 1);
+    }
+    return encoded->toString();
+}
+
+#ifdef LIBNODE_USE_CRYPTO
+
+inline String::CPtr legacyBase64Encode(const void* data, Size len) {
+    BIO* bio = BIO_new(BIO_f_base64());
+    BIO* bioMem = BIO_new(BIO_s_mem());
+    bio = BIO_push(bio, bioMem);
+    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
+    BIO_write(bio, data, len);
+    BIO_flush(bio);
+
+    BUF_MEM* bufMem;
+    BIO_get_mem_ptr(bio, &bufMem);
+    String::CPtr encoded =
+        String::create(bufMem->data, String::UTF8, bufMem->length);
+    BIO_free_all(bio);
+    return encoded;
+}
+
+#else  // LIBNODE_USE_CRYPTO
+
+inline String::CPtr legacyBase64Encode(const void* data, Size len) {
+    Size size = b64::b64_encode(data, len, NULL, 0);
+    char* buf = new char[size];
+    size = b64::b64_encode(data, len, buf, size);
+    String::CPtr encoded = String::create(buf, String::UTF8, size);
+    delete[] buf;
+    return encoded;
+}
+
+#endif  // LIBNODE_USE_CRYPTO
+
+// -- benchmarks --
+
+inline const char* isaName(codec::Isa isa) {
+    switch (isa) {
+    case codec::ISA_AVX2:  return "avx2";
+    case codec::ISA_SSSE3: return "ssse3";
+    case codec::ISA_SSE2:  return "sse2";
+    default:               return "scalar";
+    }
+}
+
+inline void report(const char* name, Size size, Size runs, ULong start) {
+    Double secs = static_cast<Double>(uv_hrtime() - start) / 1e9;
+    Double mbps = static_cast<Double>(size) * runs / secs / (1 << 20);
+    console::printf(
+        console::LEVEL_NORMAL,
+        "%-24s %8d B: %10.1f MB/s\n",
+        name,
+        static_cast<Int>(size),
+        mbps);
+}
+
+inline void benchRaw(const std::vector<UByte>& data, codec::Isa isa) {
+    Size size = data.size();
+    Size runs = FLAGS_bytes / size;
+    std::string hex(size * 2, '\0');
+    std::string b64(codec::base64EncodedLength(size), '\0');
+    std::vector<UByte> out(size);
+    std::string name;
+
+    codec::setIsa(isa);
+
+    ULong start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) {
+        codec::hexEncode(&data[0], size, &hex[0]);
+    }
+    name = std::string("hex encode ") + isaName(isa);
+    report(name.c_str(), size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) {
+        codec::hexDecode(hex.data(), hex.length(), &out[0]);
+    }
+    name = std::string("hex decode ") + isaName(isa);
+    report(name.c_str(), size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) {
+        codec::base64Encode(&data[0], size, &b64[0]);
+    }
+    name = std::string("base64 encode ") + isaName(isa);
+    report(name.c_str(), size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) {
+        codec::base64Decode(b64.data(), b64.length(), &out[0]);
+    }
+    name = std::string("base64 decode ") + isaName(isa);
+    report(name.c_str(), size, runs, start);
+}
+
+// the String-producing API against the previous implementation
+inline void benchUtil(const std::vector<UByte>& data) {
+    Size size = data.size();
+    Size runs = FLAGS_bytes / size / 16 + 1;
+
+    codec::setIsa(codec::detectedIsa());
+
+    ULong start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) legacyHexEncode(&data[0], size);
+    report("util hex legacy", size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) util::hexEncode(&data[0], size);
+    report("util hex", size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) legacyBase64Encode(&data[0], size);
+    report("util base64 legacy", size, runs, start);
+
+    start = uv_hrtime();
+    for (Size i = 0; i < runs; i++) util::base64Encode(&data[0], size);
+    report("util base64", size, runs, start);
+}
+
+inline void utilCodec() {
+    const Size sizes[] = { 64, 4 << 10, 1 << 20 };
+    for (Size i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        std::vector<UByte> data(sizes[i]);
+        for (Size j = 0; j < data.size(); j++) {
+            data[j] = static_cast<UByte>(rand());
+        }
+
+        for (Int isa = codec::detectedIsa(); isa >= 0; isa--) {
+            benchRaw(data, static_cast<codec::Isa>(isa));
+        }
+        benchUtil(data);
+        console::printf(console::LEVEL_NORMAL, "\n");
+    }
+}
+
+}  // namespace example
+}  // namespace node
+}  // namespace libj
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage("\n\nusage: util-codec [--bytes=N]");
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    if (FLAGS_bytes < (1 << 20)) {
+        libj::console::log("bytes must be >= 1048576");
+        return 0;
+    }
+
+    namespace node = libj::node;
+    node::example::utilCodec();
+    return 0;
+}
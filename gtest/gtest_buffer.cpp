@@ -1,7 +1,11 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <gtest/gtest.h>
 #include <libnode/buffer.h>
+#include <libnode/config.h>
+
+#include <stdio.h>
+#include <string.h>
 
 namespace libj {
 namespace node {
@@ -46,6 +50,132 @@ TEST(GTestBuffer, TestCreate4) {
     ASSERT_TRUE(buf->toString()->equals(str));
 }
 
+TEST(GTestBuffer, TestCreate5) {
+    // U+1F600 is a surrogate pair in UTF-16
+    const UByte d[] = {
+        'a',
+        0xc3, 0xa9,
+        0xf0, 0x9f, 0x98, 0x80,
+        0x00
+    };
+    String::CPtr str = String::create(d, String::UTF8);
+    Buffer::Ptr buf = Buffer::create(str, Buffer::UTF8);
+    ASSERT_EQ(7, buf->length());
+    ASSERT_TRUE(buf->toString()->equals(str));
+
+    buf = Buffer::create(str, Buffer::UTF16BE);
+    ASSERT_EQ(8, buf->length());
+    UShort u16 = 0;
+    ASSERT_TRUE(buf->readUInt16BE(4, &u16));
+    ASSERT_EQ(0xd83d, u16);
+    ASSERT_TRUE(buf->toString(Buffer::UTF16BE)->equals(str));
+
+    buf = Buffer::create(str, Buffer::UTF32LE);
+    ASSERT_EQ(12, buf->length());
+    UInt u32 = 0;
+    ASSERT_TRUE(buf->readUInt32LE(8, &u32));
+    ASSERT_EQ(0x1f600, u32);
+    ASSERT_TRUE(buf->toString(Buffer::UTF32LE)->equals(str));
+}
+
+TEST(GTestBuffer, TestCreateLoneSurrogate) {
+    // every encoding writes a lone surrogate as U+FFFD
+    StringBuilder::Ptr sb = StringBuilder::create();
+    sb->appendChar('a');
+    sb->appendChar(static_cast<Char>(0xd800));
+    sb->appendChar('b');
+    String::CPtr str = sb->toString();
+
+    Buffer::Ptr buf = Buffer::create(str, Buffer::UTF8);
+    ASSERT_EQ(5, buf->length());
+    UByte u8 = 0;
+    ASSERT_TRUE(buf->readUInt8(1, &u8));
+    ASSERT_EQ(0xef, u8);
+
+    buf = Buffer::create(str, Buffer::UTF16BE);
+    ASSERT_EQ(6, buf->length());
+    UShort u16 = 0;
+    ASSERT_TRUE(buf->readUInt16BE(2, &u16));
+    ASSERT_EQ(0xfffd, u16);
+
+    buf = Buffer::create(str, Buffer::UTF16LE);
+    ASSERT_EQ(6, buf->length());
+    ASSERT_TRUE(buf->readUInt16LE(2, &u16));
+    ASSERT_EQ(0xfffd, u16);
+
+    buf = Buffer::create(str, Buffer::UTF32LE);
+    ASSERT_EQ(12, buf->length());
+    UInt u32 = 0;
+    ASSERT_TRUE(buf->readUInt32LE(4, &u32));
+    ASSERT_EQ(0xfffd, u32);
+
+    buf = Buffer::create(str, Buffer::UTF32BE);
+    ASSERT_EQ(12, buf->length());
+    ASSERT_TRUE(buf->readUInt32BE(4, &u32));
+    ASSERT_EQ(0xfffd, u32);
+    ASSERT_TRUE(buf->readUInt32BE(8, &u32));
+    ASSERT_EQ('b', u32);
+}
+
+static Int numDeleted = 0;
+
+static void deleteExternal(void* data) {
+    numDeleted++;
+    delete[] static_cast<char*>(data);
+}
+
+TEST(GTestBuffer, TestCreateExternal) {
+    ASSERT_FALSE(Buffer::createExternal(NULL, 3));
+
+    char* data = new char[5];
+    memcpy(data, "abcde", 5);
+    numDeleted = 0;
+    Buffer::Ptr buf = Buffer::createExternal(data, 5, deleteExternal);
+    ASSERT_EQ(data, buf->data());
+    ASSERT_TRUE(buf->toString()->equals(str("abcde")));
+
+    Buffer::Ptr sliced = buf->slice(1, 4);
+    ASSERT_EQ(data + 1, sliced->data());
+    ASSERT_TRUE(sliced->writeUInt8('x', 0));
+    ASSERT_FALSE(sliced->writeUInt8('x', 3));
+    ASSERT_TRUE(buf->toString()->equals(str("axcde")));
+
+#ifdef LIBNODE_USE_SP
+    buf = Buffer::null();
+    ASSERT_EQ(0, numDeleted);
+    sliced = Buffer::null();
+    ASSERT_EQ(1, numDeleted);
+#endif
+}
+
+#ifdef LIBJ_PF_UNIX
+TEST(GTestBuffer, TestCreateMapped) {
+    ASSERT_FALSE(Buffer::createMapped(str("no-such-file.txt")));
+
+    FILE* fp = fopen("mapped.txt", "w");
+    ASSERT_TRUE(fp != NULL);
+    fputs("0123456789", fp);
+    fclose(fp);
+
+    Buffer::Ptr buf = Buffer::createMapped(str("mapped.txt"));
+    ASSERT_TRUE(buf->toString()->equals(str("0123456789")));
+
+    buf = Buffer::createMapped(str("mapped.txt"), 3, 4);
+    ASSERT_TRUE(buf->toString()->equals(str("3456")));
+    ASSERT_TRUE(buf->slice(2)->toString()->equals(str("56")));
+
+    // private to this process
+    ASSERT_TRUE(buf->writeUInt8('x', 0));
+    buf = Buffer::createMapped(str("mapped.txt"), 8);
+    ASSERT_TRUE(buf->toString()->equals(str("89")));
+    buf = Buffer::createMapped(str("mapped.txt"), 3, 1);
+    ASSERT_TRUE(buf->toString()->equals(str("3")));
+
+    ASSERT_FALSE(Buffer::createMapped(str("mapped.txt"), 11));
+    remove("mapped.txt");
+}
+#endif
+
 TEST(GTestBuffer, TestByteLength) {
     const UByte d[] = {
         0xe3, 0x81, 0x82,
@@ -62,6 +192,36 @@ TEST(GTestBuffer, TestByteLength) {
     ASSERT_EQ(12, Buffer::byteLength(str, Buffer::UTF32LE));
 }
 
+TEST(GTestBuffer, TestByteLength2) {
+    StringBuilder::Ptr sb = StringBuilder::create();
+    for (Size i = 0; i < 100; i++) {
+        sb->appendStr(str("0123456789abcdefghijklmnopqrstuvwxyz"));
+        sb->appendChar(0xe9);
+        sb->appendChar(0x3042);
+    }
+    String::CPtr s = sb->toString();
+    ASSERT_EQ(4100, Buffer::byteLength(s));
+    ASSERT_EQ(4100, Buffer::create(s)->length());
+    ASSERT_EQ(4100, Buffer::create(sb)->length());
+    ASSERT_TRUE(Buffer::create(s)->toString()->equals(s));
+}
+
+TEST(GTestBuffer, TestWrite) {
+    const UByte d[] = {
+        'a', 'b',
+        0xe3, 0x81, 0x82,
+        0x00
+    };
+    String::CPtr str = String::create(d, String::UTF8);
+    Buffer::Ptr buf = Buffer::create(6);
+    ASSERT_EQ(5, buf->write(str));
+    ASSERT_EQ(2, buf->write(str, 2));
+    ASSERT_EQ(2, buf->write(str, 0, 4));
+    ASSERT_EQ(4, buf->write(str, 0, 5, Buffer::UTF16LE));
+    ASSERT_EQ(-1, buf->write(str, 7));
+    ASSERT_EQ(-1, buf->write(str, 0, 6, Buffer::HEX));
+}
+
 TEST(GTestBuffer, TestCopy) {
     Buffer::Ptr buf1 = Buffer::create("abcde", 5);
     Buffer::Ptr buf2 = Buffer::create("xyz", 3);
@@ -92,6 +252,50 @@ TEST(GTestBuffer, TestConcat2) {
     ASSERT_TRUE(buf->toString()->equals(str("abcxyz")));
 }
 
+TEST(GTestBuffer, TestIndexOf) {
+    Buffer::Ptr buf = Buffer::create(str("abcabcxyzabcxyz"));
+    ASSERT_EQ(0, buf->indexOf(str("abc")));
+    ASSERT_EQ(3, buf->indexOf(str("abc"), 1));
+    ASSERT_EQ(6, buf->indexOf(str("xyz")));
+    ASSERT_EQ(12, buf->indexOf(Buffer::create("xyz", 3), 7));
+    ASSERT_EQ(8, buf->indexOf(static_cast<Int>('z')));
+    ASSERT_EQ(NO_POS, buf->indexOf(str("xyzz")));
+    ASSERT_EQ(NO_POS, buf->indexOf(str("abc"), 16));
+    ASSERT_TRUE(buf->includes(str("cxy")));
+    ASSERT_FALSE(buf->includes(str("cxy"), 12));
+
+    Buffer::Ptr large = Buffer::create(1000);
+    large->fill(static_cast<Int>('a'));
+    large->write(str("ab"), 998);
+    ASSERT_EQ(997, large->indexOf(str("aab")));
+    ASSERT_EQ(NO_POS, large->indexOf(str("ba")));
+}
+
+TEST(GTestBuffer, TestEqualsCompare) {
+    Buffer::Ptr buf1 = Buffer::create("abc", 3);
+    Buffer::Ptr buf2 = Buffer::create("abd", 3);
+    Buffer::Ptr buf3 = Buffer::create("ab", 2);
+    ASSERT_TRUE(buf1->equals(buf1->slice(0)));
+    ASSERT_FALSE(buf1->equals(buf2));
+    ASSERT_FALSE(buf1->equals(buf3));
+    ASSERT_EQ(0, buf1->compare(buf1->slice(0)));
+    ASSERT_EQ(-1, buf1->compare(buf2));
+    ASSERT_EQ(1, buf2->compare(buf1));
+    ASSERT_EQ(1, buf1->compare(buf3));
+    ASSERT_EQ(-1, buf3->compare(buf1));
+}
+
+TEST(GTestBuffer, TestFill) {
+    Buffer::Ptr buf = Buffer::create(7);
+    ASSERT_TRUE(buf->fill(0x178));
+    ASSERT_TRUE(buf->toString()->equals(str("xxxxxxx")));
+    ASSERT_TRUE(buf->fill(str("abc"), 1, 6));
+    ASSERT_TRUE(buf->toString()->equals(str("xabcabx")));
+    ASSERT_TRUE(buf->fill(Buffer::create("yz", 2), 5));
+    ASSERT_TRUE(buf->toString()->equals(str("xabcayz")));
+    ASSERT_FALSE(buf->fill(str("a"), 8));
+}
+
 TEST(GTestBuffer, TestWriteRead) {
     Buffer::Ptr buf = Buffer::create(2);
     Byte wb = 15;
@@ -0,0 +1,97 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/buffer_list.h>
+
+namespace libj {
+namespace node {
+
+static BufferList::Ptr createList() {
+    BufferList::Ptr list = BufferList::create();
+    list->append(Buffer::create(str("abc")));
+    list->append(Buffer::create(str("de")));
+    list->append(Buffer::create());
+    list->append(Buffer::create(str("fghi")));
+    return list;
+}
+
+TEST(GTestBufferList, TestAppend) {
+    BufferList::Ptr list = BufferList::create();
+    ASSERT_TRUE(list->isEmpty());
+    ASSERT_FALSE(list->append(Buffer::null()));
+
+    list = createList();
+    ASSERT_FALSE(list->isEmpty());
+    ASSERT_EQ(9, list->length());
+    ASSERT_EQ(3, list->numBuffers());
+
+    ASSERT_TRUE(list->prepend(Buffer::create(str("xy"))));
+    ASSERT_EQ(11, list->length());
+    ASSERT_TRUE(list->flatten()->toString()->equals(str("xyabcdefghi")));
+}
+
+TEST(GTestBufferList, TestShift) {
+    BufferList::Ptr list = createList();
+    ASSERT_TRUE(list->shift()->toString()->equals(str("abc")));
+    ASSERT_EQ(6, list->length());
+    ASSERT_TRUE(list->shift()->toString()->equals(str("de")));
+    ASSERT_TRUE(list->shift()->toString()->equals(str("fghi")));
+    ASSERT_TRUE(list->isEmpty());
+    ASSERT_FALSE(list->shift());
+}
+
+TEST(GTestBufferList, TestConsume) {
+    BufferList::Ptr list = createList();
+    ASSERT_EQ(4, list->consume(4));
+    ASSERT_EQ(5, list->length());
+    ASSERT_EQ(2, list->numBuffers());
+    ASSERT_TRUE(list->flatten()->toString()->equals(str("efghi")));
+
+    ASSERT_EQ(5, list->consume(10));
+    ASSERT_TRUE(list->isEmpty());
+    ASSERT_EQ(0, list->numBuffers());
+}
+
+TEST(GTestBufferList, TestIndexOf) {
+    BufferList::Ptr list = createList();
+    ASSERT_EQ(0, list->indexOf(str("abc")));
+    ASSERT_EQ(2, list->indexOf(str("cdef")));
+    ASSERT_EQ(4, list->indexOf(str("efg")));
+    ASSERT_EQ(8, list->indexOf(str("i")));
+    ASSERT_EQ(3, list->indexOf(str(""), 3));
+    ASSERT_EQ(NO_POS, list->indexOf(str("cdf")));
+    ASSERT_EQ(NO_POS, list->indexOf(str("hij")));
+    ASSERT_EQ(NO_POS, list->indexOf(str("abc"), 1));
+    ASSERT_EQ(NO_POS, list->indexOf(Buffer::null()));
+
+    list = BufferList::create();
+    list->append(Buffer::create(str("\r")));
+    list->append(Buffer::create(str("\n\r")));
+    list->append(Buffer::create(str("\n")));
+    ASSERT_EQ(0, list->indexOf(str("\r\n\r\n")));
+}
+
+TEST(GTestBufferList, TestCopy) {
+    BufferList::Ptr list = createList();
+    Buffer::Ptr buf = Buffer::create(str("0123"));
+    ASSERT_EQ(3, list->copy(buf, 1, 2, 7));
+    ASSERT_TRUE(buf->toString()->equals(str("0cde")));
+    ASSERT_EQ(0, list->copy(buf, 4));
+}
+
+TEST(GTestBufferList, TestFlatten) {
+    BufferList::Ptr list = BufferList::create();
+    ASSERT_EQ(0, list->flatten()->length());
+
+    Buffer::Ptr buf = Buffer::create(str("abc"));
+    list->append(buf);
+    ASSERT_EQ(buf, list->flatten());
+
+    list = createList();
+    ASSERT_TRUE(list->flatten()->toString()->equals(str("abcdefghi")));
+    list->clear();
+    ASSERT_TRUE(list->isEmpty());
+}
+
+}  // namespace node
+}  // namespace libj
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/buffer_reader.h>
+#include <libnode/buffer_writer.h>
+
+namespace libj {
+namespace node {
+
+TEST(GTestBufferReader, TestWriteRead) {
+    Buffer::Ptr buf = Buffer::create(27);
+    BufferWriter writer(buf);
+    ASSERT_TRUE(writer.canWrite(27));
+    ASSERT_FALSE(writer.canWrite(28));
+    writer.writeUInt8(0xfe);
+    writer.writeUInt16BE(0x0102);
+    writer.writeUInt32LE(0x03040506);
+    writer.writeInt32BE(-2);
+    writer.writeDoubleBE(1.5);
+    writer.writeFloatLE(-0.25f);
+    writer.writeBytes("ab", 2);
+    ASSERT_EQ(25, writer.offset());
+    ASSERT_EQ(2, writer.remaining());
+
+    UShort us = 0;
+    ASSERT_TRUE(buf->readUInt16BE(1, &us));
+    ASSERT_EQ(0x0102, us);
+    UInt ui = 0;
+    ASSERT_TRUE(buf->readUInt32LE(3, &ui));
+    ASSERT_EQ(0x03040506, ui);
+
+    BufferReader reader(buf);
+    ASSERT_TRUE(reader.canRead(25));
+    ASSERT_EQ(0xfe, reader.readUInt8());
+    ASSERT_EQ(0x0102, reader.readUInt16BE());
+    ASSERT_EQ(0x03040506, reader.readUInt32LE());
+    ASSERT_EQ(-2, reader.readInt32BE());
+    ASSERT_EQ(1.5, reader.readDoubleBE());
+    ASSERT_EQ(-0.25f, reader.readFloatLE());
+    char ab[2];
+    reader.readBytes(ab, 2);
+    ASSERT_EQ('a', ab[0]);
+    ASSERT_EQ('b', ab[1]);
+    ASSERT_FALSE(reader.skip(3));
+    ASSERT_TRUE(reader.skip(2));
+    ASSERT_EQ(0, reader.remaining());
+    ASSERT_TRUE(reader.seek(1));
+    ASSERT_EQ(0x0201, reader.readUInt16LE());
+    ASSERT_FALSE(reader.seek(28));
+}
+
+TEST(GTestBufferReader, TestArray) {
+    const Size count = 37;
+    UInt src[count];
+    for (Size i = 0; i < count; i++) {
+        src[i] = static_cast<UInt>(i * 0x01020304);
+    }
+
+    Buffer::Ptr buf = Buffer::create(count * sizeof(UInt));
+    BufferWriter writer(buf);
+    writer.writeArray<UInt, false>(src, count);
+    ASSERT_EQ(0, writer.remaining());
+
+    for (Size i = 0; i < count; i++) {
+        UInt v = 0;
+        ASSERT_TRUE(buf->readUInt32BE(i * sizeof(UInt), &v));
+        ASSERT_EQ(src[i], v);
+    }
+
+    UInt dst[count];
+    BufferReader reader(buf);
+    reader.readArray<UInt, false>(dst, count);
+    for (Size i = 0; i < count; i++) {
+        ASSERT_EQ(src[i], dst[i]);
+    }
+}
+
+TEST(GTestBufferReader, TestNull) {
+    BufferReader reader(Buffer::null());
+    ASSERT_EQ(0, reader.remaining());
+    ASSERT_TRUE(reader.canRead(0));
+    ASSERT_FALSE(reader.canRead(1));
+}
+
+}  // namespace node
+}  // namespace libj
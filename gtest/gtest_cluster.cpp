@@ -0,0 +1,139 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include "./gtest_http_common.h"
+
+#include <libnode/cluster.h>
+#include <libnode/url.h>
+#include <libnode/detail/cluster/worker.h>
+
+namespace libj {
+namespace node {
+
+static const Size NUM_WORKERS = 2;
+static const Size NUM_REQS = 10;
+
+class GTestClusterOnExit : LIBJ_JS_FUNCTION(GTestClusterOnExit)
+ public:
+    GTestClusterOnExit() : count_(0) {}
+
+    Size count() const { return count_; }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        count_++;
+        return Status::OK;
+    }
+
+ private:
+    Size count_;
+};
+
+class GTestClusterOnResponseEnd : LIBJ_JS_FUNCTION(GTestClusterOnResponseEnd)
+ public:
+    GTestClusterOnResponseEnd() : count_(0) {}
+
+    Size count() const { return count_; }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (++count_ == NUM_REQS) {
+            JsArray::CPtr workers = cluster::workers();
+            Size len = workers->length();
+            for (Size i = 0; i < len; i++) {
+                workers->getPtr<cluster::Worker>(i)->kill();
+            }
+        }
+        return Status::OK;
+    }
+
+ private:
+    Size count_;
+};
+
+class GTestClusterOnResponse : LIBJ_JS_FUNCTION(GTestClusterOnResponse)
+ public:
+    GTestClusterOnResponse(JsFunction::Ptr onEnd) : onEnd_(onEnd) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        http::ClientResponse::Ptr res = args->getPtr<http::ClientResponse>(0);
+        res->on(http::ClientResponse::EVENT_END, onEnd_);
+        return Status::OK;
+    }
+
+ private:
+    JsFunction::Ptr onEnd_;
+};
+
+class GTestClusterOnListening : LIBJ_JS_FUNCTION(GTestClusterOnListening)
+ public:
+    GTestClusterOnListening(JsFunction::Ptr onResponse)
+        : count_(0)
+        , onResponse_(onResponse) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (++count_ < NUM_WORKERS) return Status::OK;
+
+        JsObject::Ptr options = url::parse(str("http://127.0.0.1:10000/"));
+        for (Size i = 0; i < NUM_REQS; i++) {
+            http::ClientRequest::Ptr req = http::request(options, onResponse_);
+            req->end();
+        }
+        return Status::OK;
+    }
+
+ private:
+    Size count_;
+    JsFunction::Ptr onResponse_;
+};
+
+class GTestClusterOnRequest : LIBJ_JS_FUNCTION(GTestClusterOnRequest)
+ public:
+    virtual Value operator()(JsArray::Ptr args) {
+        http::ServerResponse::Ptr res = args->getPtr<http::ServerResponse>(1);
+        res->end(String::valueOf(cluster::worker()->id()));
+        return Status::OK;
+    }
+};
+
+// runs in the processes forked by TestFork
+TEST(GTestCluster, TestWorker) {
+    if (cluster::isMaster()) return;
+
+    ASSERT_TRUE(!!cluster::worker());
+
+    http::Server::Ptr srv = http::Server::create(
+        JsFunction::Ptr(new GTestClusterOnRequest()));
+    srv->listen(10000);
+    node::run();
+}
+
+TEST(GTestCluster, TestFork) {
+    if (cluster::isWorker()) return;
+
+    ASSERT_FALSE(!!cluster::worker());
+
+    GTestClusterOnResponseEnd::Ptr onEnd(new GTestClusterOnResponseEnd());
+    JsFunction::Ptr onResponse(new GTestClusterOnResponse(onEnd));
+    JsFunction::Ptr onListening(new GTestClusterOnListening(onResponse));
+    GTestClusterOnExit::Ptr onExit(new GTestClusterOnExit());
+
+    JsArray::Ptr args = JsArray::create();
+    args->add(str("--gtest_filter=GTestCluster.TestWorker"));
+    for (Size i = 0; i < NUM_WORKERS; i++) {
+        cluster::Worker::Ptr worker = cluster::fork(args);
+        ASSERT_TRUE(!!worker);
+        worker->on(cluster::Worker::EVENT_LISTENING, onListening);
+        worker->on(cluster::Worker::EVENT_EXIT, onExit);
+    }
+    ASSERT_EQ(NUM_WORKERS, cluster::workers()->length());
+
+    node::run();
+
+    ASSERT_EQ(NUM_REQS, onEnd->count());
+    ASSERT_EQ(NUM_WORKERS, onExit->count());
+    ASSERT_EQ(0, cluster::workers()->length());
+
+    // the last exit closes the listening socket shared by the workers
+    ASSERT_EQ(0, detail::cluster::sharedHandles()->size());
+}
+
+}  // namespace node
+}  // namespace libj
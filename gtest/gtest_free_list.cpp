@@ -1,4 +1,4 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #include <gtest/gtest.h>
 #include <libnode/detail/free_list.h>
@@ -48,6 +48,28 @@ TEST(GTestFreeList, TestFreeList12) {
     delete b;
 }
 
+TEST(GTestFreeList, TestSetMax) {
+    FreeList<std::string*> sl(3);
+    ASSERT_EQ(3, sl.max());
+
+    sl.free(new std::string("a"));
+    sl.free(new std::string("b"));
+    sl.free(new std::string("c"));
+    ASSERT_EQ(3, sl.length());
+
+    sl.setMax(1);
+    ASSERT_EQ(1, sl.max());
+    ASSERT_EQ(1, sl.length());
+
+    sl.free(new std::string("d"));
+    ASSERT_EQ(1, sl.length());
+
+    std::string* c = sl.alloc();
+    ASSERT_EQ("c", *c);
+    ASSERT_TRUE(!sl.alloc());
+    delete c;
+}
+
 }  // namespace detail
 }  // namespace node
 }  // namespace libj
@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_GTEST_GTEST_HTTP_COMMON_H_
 #define LIBNODE_GTEST_GTEST_HTTP_COMMON_H_
@@ -17,12 +17,14 @@ class GTestHttpServerOnEnd : LIBJ_JS_FUNCTION(GTestHttpServerOnEnd)
         http::ServerResponse::Ptr res,
         GTestOnData::Ptr onData,
         UInt numReqs,
-        Boolean chunked = false)
+        Boolean chunked = false,
+        Boolean endWithBuffer = false)
         : srv_(srv)
         , res_(res)
         , onData_(onData)
         , numReqs_(numReqs)
-        , chunked_(chunked) {}
+        , chunked_(chunked)
+        , endWithBuffer_(endWithBuffer) {}
 
     static void clear() {
         count_ = 0;
@@ -37,8 +39,12 @@ class GTestHttpServerOnEnd : LIBJ_JS_FUNCTION(GTestHttpServerOnEnd)
                 http::HEADER_CONTENT_LENGTH,
                 String::valueOf(Buffer::byteLength(body)));
         }
-        res_->write(body);
-        res_->end();
+        if (endWithBuffer_) {
+            res_->end(Buffer::create(body));
+        } else {
+            res_->write(body);
+            res_->end();
+        }
 
         count_++;
         if (count_ >= numReqs_) srv_->close();
@@ -53,6 +59,7 @@ class GTestHttpServerOnEnd : LIBJ_JS_FUNCTION(GTestHttpServerOnEnd)
     GTestOnData::Ptr onData_;
     UInt numReqs_;
     Boolean chunked_;
+    Boolean endWithBuffer_;
 };
 
 class GTestHttpServerOnRequest : LIBJ_JS_FUNCTION(GTestHttpServerOnRequest)
@@ -60,10 +67,12 @@ class GTestHttpServerOnRequest : LIBJ_JS_FUNCTION(GTestHttpServerOnRequest)
     GTestHttpServerOnRequest(
         http::Server::Ptr srv,
         UInt numReqs,
-        Boolean chunked = false)
+        Boolean chunked = false,
+        Boolean endWithBuffer = false)
         : srv_(srv)
         , numReqs_(numReqs)
-        , chunked_(chunked) {}
+        , chunked_(chunked)
+        , endWithBuffer_(endWithBuffer) {}
 
     virtual Value operator()(JsArray::Ptr args) {
         http::ServerRequest::Ptr req = args->getPtr<http::ServerRequest>(0);
@@ -76,7 +85,7 @@ class GTestHttpServerOnRequest : LIBJ_JS_FUNCTION(GTestHttpServerOnRequest)
         GTestOnClose::Ptr onClose(new GTestOnClose());
         GTestHttpServerOnEnd::Ptr onEnd(
             new GTestHttpServerOnEnd(
-                srv_, res, onData, numReqs_, chunked_));
+                srv_, res, onData, numReqs_, chunked_, endWithBuffer_));
         req->on(http::ServerRequest::EVENT_DATA, onData);
         req->on(http::ServerRequest::EVENT_END, onEnd);
         req->on(http::ServerRequest::EVENT_CLOSE, onClose);
@@ -88,6 +97,7 @@ class GTestHttpServerOnRequest : LIBJ_JS_FUNCTION(GTestHttpServerOnRequest)
     http::Server::Ptr srv_;
     UInt numReqs_;
     Boolean chunked_;
+    Boolean endWithBuffer_;
 };
 
 class GTestHttpClientOnResponse : LIBJ_JS_FUNCTION(GTestHttpClientOnResponse)
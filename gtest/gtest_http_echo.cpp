@@ -1,7 +1,9 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include "./gtest_http_common.h"
 
+#include <libj/this.h>
+
 namespace libj {
 namespace node {
 
@@ -94,5 +96,202 @@ TEST(GTestHttpEcho, TestConnectionClose) {
     clearGTestHttpCommon();
 }
 
+TEST(GTestHttpEcho, TestEndWithBuffer) {
+    String::CPtr msg = str("abc");
+
+    for (Size i = 0; i < 2; i++) {
+        Boolean chunked = i == 1;
+        http::Server::Ptr srv = http::Server::create();
+        GTestHttpServerOnRequest::Ptr onRequest(
+            new GTestHttpServerOnRequest(srv, NUM_REQS, chunked, true));
+        srv->on(http::Server::EVENT_REQUEST, onRequest);
+        srv->listen(10000);
+
+        JsObject::Ptr options = url::parse(str("http://127.0.0.1:10000/xyz"));
+        JsObject::Ptr headers = JsObject::create();
+        headers->put(
+            http::HEADER_CONTENT_LENGTH,
+            String::valueOf(Buffer::byteLength(msg)));
+        options->put(http::OPTION_HEADERS, headers);
+
+        GTestHttpClientOnResponse::Ptr onResponse(
+            new GTestHttpClientOnResponse());
+        for (Size j = 0; j < NUM_REQS; j++) {
+            http::ClientRequest::Ptr req = http::request(options, onResponse);
+            req->write(msg);
+            req->end();
+        }
+
+        node::run();
+
+        JsArray::CPtr messages = GTestOnEnd::messages();
+        JsArray::CPtr statusCodes = GTestHttpClientOnResponse::statusCodes();
+        ASSERT_EQ(NUM_REQS, messages->length());
+        ASSERT_EQ(NUM_REQS, statusCodes->length());
+        for (Size j = 0; j < NUM_REQS; j++) {
+            ASSERT_TRUE(messages->get(j).equals(msg));
+            ASSERT_TRUE(statusCodes->get(j).equals(200));
+        }
+
+        clearGTestHttpCommon();
+    }
+}
+
+class GTestHttpServerOnRequestHeaders
+    : LIBJ_JS_FUNCTION(GTestHttpServerOnRequestHeaders)
+ public:
+    GTestHttpServerOnRequestHeaders(JsFunction::Ptr onRequest)
+        : onRequest_(onRequest)
+        , count_(0) {}
+
+    UInt count() const {
+        return count_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        http::ServerRequest::Ptr req = args->getPtr<http::ServerRequest>(0);
+        JsObject::CPtr headers = req->headers();
+        if (headers->get(http::LHEADER_CONTENT_LENGTH).equals(str("3")) &&
+            headers->get(str("x-libnode")).equals(str("abc, def"))) {
+            count_++;
+        }
+        return (*onRequest_)(args);
+    }
+
+ private:
+    JsFunction::Ptr onRequest_;
+    UInt count_;
+};
+
+TEST(GTestHttpEcho, TestLazyHeaders) {
+    String::CPtr msg = str("abc");
+
+    http::Server::Ptr srv = http::Server::create();
+    ASSERT_FALSE(srv->lazyHeaders());
+    srv->setLazyHeaders(true);
+
+    GTestHttpServerOnRequestHeaders::Ptr onRequest(
+        new GTestHttpServerOnRequestHeaders(
+            JsFunction::Ptr(new GTestHttpServerOnRequest(srv, NUM_REQS))));
+    srv->on(http::Server::EVENT_REQUEST, onRequest);
+    srv->listen(10000);
+
+    JsObject::Ptr options = url::parse(str("http://127.0.0.1:10000/xyz"));
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(
+        http::HEADER_CONTENT_LENGTH,
+        String::valueOf(Buffer::byteLength(msg)));
+    headers->put(str("X-LibNode"), str("abc, def"));
+    options->put(http::OPTION_HEADERS, headers);
+
+    GTestHttpClientOnResponse::Ptr onResponse(new GTestHttpClientOnResponse());
+    for (Size i = 0; i < NUM_REQS; i++) {
+        http::ClientRequest::Ptr req = http::request(options, onResponse);
+        req->write(msg);
+        req->end();
+    }
+
+    node::run();
+
+    ASSERT_EQ(NUM_REQS, onRequest->count());
+
+    JsArray::CPtr messages = GTestOnEnd::messages();
+    ASSERT_EQ(NUM_REQS, messages->length());
+    for (Size i = 0; i < NUM_REQS; i++) {
+        ASSERT_TRUE(messages->get(i).equals(msg));
+    }
+
+    clearGTestHttpCommon();
+}
+
+class GTestHttpAgentRequest : LIBJ_JS_FUNCTION(GTestHttpAgentRequest)
+ public:
+    GTestHttpAgentRequest(JsObject::Ptr options, UInt numReqs)
+        : options_(options)
+        , numReqs_(numReqs)
+        , count_(0) {}
+
+    UInt count() const {
+        return count_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (count_ < numReqs_) {
+            count_++;
+            JsFunction::Ptr onResponse(
+                new OnResponse(LIBJ_THIS_PTR(GTestHttpAgentRequest)));
+            http::ClientRequest::Ptr req = http::request(options_, onResponse);
+            req->end();
+        }
+        return Status::OK;
+    }
+
+ private:
+    class OnResponse : LIBJ_JS_FUNCTION(OnResponse)
+     public:
+        OnResponse(JsFunction::Ptr next) : next_(next) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            http::ClientResponse::Ptr res =
+                args->getPtr<http::ClientResponse>(0);
+            res->on(
+                http::ClientResponse::EVENT_END,
+                JsFunction::Ptr(new OnEnd(next_)));
+            return Status::OK;
+        }
+
+     private:
+        JsFunction::Ptr next_;
+    };
+
+    class OnEnd : LIBJ_JS_FUNCTION(OnEnd)
+     public:
+        OnEnd(JsFunction::Ptr next) : next_(next) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            // the socket is returned to the agent after 'end'
+            process::nextTick(next_);
+            return Status::OK;
+        }
+
+     private:
+        JsFunction::Ptr next_;
+    };
+
+    JsObject::Ptr options_;
+    UInt numReqs_;
+    UInt count_;
+};
+
+TEST(GTestHttpEcho, TestKeepAliveAgent) {
+    http::Server::Ptr srv = http::Server::create();
+    GTestHttpServerOnRequest::Ptr onRequest(
+        new GTestHttpServerOnRequest(srv, NUM_REQS));
+    srv->on(http::Server::EVENT_REQUEST, onRequest);
+    srv->listen(10000);
+
+    JsObject::Ptr agentOptions = JsObject::create();
+    agentOptions->put(str("keepAlive"), true);
+    agentOptions->put(str("freeSocketTimeout"), 100);
+    http::Agent::Ptr agent = http::Agent::create(agentOptions);
+    ASSERT_TRUE(agent->keepAlive());
+    ASSERT_EQ(100, agent->freeSocketTimeout());
+
+    JsObject::Ptr options = url::parse(str("http://127.0.0.1:10000/"));
+    options->put(http::OPTION_AGENT, agent);
+
+    GTestHttpAgentRequest::Ptr request(
+        new GTestHttpAgentRequest(options, NUM_REQS));
+    (*request)();
+
+    node::run();
+
+    ASSERT_EQ(NUM_REQS, request->count());
+    ASSERT_EQ(1, agent->freeSocketMisses());
+    ASSERT_EQ(NUM_REQS - 1, agent->freeSocketHits());
+
+    clearGTestHttpCommon();
+}
+
 }  // namespace node
 }  // namespace libj
@@ -1,4 +1,4 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #include <gtest/gtest.h>
 #include <libnode/detail/http/header_scanner.h>
@@ -51,6 +51,33 @@ TEST(GTestHttpHeaderScanner, TestScanHeaderField2) {
             ->equals(String::create("x-header-header-header-header-header")));
 }
 
+TEST(GTestHttpHeaderScanner, TestScanHeaderValue) {
+    ASSERT_TRUE(scanHeaderValue<char>(NULL, 0)->isEmpty());
+    ASSERT_TRUE(scanHeaderValue<char>("close", 0)->isEmpty());
+
+    String::CPtr keepAlive = scanHeaderValue<char>("keep-alive", 10);
+    ASSERT_TRUE(keepAlive->equals(String::create("keep-alive")));
+    ASSERT_EQ(keepAlive, scanHeaderValue<char>("keep-alive", 10));
+    ASSERT_EQ(
+        scanHeaderValue<char>("application/json", 16),
+        scanHeaderValue<char>("application/json", 16));
+
+    // the case of a value is kept
+    String::CPtr value = scanHeaderValue<char>("Keep-Alive", 10);
+    ASSERT_TRUE(value->equals(String::create("Keep-Alive")));
+    ASSERT_NE(keepAlive, value);
+
+    ASSERT_TRUE(
+        scanHeaderValue<char>("closed", 5)->equals(String::create("close")));
+    ASSERT_TRUE(
+        scanHeaderValue<char>("closed", 6)->equals(String::create("closed")));
+
+    String::CPtr field = String::create("chunked");
+    ASSERT_TRUE(
+        scanHeaderValue<Char>(field->data(), field->length())
+            ->equals(field));
+}
+
 }  // namespace http
 }  // namespace detail
 }  // namespace node
@@ -0,0 +1,179 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include "./gtest_http_common.h"
+#include "./gtest_net_common.h"
+
+#include <libnode/http/header_template.h>
+
+namespace libj {
+namespace node {
+namespace http {
+
+TEST(GTestHttpHeaderTemplate, TestCreate) {
+    ASSERT_FALSE(HeaderTemplate::create(JsObject::null()));
+
+    JsObject::Ptr headers = JsObject::create();
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+    ASSERT_TRUE(!!tmpl);
+    ASSERT_EQ(0, tmpl->toBuffer()->length());
+
+    headers->put(HEADER_CONTENT_LENGTH, 10);
+    ASSERT_FALSE(HeaderTemplate::create(headers));
+    headers->remove(HEADER_CONTENT_LENGTH);
+    headers->put(str("connection"), str("close"));
+    ASSERT_FALSE(HeaderTemplate::create(headers));
+}
+
+TEST(GTestHttpHeaderTemplate, TestToBuffer) {
+    JsArray::Ptr vary = JsArray::create();
+    vary->add(str("Origin"));
+    vary->add(str("Accept"));
+
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(HEADER_VARY, vary);
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+    ASSERT_TRUE(tmpl->toBuffer()->toString()->equals(
+        str("Vary: Origin\r\nVary: Accept\r\n")));
+
+    headers = JsObject::create();
+    headers->put(str("X-Max"), 3);
+    tmpl = HeaderTemplate::create(headers);
+    ASSERT_TRUE(tmpl->toBuffer()->toString()->equals(str("X-Max: 3\r\n")));
+}
+
+TEST(GTestHttpHeaderTemplate, TestToBufferOmitted) {
+    JsArray::Ptr vary = JsArray::create();
+    vary->add(str("Origin"));
+    vary->add(str("Accept"));
+
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(HEADER_VARY, vary);
+    headers->put(HEADER_SERVER, str("libnode"));
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+
+    JsObject::Ptr omitted = JsObject::create();
+    ASSERT_TRUE(tmpl->toBuffer(omitted)->equals(tmpl->toBuffer()));
+
+    omitted->put(str("vary"), true);
+    ASSERT_TRUE(tmpl->toBuffer(omitted)->toString()->equals(
+        str("Server: libnode\r\n")));
+
+    omitted = JsObject::create();
+    omitted->put(str("server"), true);
+    ASSERT_TRUE(tmpl->toBuffer(omitted)->toString()->equals(
+        str("Vary: Origin\r\nVary: Accept\r\n")));
+}
+
+TEST(GTestHttpHeaderTemplate, TestHas) {
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(HEADER_CONTENT_TYPE, str("text/plain"));
+    headers->put(HEADER_SERVER, str("libnode"));
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+    ASSERT_TRUE(tmpl->has(HEADER_CONTENT_TYPE));
+    ASSERT_TRUE(tmpl->has(str("server")));
+    ASSERT_FALSE(tmpl->has(HEADER_CACHE_CONTROL));
+    ASSERT_FALSE(tmpl->has(String::null()));
+}
+
+TEST(GTestHttpHeaderTemplate, TestGet) {
+    JsArray::Ptr vary = JsArray::create();
+    vary->add(str("Origin"));
+
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(HEADER_CONTENT_TYPE, str("text/plain"));
+    headers->put(str("X-Max"), 3);
+    headers->put(HEADER_VARY, vary);
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+    ASSERT_TRUE(tmpl->get(str("content-type")).equals(str("text/plain")));
+    ASSERT_TRUE(tmpl->get(str("X-Max")).equals(str("3")));
+    ASSERT_TRUE(tmpl->get(HEADER_VARY).equals(vary));
+    ASSERT_TRUE(tmpl->get(HEADER_SERVER).isUndefined());
+}
+
+class GTestHttpHeaderTemplateOnRequest
+    : LIBJ_JS_FUNCTION(GTestHttpHeaderTemplateOnRequest)
+ public:
+    GTestHttpHeaderTemplateOnRequest(
+        Server::Ptr srv,
+        HeaderTemplate::CPtr tmpl)
+        : srv_(srv)
+        , tmpl_(tmpl)
+        , server_(String::null()) {}
+
+    String::CPtr server() const {
+        return server_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        ServerResponse::Ptr res = args->getPtr<ServerResponse>(1);
+        res->setSendDate(false);
+        res->setHeaderTemplate(tmpl_);
+        res->setHeader(HEADER_CONTENT_TYPE, str("text/html"));
+        server_ = res->getHeader(HEADER_SERVER);
+        res->end(str("ok"));
+        srv_->close();
+        return Status::OK;
+    }
+
+ private:
+    Server::Ptr srv_;
+    HeaderTemplate::CPtr tmpl_;
+    String::CPtr server_;
+};
+
+class GTestHttpHeaderTemplateOnConnect
+    : LIBJ_JS_FUNCTION(GTestHttpHeaderTemplateOnConnect)
+ public:
+    GTestHttpHeaderTemplateOnConnect(net::Socket::Ptr sock) : sock_(sock) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        sock_->end(str(
+            "GET / HTTP/1.1\r\n"
+            "Connection: close\r\n"
+            "\r\n"));
+        return Status::OK;
+    }
+
+ private:
+    net::Socket::Ptr sock_;
+};
+
+TEST(GTestHttpHeaderTemplate, TestOverride) {
+    const Int port = 10000;
+
+    JsObject::Ptr headers = JsObject::create();
+    headers->put(HEADER_CONTENT_TYPE, str("application/json"));
+    headers->put(HEADER_SERVER, str("libnode"));
+    HeaderTemplate::CPtr tmpl = HeaderTemplate::create(headers);
+
+    Server::Ptr srv = Server::create();
+    GTestHttpHeaderTemplateOnRequest::Ptr onRequest(
+        new GTestHttpHeaderTemplateOnRequest(srv, tmpl));
+    srv->on(Server::EVENT_REQUEST, onRequest);
+    srv->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    GTestOnData::Ptr onData(new GTestOnData());
+    JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+    JsFunction::Ptr onConnect(new GTestHttpHeaderTemplateOnConnect(socket));
+    socket->on(net::Socket::EVENT_DATA, onData);
+    socket->on(net::Socket::EVENT_END, onEnd);
+    socket->on(net::Socket::EVENT_CONNECT, onConnect);
+
+    node::run();
+
+    ASSERT_TRUE(onRequest->server()->equals(str("libnode")));
+
+    JsArray::CPtr msgs = GTestOnEnd::messages();
+    ASSERT_EQ(1, msgs->length());
+    String::CPtr res = msgs->getCPtr<Buffer>(0)->toString();
+    ASSERT_NE(NO_POS, res->indexOf(str("Content-Type: text/html\r\n")));
+    ASSERT_NE(NO_POS, res->indexOf(str("Server: libnode\r\n")));
+    ASSERT_EQ(NO_POS, res->indexOf(str("application/json")));
+
+    clearGTestHttpCommon();
+}
+
+}  // namespace http
+}  // namespace node
+}  // namespace libj
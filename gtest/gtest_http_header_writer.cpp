@@ -0,0 +1,97 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/detail/http/header_writer.h>
+
+#include <string.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace http {
+
+TEST(GTestHttpHeaderWriter, TestStatusLine) {
+    Size len = 0;
+    const char* line = statusLine(200, &len);
+    ASSERT_EQ(17, len);
+    ASSERT_EQ(0, memcmp(line, "HTTP/1.1 200 OK\r\n", len));
+
+    line = statusLine(416, &len);
+    ASSERT_EQ(0, memcmp(
+        line, "HTTP/1.1 416 Requested Range Not Satisfiable\r\n", len));
+
+    ASSERT_FALSE(statusLine(299, &len));
+}
+
+TEST(GTestHttpHeaderWriter, TestWrite) {
+    HeaderWriter writer;
+    writer.appendStatusLine(404, String::null());
+    writer.append(str("X-Test"));
+    writer.appendLiteral(": ");
+    writer.appendValue(123);
+    writer.appendCRLF();
+    writer.appendHex(255);
+    writer.appendCRLF();
+    ASSERT_TRUE(writer.toBuffer()->toString()->equals(
+        str("HTTP/1.1 404 Not Found\r\nX-Test: 123\r\nff\r\n")));
+
+    writer.clear();
+    writer.appendStatusLine(299, String::null());
+    writer.appendStatusLine(200, str("Fine"));
+    ASSERT_TRUE(writer.toBuffer()->toString()->equals(
+        str("HTTP/1.1 299 Unknown\r\nHTTP/1.1 200 Fine\r\n")));
+}
+
+TEST(GTestHttpHeaderWriter, TestGrow) {
+    HeaderWriter writer;
+    for (Size i = 0; i < 1000; i++) {
+        writer.appendDecimal(i % 10);
+    }
+    ASSERT_EQ(1000, writer.length());
+    ASSERT_EQ('9', writer.data()[999]);
+
+    writer.clear();
+    ASSERT_EQ(0, writer.length());
+}
+
+TEST(GTestHttpHeaderWriter, TestToBuffer) {
+    HeaderWriter writer;
+    writer.appendLiteral("abc");
+    Buffer::CPtr abc = writer.toBuffer();
+    ASSERT_EQ(0, writer.length());
+
+    // the bytes handed out are not overwritten
+    writer.appendLiteral("x");
+    writer.clear();
+    writer.appendLiteral("de");
+    Buffer::CPtr de = writer.toBuffer();
+    ASSERT_TRUE(abc->toString()->equals(str("abc")));
+    ASSERT_TRUE(de->toString()->equals(str("de")));
+
+    for (Size i = 0; i < HeaderWriter::SLAB_SIZE; i++) {
+        writer.append('f');
+    }
+    ASSERT_EQ(HeaderWriter::SLAB_SIZE, writer.toBuffer()->length());
+    ASSERT_TRUE(abc->toString()->equals(str("abc")));
+}
+
+TEST(GTestHttpHeaderWriter, TestLargeString) {
+    StringBuilder::Ptr sb = StringBuilder::create();
+    for (Size i = 0; i < HeaderWriter::SLAB_SIZE; i++) {
+        sb->appendChar('g');
+    }
+    sb->appendChar(0x3042);
+    String::CPtr body = sb->toString();
+
+    // sized by the UTF-8 length, not 4 bytes per char
+    HeaderWriter writer;
+    writer.append(body);
+    ASSERT_EQ(HeaderWriter::SLAB_SIZE + 3, writer.length());
+    ASSERT_EQ(HeaderWriter::SLAB_SIZE * 2, writer.capacity());
+    ASSERT_TRUE(writer.toBuffer()->toString()->equals(body));
+}
+
+}  // namespace http
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
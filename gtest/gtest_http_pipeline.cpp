@@ -0,0 +1,148 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include "./gtest_http_common.h"
+#include "./gtest_net_common.h"
+
+namespace libj {
+namespace node {
+
+static const UInt DEPTH = 16;
+static const UInt ROUNDS = 64;
+
+// the socket writes on this loop so far
+static Size socketWrites() {
+    net::WriteStats stats = net::writeStats();
+    return stats.inlineWrites + stats.queuedWrites;
+}
+
+class GTestHttpPipelineOnRequest
+    : LIBJ_JS_FUNCTION(GTestHttpPipelineOnRequest)
+ public:
+    GTestHttpPipelineOnRequest(http::Server::Ptr srv)
+        : srv_(srv)
+        , count_(0) {}
+
+    UInt count() const {
+        return count_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        http::ServerResponse::Ptr res = args->getPtr<http::ServerResponse>(1);
+        res->setSendDate(false);
+        res->setHeader(http::HEADER_CONTENT_LENGTH, str("2"));
+        res->end(str("ok"));
+
+        if (++count_ >= DEPTH * ROUNDS) srv_->close();
+        return Status::OK;
+    }
+
+ private:
+    http::Server::Ptr srv_;
+    UInt count_;
+};
+
+// sends DEPTH requests in a single write,
+// and the next DEPTH after all the responses arrive
+class GTestHttpPipelineClient : LIBJ_JS_FUNCTION(GTestHttpPipelineClient)
+ public:
+    GTestHttpPipelineClient(net::Socket::Ptr sock)
+        : socket_(sock)
+        , requests_(String::null())
+        , received_(String::create())
+        , responses_(0)
+        , rounds_(0)
+        , writes_(0) {
+        StringBuilder::Ptr sb = StringBuilder::create();
+        for (Size i = 0; i < DEPTH; i++) {
+            sb->appendStr(str("GET /pipeline HTTP/1.1\r\n"));
+            sb->appendStr(str("Host: 127.0.0.1\r\n\r\n"));
+        }
+        requests_ = sb->toString();
+    }
+
+    UInt responses() const {
+        return responses_;
+    }
+
+    UInt writes() const {
+        return writes_;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        LIBJ_STATIC_SYMBOL_DEF(symStatusLine, "HTTP/1.1 200 OK\r\n");
+
+        String::CPtr data = args->getCPtr<String>(0);
+        if (!data) {
+            // 'connect'
+            socket_->write(requests_);
+            writes_++;
+            return Status::OK;
+        }
+
+        received_ = received_->concat(data);
+        Size n = 0;
+        Size i = 0;
+        while ((i = received_->indexOf(symStatusLine, i)) != NO_POS) {
+            n++;
+            i++;
+        }
+        if (n < DEPTH) return Status::OK;
+
+        received_ = String::create();
+        responses_ += n;
+        if (++rounds_ < ROUNDS) {
+            socket_->write(requests_);
+            writes_++;
+        } else {
+            socket_->end();
+        }
+        return Status::OK;
+    }
+
+ private:
+    net::Socket::Ptr socket_;
+    String::CPtr requests_;
+    String::CPtr received_;
+    UInt responses_;
+    UInt rounds_;
+    UInt writes_;
+};
+
+TEST(GTestHttpPipeline, TestPipelinedResponses) {
+    const Int port = 10000;
+
+    http::Server::Ptr srv = http::Server::create();
+    GTestHttpPipelineOnRequest::Ptr onRequest(
+        new GTestHttpPipelineOnRequest(srv));
+    srv->on(http::Server::EVENT_REQUEST, onRequest);
+    srv->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    socket->setEncoding(Buffer::UTF8);
+    GTestHttpPipelineClient::Ptr client(new GTestHttpPipelineClient(socket));
+    socket->on(net::Socket::EVENT_CONNECT, client);
+    socket->on(net::Socket::EVENT_DATA, client);
+
+    Size before = socketWrites();
+    node::run();
+    Size after = socketWrites();
+
+    ASSERT_EQ(DEPTH * ROUNDS, onRequest->count());
+    ASSERT_EQ(DEPTH * ROUNDS, client->responses());
+
+    // the client writes DEPTH requests at once in each round, and
+    // the server ideally writes DEPTH responses with one writev
+    Size serverWrites = after - before - client->writes();
+    Double perRequest =
+        static_cast<Double>(serverWrites) / (DEPTH * ROUNDS);
+    console::printf(
+        console::LEVEL_INFO,
+        "server writes per request: %f\n",
+        perRequest);
+    ASSERT_LT(perRequest, 0.5);
+
+    clearGTestHttpCommon();
+}
+
+}  // namespace node
+}  // namespace libj
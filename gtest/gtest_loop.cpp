@@ -0,0 +1,67 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/loop.h>
+#include <libnode/process.h>
+#include <libnode/timer.h>
+
+#include <libj/status.h>
+
+namespace libj {
+namespace node {
+
+class GTestLoopCount : LIBJ_JS_FUNCTION(GTestLoopCount)
+ public:
+    GTestLoopCount() : count_(0) {}
+
+    UInt count() const { return count_; }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        count_++;
+        return Status::OK;
+    }
+
+ private:
+    UInt count_;
+};
+
+class GTestLoopSetup : LIBJ_JS_FUNCTION(GTestLoopSetup)
+ public:
+    GTestLoopSetup(JsFunction::Ptr callback) : callback_(callback) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        process::nextTick(callback_);
+        setImmediate(callback_);
+        setTimeout(callback_, 10);
+        return Status::OK;
+    }
+
+ private:
+    JsFunction::Ptr callback_;
+};
+
+TEST(GTestLoop, TestStartAndJoin) {
+    const Size NUM_LOOPS = 4;
+
+    JsArray::Ptr counts = JsArray::create();
+    JsArray::Ptr loops = JsArray::create();
+    for (Size i = 0; i < NUM_LOOPS; i++) {
+        GTestLoopCount::Ptr count(new GTestLoopCount());
+        Loop::Ptr loop = Loop::create();
+        ASSERT_TRUE(loop->start(
+            JsFunction::Ptr(new GTestLoopSetup(count))));
+        ASSERT_FALSE(loop->start(JsFunction::null()));
+        counts->add(count);
+        loops->add(loop);
+    }
+
+    for (Size i = 0; i < NUM_LOOPS; i++) {
+        Loop::Ptr loop = loops->getPtr<Loop>(i);
+        ASSERT_TRUE(loop->join());
+        ASSERT_FALSE(loop->join());
+        ASSERT_EQ(3, counts->getPtr<GTestLoopCount>(i)->count());
+    }
+}
+
+}  // namespace node
+}  // namespace libj
@@ -0,0 +1,94 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/monitor.h>
+#include <libnode/node.h>
+#include <libnode/timer.h>
+#include <libnode/detail/histogram.h>
+
+#include <libj/status.h>
+
+namespace libj {
+namespace node {
+
+TEST(GTestMonitor, TestHistogram) {
+    detail::Histogram hist;
+    ASSERT_EQ(0, hist.count());
+    ASSERT_EQ(0, hist.percentile(50));
+
+    for (ULong i = 1; i <= 100000; i++) {
+        hist.record(i);
+    }
+    ASSERT_EQ(100000, hist.count());
+    ASSERT_EQ(1, hist.min());
+    ASSERT_EQ(100000, hist.max());
+    ASSERT_DOUBLE_EQ(50000.5, hist.mean());
+    ASSERT_EQ(100000, hist.percentile(100));
+
+    // within the precision of the buckets
+    ULong p50 = hist.percentile(50);
+    ULong p99 = hist.percentile(99);
+    ASSERT_TRUE(p50 >= 50000 && p50 <= 50000 + 50000 / 64);
+    ASSERT_TRUE(p99 >= 99000 && p99 <= 99000 + 99000 / 64);
+
+    hist.reset();
+    ASSERT_EQ(0, hist.count());
+    ASSERT_EQ(0, hist.max());
+}
+
+class GTestMonitorOnInterval : LIBJ_JS_FUNCTION(GTestMonitorOnInterval)
+ public:
+    GTestMonitorOnInterval() : count_(0), id_(UNDEFINED) {}
+
+    void setId(const Value& id) {
+        id_ = id;
+    }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (++count_ == 5) clearInterval(id_);
+        return Status::OK;
+    }
+
+ private:
+    Size count_;
+    Value id_;
+};
+
+TEST(GTestMonitor, TestStats) {
+    ASSERT_TRUE(monitor::start());
+    ASSERT_FALSE(monitor::start());
+    ASSERT_TRUE(monitor::isActive());
+
+    GTestMonitorOnInterval::Ptr onInterval(new GTestMonitorOnInterval());
+    onInterval->setId(setInterval(onInterval, 10));
+
+    node::run();
+
+    JsObject::Ptr stats = monitor::stats();
+    ASSERT_TRUE(!!stats);
+
+    JsObject::Ptr drift = stats->getPtr<JsObject>(str("timerDrift"));
+    ASSERT_EQ(5, to<ULong>(drift->get(str("count"))));
+
+    JsObject::Ptr iteration = stats->getPtr<JsObject>(str("iterationTime"));
+    ASSERT_LT(0, to<ULong>(iteration->get(str("count"))));
+
+    // the loop is blocked waiting for the timer most of the time
+    JsObject::Ptr poll = stats->getPtr<JsObject>(str("pollTime"));
+    ASSERT_LT(1000, to<ULong>(poll->get(str("max"))));
+
+    JsObject::Ptr callbacks = stats->getPtr<JsObject>(str("callbacks"));
+    ASSERT_LT(0, to<ULong>(callbacks->get(str("max"))));
+
+    monitor::reset();
+    stats = monitor::stats();
+    drift = stats->getPtr<JsObject>(str("timerDrift"));
+    ASSERT_EQ(0, to<ULong>(drift->get(str("count"))));
+
+    ASSERT_TRUE(monitor::stop());
+    ASSERT_FALSE(monitor::stop());
+    ASSERT_FALSE(monitor::isActive());
+}
+
+}  // namespace node
+}  // namespace libj
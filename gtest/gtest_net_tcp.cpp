@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include "./gtest_net_common.h"
 
@@ -49,5 +49,289 @@ TEST(GTestNetTcp, TestTcp) {
     clearGTestCommon();
 }
 
+class GTestNetSocketOnConnectWritev
+    : LIBJ_JS_FUNCTION(GTestNetSocketOnConnectWritev)
+ public:
+    GTestNetSocketOnConnectWritev(net::Socket::Ptr sock) : sock_(sock) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        JsArray::Ptr chunks = JsArray::create();
+        chunks->push(str("b"));
+        chunks->push(Buffer::create(str("c")));
+
+        sock_->cork();
+        sock_->write(str("a"));
+        sock_->writev(chunks);
+        sock_->uncork();
+        sock_->end(str("d"));
+        return Status::OK;
+    }
+
+ private:
+    net::Socket::Ptr sock_;
+};
+
+TEST(GTestNetTcp, TestWritev) {
+    net::WriteStats stats = net::writeStats();
+
+    Int port = 10000;
+    net::Server::Ptr server = net::createServer();
+    server->on(
+        net::Server::EVENT_CONNECTION,
+        JsFunction::Ptr(new GTestNetServerOnConnection(server, 1)));
+    server->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    ASSERT_TRUE(socket->writev(JsArray::create()));
+    ASSERT_EQ(0, socket->bufferSize());
+
+    GTestOnData::Ptr onData(new GTestOnData());
+    JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+    JsFunction::Ptr onClose(new GTestOnClose());
+    JsFunction::Ptr onConnect(new GTestNetSocketOnConnectWritev(socket));
+    socket->on(net::Socket::EVENT_DATA, onData);
+    socket->on(net::Socket::EVENT_END, onEnd);
+    socket->on(net::Socket::EVENT_CLOSE, onClose);
+    socket->on(net::Socket::EVENT_CONNECT, onConnect);
+
+    node::run();
+
+    ASSERT_EQ(1, GTestOnClose::count());
+
+    JsArray::CPtr messages = GTestOnEnd::messages();
+    ASSERT_EQ(1, messages->length());
+    String::CPtr msg = messages->getCPtr<Buffer>(0)->toString();
+    ASSERT_TRUE(msg->equals(str("abcd")));
+
+    net::WriteStats now = net::writeStats();
+    Size writes =
+        now.inlineWrites - stats.inlineWrites +
+        now.queuedWrites - stats.queuedWrites;
+    Size bytes = now.inlineBytes - stats.inlineBytes +
+        now.queuedBytes - stats.queuedBytes;
+    ASSERT_LE(3, writes);
+    ASSERT_LE(8, bytes);
+
+    clearGTestCommon();
+}
+
+class GTestNetSocketOnDrain : LIBJ_JS_FUNCTION(GTestNetSocketOnDrain)
+ public:
+    GTestNetSocketOnDrain(net::Socket::Ptr sock)
+        : sock_(sock)
+        , count_(0) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        count_++;
+        sock_->end();
+        return Status::OK;
+    }
+
+    Size count() const { return count_; }
+
+ private:
+    net::Socket::Ptr sock_;
+    Size count_;
+};
+
+TEST(GTestNetTcp, TestHighWaterMark) {
+    Int port = 10000;
+    net::Server::Ptr server = net::createServer();
+    server->on(
+        net::Server::EVENT_CONNECTION,
+        JsFunction::Ptr(new GTestNetServerOnConnection(server, 1)));
+    server->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    ASSERT_EQ(16 * 1024, socket->highWaterMark());
+    socket->setHighWaterMark(2);
+
+    GTestOnData::Ptr onData(new GTestOnData());
+    JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+    JsFunction::Ptr onClose(new GTestOnClose());
+    GTestNetSocketOnDrain::Ptr onDrain(new GTestNetSocketOnDrain(socket));
+    socket->on(net::Socket::EVENT_DATA, onData);
+    socket->on(net::Socket::EVENT_END, onEnd);
+    socket->on(net::Socket::EVENT_CLOSE, onClose);
+    socket->on(net::Socket::EVENT_DRAIN, onDrain);
+
+    // queued until connected
+    ASSERT_FALSE(socket->write(str("abc")));
+    ASSERT_EQ(3, socket->bufferSize());
+
+    node::run();
+
+    ASSERT_EQ(1, onDrain->count());
+    ASSERT_EQ(1, GTestOnClose::count());
+
+    JsArray::CPtr messages = GTestOnEnd::messages();
+    ASSERT_EQ(1, messages->length());
+    String::CPtr msg = messages->getCPtr<Buffer>(0)->toString();
+    ASSERT_TRUE(msg->equals(str("abc")));
+
+    clearGTestCommon();
+}
+
+TEST(GTestNetTcp, TestZeroHighWaterMark) {
+    Int port = 10000;
+    net::Server::Ptr server = net::createServer();
+    server->on(
+        net::Server::EVENT_CONNECTION,
+        JsFunction::Ptr(new GTestNetServerOnConnection(server, 1)));
+    server->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    socket->setHighWaterMark(0);
+    ASSERT_EQ(0, socket->highWaterMark());
+
+    GTestOnData::Ptr onData(new GTestOnData());
+    JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+    JsFunction::Ptr onClose(new GTestOnClose());
+    GTestNetSocketOnDrain::Ptr onDrain(new GTestNetSocketOnDrain(socket));
+    socket->on(net::Socket::EVENT_DATA, onData);
+    socket->on(net::Socket::EVENT_END, onEnd);
+    socket->on(net::Socket::EVENT_CLOSE, onClose);
+    socket->on(net::Socket::EVENT_DRAIN, onDrain);
+
+    // every write asks for a drain, which comes once the buffer is empty
+    ASSERT_FALSE(socket->write(str("abc")));
+
+    node::run();
+
+    ASSERT_EQ(1, onDrain->count());
+    ASSERT_EQ(1, GTestOnClose::count());
+
+    JsArray::CPtr messages = GTestOnEnd::messages();
+    ASSERT_EQ(1, messages->length());
+    String::CPtr msg = messages->getCPtr<Buffer>(0)->toString();
+    ASSERT_TRUE(msg->equals(str("abc")));
+
+    clearGTestCommon();
+}
+
+class GTestNetServerOnConnectionPipe
+    : LIBJ_JS_FUNCTION(GTestNetServerOnConnectionPipe)
+ public:
+    GTestNetServerOnConnectionPipe(net::Server::Ptr srv) : srv_(srv) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        net::Socket::Ptr sock = args->getPtr<net::Socket>(0);
+        sock->pipe(sock);
+        srv_->close();
+        return Status::OK;
+    }
+
+ private:
+    net::Server::Ptr srv_;
+};
+
+TEST(GTestNetTcp, TestPipe) {
+    Int port = 10000;
+    net::Server::Ptr server = net::createServer();
+    server->on(
+        net::Server::EVENT_CONNECTION,
+        JsFunction::Ptr(new GTestNetServerOnConnectionPipe(server)));
+    server->listen(port);
+
+    net::Socket::Ptr socket = net::createConnection(port);
+    GTestOnData::Ptr onData(new GTestOnData());
+    JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+    JsFunction::Ptr onClose(new GTestOnClose());
+    JsFunction::Ptr onConnect(new GTestNetSocketOnConnect(socket));
+    socket->on(net::Socket::EVENT_DATA, onData);
+    socket->on(net::Socket::EVENT_END, onEnd);
+    socket->on(net::Socket::EVENT_CLOSE, onClose);
+    socket->on(net::Socket::EVENT_CONNECT, onConnect);
+
+    node::run();
+
+    ASSERT_EQ(1, GTestOnClose::count());
+
+    JsArray::CPtr messages = GTestOnEnd::messages();
+    ASSERT_EQ(1, messages->length());
+    String::CPtr msg = messages->getCPtr<Buffer>(0)->toString();
+    ASSERT_TRUE(msg->equals(str("abc")));
+
+    clearGTestCommon();
+}
+
+class GTestNetServerOnCloseMax : LIBJ_JS_FUNCTION(GTestNetServerOnCloseMax)
+ public:
+    GTestNetServerOnCloseMax(net::Server::Ptr srv, Size numConns)
+        : srv_(srv)
+        , numConns_(numConns)
+        , count_(0) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (++count_ == numConns_) srv_->close();
+        return Status::OK;
+    }
+
+ private:
+    net::Server::Ptr srv_;
+    Size numConns_;
+    Size count_;
+};
+
+class GTestNetServerOnConnectionMax
+    : LIBJ_JS_FUNCTION(GTestNetServerOnConnectionMax)
+ public:
+    GTestNetServerOnConnectionMax(net::Server::Ptr srv, Size numConns)
+        : srv_(srv)
+        , onClose_(new GTestNetServerOnCloseMax(srv, numConns))
+        , maxConns_(0) {}
+
+    Size maxConnections() const { return maxConns_; }
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (maxConns_ < srv_->connections()) {
+            maxConns_ = srv_->connections();
+        }
+
+        net::Socket::Ptr sock = args->getPtr<net::Socket>(0);
+        sock->on(net::Socket::EVENT_CLOSE, onClose_);
+        sock->pipe(sock);
+        return Status::OK;
+    }
+
+ private:
+    net::Server::Ptr srv_;
+    JsFunction::Ptr onClose_;
+    Size maxConns_;
+};
+
+TEST(GTestNetTcp, TestMaxConnections) {
+    Int port = 10000;
+    net::Server::Ptr server = net::createServer();
+    server->setMaxConnections(2);
+    server->setAcceptBatch(1);
+    GTestNetServerOnConnectionMax::Ptr onConnection(
+        new GTestNetServerOnConnectionMax(server, NUM_CONNS));
+    server->on(net::Server::EVENT_CONNECTION, onConnection);
+    server->listen(port);
+
+    for (Size i = 0; i < NUM_CONNS; i++) {
+        net::Socket::Ptr socket = net::createConnection(port);
+        GTestOnData::Ptr onData(new GTestOnData());
+        JsFunction::Ptr onEnd(new GTestOnEnd(onData));
+        JsFunction::Ptr onClose(new GTestOnClose());
+        JsFunction::Ptr onConnect(new GTestNetSocketOnConnect(socket));
+        socket->on(net::Socket::EVENT_DATA, onData);
+        socket->on(net::Socket::EVENT_END, onEnd);
+        socket->on(net::Socket::EVENT_CLOSE, onClose);
+        socket->on(net::Socket::EVENT_CONNECT, onConnect);
+    }
+
+    node::run();
+
+    // the connections over the limit wait in the backlog
+    ASSERT_EQ(NUM_CONNS, GTestOnClose::count());
+    ASSERT_EQ(NUM_CONNS, GTestOnEnd::messages()->length());
+    ASSERT_EQ(NUM_CONNS, server->accepted());
+    ASSERT_GE(2, onConnection->maxConnections());
+
+    clearGTestCommon();
+}
+
 }  // namespace node
 }  // namespace libj
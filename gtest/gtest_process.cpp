@@ -1,11 +1,15 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <gtest/gtest.h>
 #include <libnode/node.h>
 #include <libnode/process.h>
+#include <libnode/timer.h>
 
+#include <libj/console.h>
 #include <libj/status.h>
 
+#include <uv.h>
+
 namespace libj {
 namespace node {
 
@@ -57,5 +61,63 @@ TEST(GTestProcess, TestNextTick) {
     ASSERT_TRUE(a->toString()->equals(str("1,3,2")));
 }
 
+class GTestProcessChainedTick : LIBJ_JS_FUNCTION(GTestProcessChainedTick)
+ public:
+    GTestProcessChainedTick(Size max) : count_(0), max_(max) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        if (++count_ < max_) {
+            process::nextTick(LIBJ_THIS_PTR(GTestProcessChainedTick));
+        }
+        return Status::OK;
+    }
+
+    Size count() const { return count_; }
+
+ private:
+    Size count_;
+    Size max_;
+};
+
+TEST(GTestProcess, TestChainedNextTick) {
+    const Size max = 100000;
+    GTestProcessChainedTick::Ptr tick(new GTestProcessChainedTick(max));
+    uint64_t start = uv_hrtime();
+    process::nextTick(tick);
+    node::run();
+    uint64_t elapsed = uv_hrtime() - start;
+    console::printf(
+        console::LEVEL_INFO,
+        "nextTick: %d ticks %d ns/tick\n",
+        static_cast<Int>(max),
+        static_cast<Int>(elapsed / max));
+    ASSERT_EQ(max, tick->count());
+}
+
+class GTestProcessImmediate : LIBJ_JS_FUNCTION(GTestProcessImmediate)
+ public:
+    GTestProcessImmediate(JsArray::Ptr a) : a_(a) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        a_->push(4);
+        process::nextTick(JsFunction::Ptr(new GTestProcessNextTick1(a_)));
+        return Status::OK;
+    }
+
+ private:
+    JsArray::Ptr a_;
+};
+
+TEST(GTestProcess, TestNextTickBeforeImmediate) {
+    JsArray::Ptr a = JsArray::create();
+    setImmediate(JsFunction::Ptr(new GTestProcessImmediate(a)));
+    Value id = setImmediate(JsFunction::Ptr(new GTestProcessImmediate(a)));
+    process::nextTick(JsFunction::Ptr(new GTestProcessNextTick3(a)));
+    ASSERT_TRUE(clearImmediate(id));
+    ASSERT_FALSE(clearImmediate(id));
+    node::run();
+    ASSERT_TRUE(a->toString()->equals(str("3,2,4,1")));
+}
+
 }  // namespace node
 }  // namespace libj
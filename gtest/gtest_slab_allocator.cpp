@@ -0,0 +1,63 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/detail/uv/slab_allocator.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace uv {
+
+TEST(GTestSlabAllocator, TestShrink) {
+    SlabAllocator allocator(1024);
+    Buffer::Ptr slab1 = Buffer::null();
+    Buffer::Ptr slab2 = Buffer::null();
+    Size offset1;
+    Size offset2;
+
+    char* p1 = allocator.allocate(512, &slab1, &offset1);
+    ASSERT_EQ(0, offset1);
+    ASSERT_EQ(1, allocator.numSlabs());
+    ASSERT_EQ(512, allocator.slabOffset());
+
+    p1[0] = 'a';
+    Buffer::Ptr buf1 = allocator.shrink(slab1, offset1, 512, 100);
+    ASSERT_EQ(100, buf1->length());
+    ASSERT_EQ(100, allocator.slabOffset());
+    ASSERT_EQ(412, allocator.bytesReturned());
+
+    UByte b;
+    ASSERT_TRUE(buf1->readUInt8(0, &b));
+    ASSERT_EQ('a', b);
+
+    char* p2 = allocator.allocate(512, &slab2, &offset2);
+    ASSERT_EQ(100, offset2);
+    ASSERT_EQ(p1 + 100, p2);
+    ASSERT_EQ(1, allocator.numSlabs());
+    ASSERT_TRUE(!allocator.shrink(slab2, offset2, 512, 0));
+    ASSERT_EQ(100, allocator.slabOffset());
+}
+
+TEST(GTestSlabAllocator, TestNewSlab) {
+    SlabAllocator allocator(1024);
+    Buffer::Ptr slab1 = Buffer::null();
+    Buffer::Ptr slab2 = Buffer::null();
+    Buffer::Ptr slab3 = Buffer::null();
+    Size offset;
+
+    allocator.allocate(1000, &slab1, &offset);
+    allocator.allocate(100, &slab2, &offset);
+    ASSERT_EQ(0, offset);
+    ASSERT_EQ(2, allocator.numSlabs());
+    ASSERT_TRUE(slab1 != slab2);
+
+    allocator.allocate(2048, &slab3, &offset);
+    ASSERT_EQ(2048, slab3->length());
+    ASSERT_EQ(2, allocator.numSlabs());
+    ASSERT_EQ(3, allocator.numAllocs());
+}
+
+}  // namespace uv
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
@@ -0,0 +1,87 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <gtest/gtest.h>
+#include <libnode/node.h>
+#include <libnode/timer.h>
+#include <libnode/detail/timer_list.h>
+
+#include <libj/status.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+class GTestTimerListOnTimeout : LIBJ_JS_FUNCTION(GTestTimerListOnTimeout)
+ public:
+    GTestTimerListOnTimeout(
+        JsArray::Ptr a,
+        Int id)
+        : a_(a)
+        , id_(id) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        a_->push(id_);
+        return Status::OK;
+    }
+
+ private:
+    JsArray::Ptr a_;
+    Int id_;
+};
+
+class GTestTimerListActive : LIBJ_JS_FUNCTION(GTestTimerListActive)
+ public:
+    GTestTimerListActive(TimerItem* item) : item_(item) {}
+
+    virtual Value operator()(JsArray::Ptr args) {
+        timerLists()->active(item_);
+        return Status::OK;
+    }
+
+ private:
+    TimerItem* item_;
+};
+
+TEST(GTestTimerList, TestActive) {
+    JsArray::Ptr a = JsArray::create();
+    TimerItem item1;
+    TimerItem item2;
+    item1.setOnTimeout(
+        JsFunction::Ptr(new GTestTimerListOnTimeout(a, 1)));
+    item2.setOnTimeout(
+        JsFunction::Ptr(new GTestTimerListOnTimeout(a, 2)));
+
+    timerLists()->enroll(&item1, 100);
+    timerLists()->enroll(&item2, 100);
+    ASSERT_TRUE(item1.enrolled());
+    ASSERT_EQ(100, item2.timeout());
+
+    setTimeout(JsFunction::Ptr(new GTestTimerListActive(&item1)), 50);
+    node::run();
+
+    ASSERT_FALSE(item1.enrolled());
+    ASSERT_FALSE(item2.enrolled());
+    ASSERT_TRUE(a->toString()->equals(str("2,1")));
+}
+
+TEST(GTestTimerList, TestUnenroll) {
+    JsArray::Ptr a = JsArray::create();
+    TimerItem item1;
+    TimerItem item2;
+    item1.setOnTimeout(
+        JsFunction::Ptr(new GTestTimerListOnTimeout(a, 1)));
+    item2.setOnTimeout(
+        JsFunction::Ptr(new GTestTimerListOnTimeout(a, 2)));
+
+    timerLists()->enroll(&item1, 50);
+    timerLists()->enroll(&item2, 100);
+    timerLists()->unenroll(&item1);
+    ASSERT_FALSE(item1.enrolled());
+
+    node::run();
+    ASSERT_TRUE(a->toString()->equals(str("2")));
+}
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
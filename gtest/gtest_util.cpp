@@ -1,7 +1,10 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <gtest/gtest.h>
 #include <libnode/util.h>
+#include <libnode/detail/util/codec.h>
+
+#include <string.h>
 
 namespace libj {
 namespace node {
@@ -70,6 +73,46 @@ TEST(GTestUtil, TestBase64Decode) {
     ASSERT_TRUE(!decoded);
 }
 
+TEST(GTestUtil, TestCodecIsa) {
+    namespace codec = detail::util;
+
+    Buffer::Ptr buf = Buffer::create(1000);
+    for (Size i = 0; i < buf->length(); i++) {
+        buf->writeUInt8(static_cast<UByte>(i * 37 + 11), i);
+    }
+
+    codec::setIsa(codec::ISA_SCALAR);
+    String::CPtr hex = util::hexEncode(buf);
+    String::CPtr b64 = util::base64Encode(buf);
+
+    for (Int isa = codec::detectedIsa(); isa >= 0; isa--) {
+        ASSERT_EQ(isa, codec::setIsa(static_cast<codec::Isa>(isa)));
+        ASSERT_TRUE(util::hexEncode(buf)->equals(hex));
+        ASSERT_TRUE(util::base64Encode(buf)->equals(b64));
+        Buffer::Ptr decoded = util::hexDecode(hex);
+        ASSERT_EQ(0, memcmp(buf->data(), decoded->data(), buf->length()));
+        decoded = util::base64Decode(b64);
+        ASSERT_EQ(0, memcmp(buf->data(), decoded->data(), buf->length()));
+
+        // a bad char inside the vector blocks, then one in the scalar tail
+        Size offsets[] = { 0, 40, 600 };
+        for (Size i = 0; i < sizeof(offsets) / sizeof(Size); i++) {
+            Size off = offsets[i];
+            String::CPtr bad = hex->substring(0, off)
+                ->concat(str("g"))->concat(hex->substring(off + 1));
+            ASSERT_FALSE(util::hexDecode(bad));
+            bad = b64->substring(0, off)
+                ->concat(str("*"))->concat(b64->substring(off + 1));
+            ASSERT_FALSE(util::base64Decode(bad));
+        }
+        String::CPtr bad = hex->substring(0, 600)->concat(str("0g"));
+        ASSERT_FALSE(util::hexDecode(bad));
+        bad = b64->substring(0, 600)->concat(str("A*AA"));
+        ASSERT_FALSE(util::base64Decode(bad));
+    }
+    codec::setIsa(codec::detectedIsa());
+}
+
 TEST(GTestUtil, TestPercentEncode) {
     String::CPtr encoded = util::percentEncode(str());
     ASSERT_TRUE(encoded && encoded->isEmpty());
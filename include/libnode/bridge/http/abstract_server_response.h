@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_BRIDGE_HTTP_ABSTRACT_SERVER_RESPONSE_H_
 #define LIBNODE_BRIDGE_HTTP_ABSTRACT_SERVER_RESPONSE_H_
@@ -45,6 +45,10 @@ class AbstractServerResponse : public stream::AbstractWritable<I> {
         response_->removeHeader(name);
     }
 
+    virtual void setHeaderTemplate(node::http::HeaderTemplate::CPtr tmpl) {
+        response_->setHeaderTemplate(tmpl);
+    }
+
     virtual void addTrailers(JsObject::CPtr headers) {
         response_->addTrailers(headers);
     }
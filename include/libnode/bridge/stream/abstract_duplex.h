@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_BRIDGE_STREAM_ABSTRACT_DUPLEX_H_
 #define LIBNODE_BRIDGE_STREAM_ABSTRACT_DUPLEX_H_
@@ -35,6 +35,17 @@ class AbstractDuplex : public AbstractStream<I> {
         return stream_->resume();
     }
 
+    virtual Boolean pipe(
+        node::stream::Stream::Ptr dest,
+        JsObject::CPtr options = JsObject::null()) {
+        return stream_->pipe(dest, options);
+    }
+
+    virtual Boolean unpipe(
+        node::stream::Stream::CPtr dest = node::stream::Stream::null()) {
+        return stream_->unpipe(dest);
+    }
+
     // WritableStream
     virtual Boolean writable() const {
         return stream_->writable();
@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_BUFFER_H_
 #define LIBNODE_BUFFER_H_
@@ -32,6 +32,17 @@ class Buffer : LIBJ_MUTABLE(Buffer)
 
     static Ptr create(StringBuilder::CPtr sb, Encoding enc = UTF8);
 
+    typedef void (*Deleter)(void* data);
+
+    // wraps data without copying.
+    // deleter is called once the buffer and all its slices are gone.
+    static Ptr createExternal(
+        void* data, Size length, Deleter deleter = NULL);
+
+    // maps the file privately, so the writes are not seen in the file
+    static Ptr createMapped(
+        String::CPtr path, Size offset = 0, Size length = NO_SIZE);
+
     static Boolean isBuffer(const Value& val);
 
     static Size byteLength(String::CPtr str, Encoding enc = UTF8);
@@ -59,6 +70,28 @@ class Buffer : LIBJ_MUTABLE(Buffer)
         Size sourceStart = 0,
         Size sourceEnd = NO_POS) const = 0;
 
+    // value is a Buffer, a String in enc or a byte
+    virtual Size indexOf(
+        const Value& value,
+        Size byteOffset = 0,
+        Encoding enc = UTF8) const = 0;
+
+    virtual Boolean includes(
+        const Value& value,
+        Size byteOffset = 0,
+        Encoding enc = UTF8) const = 0;
+
+    virtual Boolean equals(CPtr other) const = 0;
+
+    // returns -1, 0 or 1 in the byte order
+    virtual Int compare(CPtr other) const = 0;
+
+    virtual Boolean fill(
+        const Value& value,
+        Size offset = 0,
+        Size end = NO_POS,
+        Encoding enc = UTF8) = 0;
+
     virtual Size length() const = 0;
 
     virtual const void* data() const = 0;
@@ -0,0 +1,53 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_BUFFER_LIST_H_
+#define LIBNODE_BUFFER_LIST_H_
+
+#include <libnode/buffer.h>
+
+namespace libj {
+namespace node {
+
+// a rope of buffers, appended and consumed without copying
+class BufferList : LIBJ_MUTABLE(BufferList)
+ public:
+    static Ptr create();
+
+    virtual Size length() const = 0;
+
+    virtual Boolean isEmpty() const = 0;
+
+    virtual Size numBuffers() const = 0;
+
+    virtual Boolean append(Buffer::CPtr buf) = 0;
+
+    virtual Boolean prepend(Buffer::CPtr buf) = 0;
+
+    virtual Buffer::CPtr shift() = 0;
+
+    // drops up to n bytes from the front, and returns the number dropped
+    virtual Size consume(Size n) = 0;
+
+    virtual Size indexOf(Buffer::CPtr pattern, Size from = 0) const = 0;
+
+    virtual Size indexOf(
+        String::CPtr pattern,
+        Size from = 0,
+        Buffer::Encoding enc = Buffer::UTF8) const = 0;
+
+    virtual Size copy(
+        Buffer::Ptr target,
+        Size targetStart = 0,
+        Size sourceStart = 0,
+        Size sourceEnd = NO_POS) const = 0;
+
+    // the bytes in one buffer, allocated at most once
+    virtual Buffer::CPtr flatten() const = 0;
+
+    virtual void clear() = 0;
+};
+
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_BUFFER_LIST_H_
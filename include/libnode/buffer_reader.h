@@ -0,0 +1,146 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_BUFFER_READER_H_
+#define LIBNODE_BUFFER_READER_H_
+
+#include <libnode/buffer.h>
+#include <libnode/detail/util/byte_order.h>
+
+#include <assert.h>
+
+namespace libj {
+namespace node {
+
+// a cursor reading a buffer without virtual calls.
+// the reads are unchecked, so check a whole frame with canRead first.
+class BufferReader {
+ public:
+    BufferReader(Buffer::CPtr buf)
+        : buffer_(buf)
+        , data_(buf ? static_cast<const UByte*>(buf->data()) : NULL)
+        , length_(buf ? buf->length() : 0)
+        , offset_(0) {}
+
+    Buffer::CPtr buffer() const {
+        return buffer_;
+    }
+
+    Size offset() const {
+        return offset_;
+    }
+
+    Size remaining() const {
+        return length_ - offset_;
+    }
+
+    Boolean canRead(Size n) const {
+        return n <= length_ - offset_;
+    }
+
+    Boolean seek(Size offset) {
+        if (offset > length_) return false;
+
+        offset_ = offset;
+        return true;
+    }
+
+    Boolean skip(Size n) {
+        if (!canRead(n)) return false;
+
+        offset_ += n;
+        return true;
+    }
+
+    const UByte* current() const {
+        return data_ + offset_;
+    }
+
+    template<typename T, Boolean LittleEndian>
+    T read() {
+        assert(canRead(sizeof(T)));
+        T v = detail::util::load<T, LittleEndian>(data_ + offset_);
+        offset_ += sizeof(T);
+        return v;
+    }
+
+    template<typename T, Boolean LittleEndian>
+    void readArray(T* dst, Size count) {
+        assert(canRead(count * sizeof(T)));
+        detail::util::loadArray<T, LittleEndian>(dst, data_ + offset_, count);
+        offset_ += count * sizeof(T);
+    }
+
+    void readBytes(void* dst, Size n) {
+        assert(canRead(n));
+        memcpy(dst, data_ + offset_, n);
+        offset_ += n;
+    }
+
+    UByte readUInt8() {
+        assert(canRead(1));
+        return data_[offset_++];
+    }
+
+    Byte readInt8() {
+        return static_cast<Byte>(readUInt8());
+    }
+
+    UShort readUInt16LE() {
+        return read<UShort, true>();
+    }
+
+    UShort readUInt16BE() {
+        return read<UShort, false>();
+    }
+
+    UInt readUInt32LE() {
+        return read<UInt, true>();
+    }
+
+    UInt readUInt32BE() {
+        return read<UInt, false>();
+    }
+
+    Short readInt16LE() {
+        return read<Short, true>();
+    }
+
+    Short readInt16BE() {
+        return read<Short, false>();
+    }
+
+    Int readInt32LE() {
+        return read<Int, true>();
+    }
+
+    Int readInt32BE() {
+        return read<Int, false>();
+    }
+
+    Float readFloatLE() {
+        return read<Float, true>();
+    }
+
+    Float readFloatBE() {
+        return read<Float, false>();
+    }
+
+    Double readDoubleLE() {
+        return read<Double, true>();
+    }
+
+    Double readDoubleBE() {
+        return read<Double, false>();
+    }
+
+ private:
+    Buffer::CPtr buffer_;
+    const UByte* data_;
+    Size length_;
+    Size offset_;
+};
+
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_BUFFER_READER_H_
@@ -0,0 +1,148 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_BUFFER_WRITER_H_
+#define LIBNODE_BUFFER_WRITER_H_
+
+#include <libnode/buffer.h>
+#include <libnode/detail/util/byte_order.h>
+
+#include <assert.h>
+
+namespace libj {
+namespace node {
+
+// a cursor writing a buffer without virtual calls.
+// the writes are unchecked, so check a whole frame with canWrite first.
+class BufferWriter {
+ public:
+    BufferWriter(Buffer::Ptr buf)
+        : buffer_(buf)
+        , data_(buf
+            ? static_cast<UByte*>(const_cast<void*>(buf->data()))
+            : NULL)
+        , length_(buf ? buf->length() : 0)
+        , offset_(0) {}
+
+    Buffer::Ptr buffer() const {
+        return buffer_;
+    }
+
+    Size offset() const {
+        return offset_;
+    }
+
+    Size remaining() const {
+        return length_ - offset_;
+    }
+
+    Boolean canWrite(Size n) const {
+        return n <= length_ - offset_;
+    }
+
+    Boolean seek(Size offset) {
+        if (offset > length_) return false;
+
+        offset_ = offset;
+        return true;
+    }
+
+    Boolean skip(Size n) {
+        if (!canWrite(n)) return false;
+
+        offset_ += n;
+        return true;
+    }
+
+    UByte* current() const {
+        return data_ + offset_;
+    }
+
+    template<typename T, Boolean LittleEndian>
+    void write(T value) {
+        assert(canWrite(sizeof(T)));
+        detail::util::store<T, LittleEndian>(data_ + offset_, value);
+        offset_ += sizeof(T);
+    }
+
+    template<typename T, Boolean LittleEndian>
+    void writeArray(const T* src, Size count) {
+        assert(canWrite(count * sizeof(T)));
+        detail::util::storeArray<T, LittleEndian>(
+            data_ + offset_, src, count);
+        offset_ += count * sizeof(T);
+    }
+
+    void writeBytes(const void* src, Size n) {
+        assert(canWrite(n));
+        memcpy(data_ + offset_, src, n);
+        offset_ += n;
+    }
+
+    void writeUInt8(UByte value) {
+        assert(canWrite(1));
+        data_[offset_++] = value;
+    }
+
+    void writeInt8(Byte value) {
+        writeUInt8(static_cast<UByte>(value));
+    }
+
+    void writeUInt16LE(UShort value) {
+        write<UShort, true>(value);
+    }
+
+    void writeUInt16BE(UShort value) {
+        write<UShort, false>(value);
+    }
+
+    void writeUInt32LE(UInt value) {
+        write<UInt, true>(value);
+    }
+
+    void writeUInt32BE(UInt value) {
+        write<UInt, false>(value);
+    }
+
+    void writeInt16LE(Short value) {
+        write<Short, true>(value);
+    }
+
+    void writeInt16BE(Short value) {
+        write<Short, false>(value);
+    }
+
+    void writeInt32LE(Int value) {
+        write<Int, true>(value);
+    }
+
+    void writeInt32BE(Int value) {
+        write<Int, false>(value);
+    }
+
+    void writeFloatLE(Float value) {
+        write<Float, true>(value);
+    }
+
+    void writeFloatBE(Float value) {
+        write<Float, false>(value);
+    }
+
+    void writeDoubleLE(Double value) {
+        write<Double, true>(value);
+    }
+
+    void writeDoubleBE(Double value) {
+        write<Double, false>(value);
+    }
+
+ private:
+    Buffer::Ptr buffer_;
+    UByte* data_;
+    Size length_;
+    Size offset_;
+};
+
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_BUFFER_WRITER_H_
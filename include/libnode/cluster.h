@@ -0,0 +1,36 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_CLUSTER_H_
+#define LIBNODE_CLUSTER_H_
+
+#include <libnode/cluster/worker.h>
+
+#include <libj/js_array.h>
+
+namespace libj {
+namespace node {
+namespace cluster {
+
+Boolean isMaster();
+
+Boolean isWorker();
+
+// runs this executable again as a worker process with args.
+// the servers of the workers listening on the same address share
+// the listening socket bound by the master.
+// the master calls it on the default loop, and null is returned otherwise.
+Worker::Ptr fork(
+    JsArray::CPtr args = JsArray::null(),
+    JsObject::CPtr env = JsObject::null());
+
+// the current worker in a worker process, null in the master
+Worker::Ptr worker();
+
+// the live workers in the master
+JsArray::CPtr workers();
+
+}  // namespace cluster
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_CLUSTER_H_
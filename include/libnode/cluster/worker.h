@@ -0,0 +1,39 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_CLUSTER_WORKER_H_
+#define LIBNODE_CLUSTER_WORKER_H_
+
+#include <libnode/events/event_emitter.h>
+
+namespace libj {
+namespace node {
+namespace cluster {
+
+class Worker : LIBNODE_EVENT_EMITTER(Worker)
+ public:
+    static Symbol::CPtr EVENT_ONLINE;
+    static Symbol::CPtr EVENT_LISTENING;
+    static Symbol::CPtr EVENT_MESSAGE;
+    static Symbol::CPtr EVENT_DISCONNECT;
+    static Symbol::CPtr EVENT_EXIT;
+
+    virtual Int id() const = 0;
+
+    virtual Boolean isConnected() const = 0;
+
+    virtual Boolean isDead() const = 0;
+
+    virtual Boolean send(const Value& msg) = 0;
+
+    virtual Boolean kill(Int signal = 15) = 0;
+
+    virtual void disconnect() = 0;
+};
+
+}  // namespace cluster
+}  // namespace node
+}  // namespace libj
+
+#include <libnode/impl/cluster/worker.h>
+
+#endif  // LIBNODE_CLUSTER_WORKER_H_
@@ -1,10 +1,11 @@
-// Copyright (c) 2014 Plenluno All rights reserved.
+// Copyright (c) 2014-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_ARGUMENTS_LIST_H_
 #define LIBNODE_DETAIL_ARGUMENTS_LIST_H_
 
 #include <libnode/config.h>
 #include <libnode/detail/free_list.h>
+#include <libnode/detail/uv/loop.h>
 
 #include <libj/js_array.h>
 
@@ -12,13 +13,23 @@ namespace libj {
 namespace node {
 namespace detail {
 
-inline FreeList<JsArray::Ptr>* argumentsList() {
+typedef FreeList<JsArray::Ptr> ArgumentsList;
+
+inline ArgumentsList* argumentsList() {
+    uv::LoopContext* context = uv::loopContext();
+    void* list = context->get(uv::LoopContext::ARGUMENTS_LIST);
+    if (!list) {
 #ifdef LIBNODE_USE_SP
-    static FreeList<JsArray::Ptr> list(100);
+        list = new ArgumentsList(100);
 #else
-    static FreeList<JsArray::Ptr> list(0);
+        list = new ArgumentsList(0);
 #endif
-    return &list;
+        context->set(
+            uv::LoopContext::ARGUMENTS_LIST,
+            list,
+            uv::destroy<ArgumentsList>);
+    }
+    return static_cast<ArgumentsList*>(list);
 }
 
 }  // namespace detail
@@ -1,14 +1,61 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_BUFFER_H_
 #define LIBNODE_DETAIL_BUFFER_H_
 
+#include <libnode/config.h>
+#include <libnode/detail/util/search.h>
+#include <libnode/detail/util/utf.h>
+
 #include <libj/detail/js_array_buffer.h>
 
+#include <algorithm>
+#include <string.h>
+
+#ifdef LIBNODE_USE_CXX11
+# include <memory>
+#else
+# include <boost/shared_ptr.hpp>
+#endif
+
 namespace libj {
 namespace node {
 namespace detail {
 
+// the memory which is not owned by a JsArrayBuffer.
+// it is released by the deleter when the last slice is gone.
+#ifdef LIBNODE_USE_CXX11
+typedef std::shared_ptr<void> BufferStorage;
+#else
+typedef boost::shared_ptr<void> BufferStorage;
+#endif
+
+// writes the whole chars of str that fit in dst without an intermediate
+// std::string, or returns NO_SIZE for the encodings other than UTF
+template<typename I>
+inline Size encodeString(
+    String::CPtr str,
+    typename I::Encoding enc,
+    UByte* dst,
+    Size dstLen) {
+    const util::Unit* src = util::units(str->data());
+    Size len = str->length();
+    switch (enc) {
+    case I::UTF8:
+        return util::utf8Encode(src, len, dst, dstLen);
+    case I::UTF16BE:
+        return util::utf16Encode(src, len, dst, dstLen, true);
+    case I::UTF16LE:
+        return util::utf16Encode(src, len, dst, dstLen, false);
+    case I::UTF32BE:
+        return util::utf32Encode(src, len, dst, dstLen, true);
+    case I::UTF32LE:
+        return util::utf32Encode(src, len, dst, dstLen, false);
+    default:
+        return NO_SIZE;
+    }
+}
+
 template<typename I>
 class Buffer : public I {
  public:
@@ -17,15 +64,15 @@ class Buffer : public I {
 
     Buffer(Size length)
         : buffer_(new libj::detail::JsArrayBuffer(length, false))
-        , offset_(0)
+        , storage_()
+        , data_(static_cast<UByte*>(const_cast<void*>(buffer_->data())))
         , length_(length) {}
 
-    Buffer(
-        libj::detail::JsArrayBuffer::Ptr buffer,
-        Size offset,
-        Size length)
-        : buffer_(buffer)
-        , offset_(offset)
+    // wraps the memory kept alive by storage
+    Buffer(BufferStorage storage, UByte* data, Size length)
+        : buffer_(libj::detail::JsArrayBuffer::null())
+        , storage_(storage)
+        , data_(data)
         , length_(length) {}
 
     virtual Ptr concat(CPtr other) const {
@@ -76,7 +123,7 @@ class Buffer : public I {
         if (end > length_) end = length_;
         if (start > end || start > length_) return I::null();
 
-        return Ptr(new Buffer(buffer_, offset_ + start, end - start));
+        return Ptr(new Buffer(*this, start, end - start));
     }
 
     virtual Int write(
@@ -90,41 +137,10 @@ class Buffer : public I {
             return 0;
         }
 
-        std::string s;
-        Size len;
-        switch (enc) {
-        case I::UTF8:
-            s = str->toStdString();
-            len = s.length();
-            break;
-        case I::UTF16BE:
-            s = str->toStdString(String::UTF16BE);
-            len = s.length() - 2;
-            break;
-        case I::UTF16LE:
-            s = str->toStdString(String::UTF16LE);
-            len = s.length() - 2;
-            break;
-        case I::UTF32BE:
-            s = str->toStdString(String::UTF32BE);
-            len = s.length() - 4;
-            break;
-        case I::UTF32LE:
-            s = str->toStdString(String::UTF32LE);
-            len = s.length() - 4;
-            break;
-        default:
-            return -1;
-        }
-
         Size remain = length_ - offset;
-        len = len < length ? len : length;
-        len = len < remain ? len : remain;
-        const UByte* src = reinterpret_cast<const UByte*>(s.c_str());
-        UByte* dst = static_cast<UByte*>(const_cast<void*>(buffer_->data()));
-        dst += offset_ + offset;
-        std::copy(src, src + len, dst);
-        return len;
+        if (length > remain) length = remain;
+        Size len = encodeString<I>(str, enc, data_ + offset, length);
+        return len == NO_SIZE ? -1 : static_cast<Int>(len);
     }
 
     virtual Size copy(
@@ -147,165 +163,277 @@ class Buffer : public I {
             copyLen = sourceLen < max ? sourceLen : max;
         }
 
-        const UByte* src = static_cast<const UByte*>(buffer_->data());
+        const UByte* src = data_ + sourceStart;
         UByte* dst = static_cast<UByte*>(const_cast<void*>(target->data()));
-        src += sourceStart + offset_;
         dst += targetStart;
         std::copy(src, src + copyLen, dst);
         return copyLen;
     }
 
+    virtual Size indexOf(
+        const Value& value,
+        Size byteOffset,
+        typename I::Encoding enc) const {
+        if (byteOffset > length_) return NO_POS;
+
+        const UByte* src = data_ + byteOffset;
+        Size len = length_ - byteOffset;
+        UByte byte;
+        if (toByte(value, &byte)) {
+            const void* found = memchr(src, byte, len);
+            return found
+                ? static_cast<const UByte*>(found) - data_
+                : NO_POS;
+        }
+
+        CPtr pattern = toBuffer(value, enc);
+        if (!pattern) return NO_POS;
+
+        Size pos = util::search(
+            src,
+            len,
+            static_cast<const UByte*>(pattern->data()),
+            pattern->length());
+        return pos == NO_POS ? NO_POS : byteOffset + pos;
+    }
+
+    virtual Boolean includes(
+        const Value& value,
+        Size byteOffset,
+        typename I::Encoding enc) const {
+        return indexOf(value, byteOffset, enc) != NO_POS;
+    }
+
+    virtual Boolean equals(CPtr other) const {
+        return other
+            && other->length() == length_
+            && !memcmp(data_, other->data(), length_);
+    }
+
+    virtual Int compare(CPtr other) const {
+        if (!other) return 1;
+
+        Size len = other->length();
+        Int r = memcmp(data_, other->data(), len < length_ ? len : length_);
+        if (r) {
+            return r < 0 ? -1 : 1;
+        } else if (length_ == len) {
+            return 0;
+        } else {
+            return length_ < len ? -1 : 1;
+        }
+    }
+
+    virtual Boolean fill(
+        const Value& value,
+        Size offset,
+        Size end,
+        typename I::Encoding enc) {
+        if (end > length_) end = length_;
+        if (offset > end) return false;
+
+        UByte byte;
+        if (toByte(value, &byte)) {
+            memset(data_ + offset, byte, end - offset);
+            return true;
+        }
+
+        CPtr pattern = toBuffer(value, enc);
+        if (!pattern) return false;
+
+        if (pattern->length()) {
+            util::fill(
+                data_ + offset,
+                end - offset,
+                static_cast<const UByte*>(pattern->data()),
+                pattern->length());
+        } else {
+            memset(data_ + offset, 0, end - offset);
+        }
+        return true;
+    }
+
     virtual Size length() const {
         return length_;
     }
 
     virtual const void* data() const {
-        return static_cast<const Byte*>(buffer_->data()) + offset_;
+        return data_;
     }
 
     virtual Boolean readUInt8(Size offset, UByte* value) const {
-        offset += offset_;
-        return buffer_->getUint8(offset, value);
+        return get(offset, value, true);
     }
 
     virtual Boolean readUInt16LE(Size offset, UShort* value) const {
-        offset += offset_;
-        return buffer_->getUint16(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readUInt16BE(Size offset, UShort* value) const {
-        offset += offset_;
-        return buffer_->getUint16(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean readUInt32LE(Size offset, UInt* value) const {
-        offset += offset_;
-        return buffer_->getUint32(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readUInt32BE(Size offset, UInt* value) const {
-        offset += offset_;
-        return buffer_->getUint32(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean readInt8(Size offset, Byte* value) const {
-        offset += offset_;
-        return buffer_->getInt8(offset, value);
+        return get(offset, value, true);
     }
 
     virtual Boolean readInt16LE(Size offset, Short* value) const {
-        offset += offset_;
-        return buffer_->getInt16(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readInt16BE(Size offset, Short* value) const {
-        offset += offset_;
-        return buffer_->getInt16(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean readInt32LE(Size offset, Int* value) const {
-        offset += offset_;
-        return buffer_->getInt32(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readInt32BE(Size offset, Int* value) const {
-        offset += offset_;
-        return buffer_->getInt32(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean readFloatLE(Size offset, Float* value) const {
-        offset += offset_;
-        return buffer_->getFloat32(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readFloatBE(Size offset, Float* value) const {
-        offset += offset_;
-        return buffer_->getFloat32(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean readDoubleLE(Size offset, Double* value) const {
-        offset += offset_;
-        return buffer_->getFloat64(offset, value, true);
+        return get(offset, value, true);
     }
 
     virtual Boolean readDoubleBE(Size offset, Double* value) const {
-        offset += offset_;
-        return buffer_->getFloat64(offset, value, false);
+        return get(offset, value, false);
     }
 
     virtual Boolean writeUInt8(UByte value, Size offset) {
-        offset += offset_;
-        return buffer_->setUint8(offset, value);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeUInt16LE(UShort value, Size offset) {
-        offset += offset_;
-        return buffer_->setUint16(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeUInt16BE(UShort value, Size offset) {
-        offset += offset_;
-        return buffer_->setUint16(offset, value, false);
+        return set(offset, value, false);
     }
 
     virtual Boolean writeUInt32LE(UInt value, Size offset) {
-        offset += offset_;
-        return buffer_->setUint32(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeUInt32BE(UInt value, Size offset) {
-        offset += offset_;
-        return buffer_->setUint32(offset, value, false);
+        return set(offset, value, false);
     }
 
     virtual Boolean writeInt8(Byte value, Size offset) {
-        offset += offset_;
-        return buffer_->setInt8(offset, value);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeInt16LE(Short value, Size offset) {
-        offset += offset_;
-        return buffer_->setInt16(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeInt16BE(Short value, Size offset) {
-        offset += offset_;
-        return buffer_->setInt16(offset, value, false);
+        return set(offset, value, false);
     }
 
     virtual Boolean writeInt32LE(Int value, Size offset) {
-        offset += offset_;
-        return buffer_->setInt32(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeInt32BE(Int value, Size offset) {
-        offset += offset_;
-        return buffer_->setInt32(offset, value, false);
+        return set(offset, value, false);
     }
 
     virtual Boolean writeFloatLE(Float value, Size offset) {
-        offset += offset_;
-        return buffer_->setFloat32(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeFloatBE(Float value, Size offset) {
-        offset += offset_;
-        return buffer_->setFloat32(offset, value, false);
+        return set(offset, value, false);
     }
 
     virtual Boolean writeDoubleLE(Double value, Size offset) {
-        offset += offset_;
-        return buffer_->setFloat64(offset, value, true);
+        return set(offset, value, true);
     }
 
     virtual Boolean writeDoubleBE(Double value, Size offset) {
-        offset += offset_;
-        return buffer_->setFloat64(offset, value, false);
+        return set(offset, value, false);
+    }
+
+ private:
+    // a slice shares the memory of buf
+    Buffer(const Buffer& buf, Size offset, Size length)
+        : buffer_(buf.buffer_)
+        , storage_(buf.storage_)
+        , data_(buf.data_ + offset)
+        , length_(length) {}
+
+    static Boolean toByte(const Value& value, UByte* byte) {
+        Long n;
+        if (!to<Long>(value, &n)) return false;
+
+        *byte = static_cast<UByte>(n & 0xff);
+        return true;
+    }
+
+    static CPtr toBuffer(const Value& value, typename I::Encoding enc) {
+        if (value.is<String>()) {
+            return I::create(toCPtr<String>(value), enc);
+        } else {
+            return toCPtr<I>(value);
+        }
+    }
+
+    static Boolean isLittleEndian() {
+        const UShort one = 1;
+        return *reinterpret_cast<const UByte*>(&one) == 1;
+    }
+
+    template<typename T>
+    Boolean get(Size offset, T* value, Boolean littleEndian) const {
+        if (offset > length_ || length_ - offset < sizeof(T)) return false;
+
+        const UByte* src = data_ + offset;
+        UByte* dst = reinterpret_cast<UByte*>(value);
+        if (littleEndian == isLittleEndian()) {
+            std::copy(src, src + sizeof(T), dst);
+        } else {
+            std::reverse_copy(src, src + sizeof(T), dst);
+        }
+        return true;
+    }
+
+    template<typename T>
+    Boolean set(Size offset, T value, Boolean littleEndian) {
+        if (offset > length_ || length_ - offset < sizeof(T)) return false;
+
+        const UByte* src = reinterpret_cast<const UByte*>(&value);
+        UByte* dst = data_ + offset;
+        if (littleEndian == isLittleEndian()) {
+            std::copy(src, src + sizeof(T), dst);
+        } else {
+            std::reverse_copy(src, src + sizeof(T), dst);
+        }
+        return true;
     }
 
  private:
     libj::detail::JsArrayBuffer::Ptr buffer_;
-    Size offset_;
+    BufferStorage storage_;
+    UByte* data_;
     Size length_;
 };
 
@@ -0,0 +1,220 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_BUFFER_LIST_H_
+#define LIBNODE_DETAIL_BUFFER_LIST_H_
+
+#include <libnode/buffer_list.h>
+
+#include <libj/typed_linked_list.h>
+
+#include <string.h>
+#include <vector>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+template<typename I>
+class BufferList : public I {
+ public:
+    BufferList()
+        : buffers_(Buffers::create())
+        , length_(0) {}
+
+    virtual Size length() const {
+        return length_;
+    }
+
+    virtual Boolean isEmpty() const {
+        return !length_;
+    }
+
+    virtual Size numBuffers() const {
+        return buffers_->length();
+    }
+
+    virtual Boolean append(Buffer::CPtr buf) {
+        if (!buf) return false;
+
+        if (buf->length()) {
+            buffers_->addTyped(buf);
+            length_ += buf->length();
+        }
+        return true;
+    }
+
+    virtual Boolean prepend(Buffer::CPtr buf) {
+        if (!buf) return false;
+
+        if (buf->length()) {
+            buffers_->unshiftTyped(buf);
+            length_ += buf->length();
+        }
+        return true;
+    }
+
+    virtual Buffer::CPtr shift() {
+        if (buffers_->isEmpty()) return Buffer::null();
+
+        Buffer::CPtr buf = buffers_->shiftTyped();
+        length_ -= buf->length();
+        return buf;
+    }
+
+    virtual Size consume(Size n) {
+        Size consumed = 0;
+        while (consumed < n && !buffers_->isEmpty()) {
+            Buffer::CPtr buf = buffers_->shiftTyped();
+            Size len = buf->length();
+            if (len <= n - consumed) {
+                consumed += len;
+            } else {
+                buffers_->unshiftTyped(buf->slice(n - consumed));
+                consumed = n;
+            }
+        }
+        length_ -= consumed;
+        return consumed;
+    }
+
+    virtual Size indexOf(Buffer::CPtr pattern, Size from) const {
+        if (!pattern) return NO_POS;
+
+        return indexOf(
+            static_cast<const UByte*>(pattern->data()),
+            pattern->length(),
+            from);
+    }
+
+    virtual Size indexOf(
+        String::CPtr pattern,
+        Size from,
+        Buffer::Encoding enc) const {
+        return indexOf(Buffer::create(pattern, enc), from);
+    }
+
+    virtual Size copy(
+        Buffer::Ptr target,
+        Size targetStart,
+        Size sourceStart,
+        Size sourceEnd) const {
+        if (!target) return 0;
+
+        if (sourceEnd > length_) sourceEnd = length_;
+        if (sourceStart >= sourceEnd || targetStart >= target->length()) {
+            return 0;
+        }
+
+        Size max = target->length() - targetStart;
+        if (sourceEnd - sourceStart > max) sourceEnd = sourceStart + max;
+
+        UByte* dst = static_cast<UByte*>(const_cast<void*>(target->data()));
+        dst += targetStart;
+
+        Size copied = 0;
+        Size base = 0;
+        TypedIterator<Buffer::CPtr>::Ptr itr = buffers_->iteratorTyped();
+        while (itr->hasNext() && base < sourceEnd) {
+            Buffer::CPtr buf = itr->nextTyped();
+            Size len = buf->length();
+            if (base + len > sourceStart) {
+                Size start = sourceStart > base ? sourceStart - base : 0;
+                Size end = sourceEnd - base < len ? sourceEnd - base : len;
+                const UByte* src = static_cast<const UByte*>(buf->data());
+                memcpy(dst + copied, src + start, end - start);
+                copied += end - start;
+            }
+            base += len;
+        }
+        return copied;
+    }
+
+    virtual Buffer::CPtr flatten() const {
+        if (buffers_->length() == 1) return buffers_->getTyped(0);
+
+        Buffer::Ptr buf = Buffer::create(length_);
+        copy(buf, 0, 0, length_);
+        return buf;
+    }
+
+    virtual void clear() {
+        buffers_->clear();
+        length_ = 0;
+    }
+
+ private:
+    struct Span {
+        const UByte* data;
+        Size length;
+    };
+
+    typedef std::vector<Span> Spans;
+
+    Size indexOf(const UByte* pattern, Size len, Size from) const {
+        if (from > length_) return NO_POS;
+        if (!len) return from;
+        if (len > length_ - from) return NO_POS;
+
+        Spans spans;
+        spans.reserve(buffers_->length());
+        TypedIterator<Buffer::CPtr>::Ptr itr = buffers_->iteratorTyped();
+        while (itr->hasNext()) {
+            Buffer::CPtr buf = itr->nextTyped();
+            Span span = {
+                static_cast<const UByte*>(buf->data()),
+                buf->length()
+            };
+            spans.push_back(span);
+        }
+
+        Size base = 0;
+        for (Size k = 0; k < spans.size(); k++) {
+            const UByte* data = spans[k].data;
+            Size size = spans[k].length;
+            Size i = from > base ? from - base : 0;
+            while (i < size) {
+                const void* found = memchr(data + i, pattern[0], size - i);
+                if (!found) break;
+
+                i = static_cast<const UByte*>(found) - data;
+                if (len > length_ - base - i) return NO_POS;
+                if (matches(spans, k, i, pattern, len)) return base + i;
+                i++;
+            }
+            base += size;
+        }
+        return NO_POS;
+    }
+
+    // the pattern may span several buffers from spans[k]
+    static Boolean matches(
+        const Spans& spans,
+        Size k,
+        Size i,
+        const UByte* pattern,
+        Size len) {
+        while (len) {
+            Size n = spans[k].length - i;
+            if (n > len) n = len;
+            if (memcmp(spans[k].data + i, pattern, n)) return false;
+
+            pattern += n;
+            len -= n;
+            k++;
+            i = 0;
+        }
+        return true;
+    }
+
+ private:
+    typedef TypedLinkedList<Buffer::CPtr> Buffers;
+
+    Buffers::Ptr buffers_;
+    Size length_;
+};
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_BUFFER_LIST_H_
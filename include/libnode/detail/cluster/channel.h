@@ -0,0 +1,159 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_CLUSTER_CHANNEL_H_
+#define LIBNODE_DETAIL_CLUSTER_CHANNEL_H_
+
+#include <libnode/invoke.h>
+#include <libnode/detail/uv/stream_common.h>
+
+#include <libj/json.h>
+#include <libj/status.h>
+#include <libj/string_builder.h>
+
+#include <string>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace cluster {
+
+// messages are JSON objects, one per line, over an ipc pipe.
+// a handle arrives with the bytes of the message it was sent with,
+// so received handles are queued until a message claims them.
+class Channel {
+ public:
+    Channel(uv::Pipe* pipe)
+        : pipe_(pipe)
+        , handles_(JsArray::create())
+        , onMessage_(JsFunction::null())
+        , onClose_(JsFunction::null()) {
+        assert(pipe_);
+        pipe_->setOnRead(JsFunction::Ptr(new OnRead(this)));
+    }
+
+    virtual ~Channel() {
+        close();
+    }
+
+    // onMessage is invoked with a message and a uv::Stream* or null
+    void setOnMessage(JsFunction::Ptr callback) {
+        onMessage_ = callback;
+    }
+
+    void setOnClose(JsFunction::Ptr callback) {
+        onClose_ = callback;
+    }
+
+    Boolean isOpen() const {
+        return !!pipe_;
+    }
+
+    Int readStart() {
+        return pipe_ ? pipe_->readStart() : UV_EBADF;
+    }
+
+    void ref() {
+        if (pipe_) pipe_->ref();
+    }
+
+    void unref() {
+        if (pipe_) pipe_->unref();
+    }
+
+    Boolean send(libj::JsObject::Ptr msg, uv::Stream* handle = NULL) {
+        LIBJ_STATIC_SYMBOL_DEF(symHandle, "handle");
+
+        if (!pipe_ || !msg) return false;
+
+        if (handle) msg->put(symHandle, true);
+        StringBuilder::Ptr sb = StringBuilder::create();
+        sb->appendStr(json::stringify(msg));
+        sb->appendChar('\n');
+        return !!pipe_->writeString(sb->toString(), Buffer::UTF8, handle);
+    }
+
+    void close() {
+        if (!pipe_) return;
+
+        pipe_->setOnRead(JsFunction::null());
+        pipe_->close();
+        pipe_ = NULL;
+
+        while (handles_->length()) {
+            uv::Stream* handle = to<uv::Stream*>(handles_->shift());
+            if (handle) handle->close();
+        }
+        invoke(onClose_);
+    }
+
+ private:
+    void receive(const char* data, Size len) {
+        LIBJ_STATIC_SYMBOL_DEF(symHandle, "handle");
+
+        Size start = 0;
+        for (Size i = 0; i < len; i++) {
+            if (data[i] != '\n') continue;
+
+            line_.append(data + start, i - start);
+            start = i + 1;
+
+            String::CPtr str =
+                String::create(line_.data(), String::UTF8, line_.length());
+            line_.clear();
+            libj::JsObject::Ptr msg = toPtr<libj::JsObject>(json::parse(str));
+            if (!msg) continue;
+
+            Value handle;
+            if (to<Boolean>(msg->get(symHandle)) && handles_->length()) {
+                handle = handles_->shift();
+            }
+            invoke(onMessage_, msg, handle);
+
+            // the channel may be closed by the callback
+            if (!pipe_) return;
+        }
+        line_.append(data + start, len - start);
+    }
+
+    class OnRead : LIBJ_JS_FUNCTION(OnRead)
+     public:
+        OnRead(Channel* self) : self_(self) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            ssize_t nread = to<ssize_t>(args->get(0));
+            if (nread < 0) {
+                self_->close();
+                return nread;
+            }
+
+            uv::Stream* handle;
+            if (to<uv::Stream*>(args->get(2), &handle)) {
+                self_->handles_->push(handle);
+            }
+
+            Buffer::CPtr buf = args->getCPtr<Buffer>(1);
+            if (buf) {
+                self_->receive(
+                    static_cast<const char*>(buf->data()),
+                    buf->length());
+            }
+            return Status::OK;
+        }
+
+     private:
+        Channel* self_;
+    };
+
+    uv::Pipe* pipe_;
+    std::string line_;
+    JsArray::Ptr handles_;
+    JsFunction::Ptr onMessage_;
+    JsFunction::Ptr onClose_;
+};
+
+}  // namespace cluster
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_CLUSTER_CHANNEL_H_
@@ -0,0 +1,443 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_CLUSTER_WORKER_H_
+#define LIBNODE_DETAIL_CLUSTER_WORKER_H_
+
+#include <libnode/cluster/worker.h>
+#include <libnode/detail/cluster/channel.h>
+#include <libnode/detail/events/event_emitter.h>
+#include <libnode/detail/uv/process.h>
+
+#include <libj/debug_print.h>
+#include <libj/string_builder.h>
+
+#include <stdlib.h>
+
+#ifdef LIBJ_PF_WINDOWS
+# define LIBNODE_ENVIRON _environ
+#else
+extern char** environ;
+# define LIBNODE_ENVIRON environ
+#endif
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace cluster {
+
+static const char ENV_WORKER_ID[] = "LIBNODE_CLUSTER_WORKER_ID";
+static const char ENV_CHANNEL_FD[] = "LIBNODE_CLUSTER_CHANNEL_FD";
+static const Int CHANNEL_FD = 3;
+
+// the listening handles bound by the master, keyed by address.
+// a handle is sent to every worker listening on its address,
+// and the workers accept the connections on it by themselves.
+struct SharedHandle {
+    uv::Tcp* tcp;
+    Size refs;
+};
+
+inline libj::JsObject::Ptr sharedHandles() {
+    static libj::JsObject::Ptr handles = libj::JsObject::null();
+    if (!handles) {
+        handles = libj::JsObject::create();
+        LIBJ_DEBUG_PRINT(
+            "static: cluster::sharedHandles %p",
+            LIBJ_DEBUG_OBJECT_PTR(handles));
+    }
+    return handles;
+}
+
+// the workers forked by the master and not exited yet
+inline JsArray::Ptr workers() {
+    static JsArray::Ptr workers = JsArray::null();
+    if (!workers) {
+        workers = JsArray::create();
+        LIBJ_DEBUG_PRINT(
+            "static: cluster::workers %p",
+            LIBJ_DEBUG_OBJECT_PTR(workers));
+    }
+    return workers;
+}
+
+inline String::CPtr sharedHandleKey(
+    String::CPtr address,
+    Int port,
+    Int addressType) {
+    StringBuilder::Ptr key = StringBuilder::create();
+    key->append(addressType);
+    key->appendChar(':');
+    key->appendStr(address);
+    key->appendChar(':');
+    key->append(port);
+    return key->toString();
+}
+
+// binds the handle for key on the first request.
+// each successful call is paired with a releaseSharedHandle.
+inline uv::Tcp* acquireSharedHandle(
+    String::CPtr key,
+    String::CPtr address,
+    Int port,
+    Int addressType,
+    Int* err) {
+    libj::JsObject::Ptr handles = sharedHandles();
+    SharedHandle* shared;
+    if (to<SharedHandle*>(handles->get(key), &shared)) {
+        shared->refs++;
+        *err = 0;
+        return shared->tcp;
+    }
+
+    uv::Tcp* tcp = new uv::Tcp(uv_default_loop());
+    if (addressType == 6) {
+        *err = tcp->bind6(address, port);
+    } else {
+        *err = tcp->bind(address, port);
+    }
+    if (*err) {
+        tcp->close();
+        return NULL;
+    }
+
+    shared = new SharedHandle();
+    shared->tcp = tcp;
+    shared->refs = 1;
+    handles->put(key, shared);
+    return tcp;
+}
+
+// the workers have their own copies of the socket,
+// so the master closes its handle when no worker uses it
+inline void releaseSharedHandle(String::CPtr key) {
+    libj::JsObject::Ptr handles = sharedHandles();
+    SharedHandle* shared;
+    if (!to<SharedHandle*>(handles->get(key), &shared)) return;
+
+    if (--shared->refs == 0) {
+        handles->remove(key);
+        shared->tcp->close();
+        delete shared;
+    }
+}
+
+class Worker : public events::EventEmitter<node::cluster::Worker> {
+ public:
+    LIBJ_MUTABLE_DEFS(Worker, LIBNODE_CLUSTER_WORKER);
+
+    // in the master. the worker runs this executable with args.
+    static Ptr fork(Int id, JsArray::CPtr args, libj::JsObject::CPtr env) {
+        char exe[4096];
+        size_t size = sizeof(exe);
+        if (uv_exepath(exe, &size)) return null();
+
+        uv::Pipe* pipe = new uv::Pipe(true, uv_default_loop());
+        uv::Process* process = new uv::Process(uv_default_loop());
+        Ptr worker(new Worker(id, pipe, process));
+        process->setOnExit(JsFunction::Ptr(new OnExit(worker)));
+
+        Int err = process->spawn(
+            String::create(exe, String::UTF8, size),
+            args,
+            environment(id, env),
+            pipe);
+        if (err) {
+            worker->process_ = NULL;
+            worker->dead_ = true;
+            process->close();
+            worker->channel_.close();
+            return null();
+        }
+
+        worker->channel_.readStart();
+        workers()->push(worker);
+        return worker;
+    }
+
+    // in a worker, connected to the master through the inherited pipe.
+    // the channel belongs to the default loop.
+    static Ptr self() {
+        static Ptr* worker = NULL;
+        static uv_once_t once = UV_ONCE_INIT;
+        struct Init {
+            static void create() {
+                worker = new Ptr(connect());
+            }
+        };
+        uv_once(&once, Init::create);
+        return *worker;
+    }
+
+    virtual Int id() const {
+        return id_;
+    }
+
+    virtual Boolean isConnected() const {
+        return channel_.isOpen();
+    }
+
+    virtual Boolean isDead() const {
+        return dead_;
+    }
+
+    virtual Boolean send(const Value& msg) {
+        LIBJ_STATIC_SYMBOL_DEF(symData, "data");
+
+        libj::JsObject::Ptr cmd = command(CMD_MESSAGE);
+        cmd->put(symData, msg);
+        return channel_.send(cmd);
+    }
+
+    virtual Boolean kill(Int signal) {
+        return process_ && !process_->kill(signal);
+    }
+
+    virtual void disconnect() {
+        channel_.close();
+    }
+
+ public:
+    // in a worker. callback is invoked with an error and a uv::Tcp*.
+    // the master replies in order, so the callbacks are queued.
+    Boolean queryServer(
+        String::CPtr address,
+        Int port,
+        Int addressType,
+        JsFunction::Ptr callback) {
+        libj::JsObject::Ptr cmd = command(CMD_QUERY_SERVER);
+        putAddress(cmd, address, port, addressType);
+        if (!channel_.send(cmd)) return false;
+
+        queries_->push(callback);
+        channel_.ref();
+        return true;
+    }
+
+    Boolean listening(String::CPtr address, Int port, Int addressType) {
+        libj::JsObject::Ptr cmd = command(CMD_LISTENING);
+        putAddress(cmd, address, port, addressType);
+        return channel_.send(cmd);
+    }
+
+ private:
+    static Ptr connect() {
+        const char* id = getenv(ENV_WORKER_ID);
+        const char* fd = getenv(ENV_CHANNEL_FD);
+        if (!id || !fd) return null();
+
+        uv::Pipe* pipe = new uv::Pipe(true, uv_default_loop());
+        pipe->open(atoi(fd));
+        Ptr worker(new Worker(atoi(id), pipe, NULL));
+        worker->channel_.readStart();
+
+        // the channel alone does not keep the worker alive
+        worker->channel_.unref();
+        worker->channel_.send(command(CMD_ONLINE));
+        LIBJ_DEBUG_PRINT(
+            "static: cluster::Worker %p",
+            LIBJ_DEBUG_OBJECT_PTR(worker));
+        return worker;
+    }
+
+    enum Command {
+        CMD_ONLINE,
+        CMD_QUERY_SERVER,
+        CMD_REPLY,
+        CMD_LISTENING,
+        CMD_MESSAGE,
+    };
+
+    static libj::JsObject::Ptr command(Command cmd) {
+        LIBJ_STATIC_SYMBOL_DEF(symCmd, "cmd");
+
+        libj::JsObject::Ptr obj = libj::JsObject::create();
+        obj->put(symCmd, static_cast<Int>(cmd));
+        return obj;
+    }
+
+    static void putAddress(
+        libj::JsObject::Ptr obj,
+        String::CPtr address,
+        Int port,
+        Int addressType) {
+        LIBJ_STATIC_SYMBOL_DEF(symAddress,     "address");
+        LIBJ_STATIC_SYMBOL_DEF(symPort,        "port");
+        LIBJ_STATIC_SYMBOL_DEF(symAddressType, "addressType");
+
+        obj->put(symAddress, address);
+        obj->put(symPort, port);
+        obj->put(symAddressType, addressType);
+    }
+
+    static JsArray::Ptr environment(Int id, libj::JsObject::CPtr env) {
+        JsArray::Ptr envs = JsArray::create();
+        for (char** e = LIBNODE_ENVIRON; e && *e; e++) {
+            envs->add(String::create(*e));
+        }
+
+        if (env) {
+            typedef libj::JsObject::Entry Entry;
+            TypedSet<Entry::CPtr>::CPtr entries = env->entrySet();
+            TypedIterator<Entry::CPtr>::Ptr itr = entries->iteratorTyped();
+            while (itr->hasNext()) {
+                Entry::CPtr entry = itr->nextTyped();
+                String::CPtr key = toCPtr<String>(entry->getKey());
+                String::CPtr val = toCPtr<String>(entry->getValue());
+                if (key && val) {
+                    StringBuilder::Ptr sb = StringBuilder::create();
+                    sb->appendStr(key);
+                    sb->appendChar('=');
+                    sb->appendStr(val);
+                    envs->add(sb->toString());
+                }
+            }
+        }
+
+        StringBuilder::Ptr sb = StringBuilder::create();
+        sb->appendStr(String::create(ENV_WORKER_ID));
+        sb->appendChar('=');
+        sb->append(id);
+        envs->add(sb->toString());
+        sb = StringBuilder::create();
+        sb->appendStr(String::create(ENV_CHANNEL_FD));
+        sb->appendChar('=');
+        sb->append(CHANNEL_FD);
+        envs->add(sb->toString());
+        return envs;
+    }
+
+    void onMessage(libj::JsObject::Ptr msg, const Value& handle) {
+        LIBJ_STATIC_SYMBOL_DEF(symCmd,         "cmd");
+        LIBJ_STATIC_SYMBOL_DEF(symData,        "data");
+        LIBJ_STATIC_SYMBOL_DEF(symErr,         "err");
+        LIBJ_STATIC_SYMBOL_DEF(symAddress,     "address");
+        LIBJ_STATIC_SYMBOL_DEF(symPort,        "port");
+        LIBJ_STATIC_SYMBOL_DEF(symAddressType, "addressType");
+
+        switch (to<Int>(msg->get(symCmd), -1)) {
+        case CMD_ONLINE:
+            emit(EVENT_ONLINE);
+            break;
+        case CMD_QUERY_SERVER:
+            {
+                String::CPtr address = toCPtr<String>(msg->get(symAddress));
+                Int port = to<Int>(msg->get(symPort));
+                Int addressType = to<Int>(msg->get(symAddressType));
+                String::CPtr key =
+                    sharedHandleKey(address, port, addressType);
+                Int err = 0;
+                uv::Tcp* tcp = acquireSharedHandle(
+                    key, address, port, addressType, &err);
+                if (tcp) sharedKeys_->push(key);
+                libj::JsObject::Ptr reply = command(CMD_REPLY);
+                reply->put(symErr, err);
+                channel_.send(reply, tcp);
+            }
+            break;
+        case CMD_REPLY:
+            if (queries_->length()) {
+                JsFunction::Ptr callback =
+                    toPtr<JsFunction>(queries_->shift());
+                if (!queries_->length()) channel_.unref();
+                invoke(callback, msg->get(symErr), handle);
+            }
+            break;
+        case CMD_LISTENING:
+            msg->remove(symCmd);
+            emit(EVENT_LISTENING, msg);
+            break;
+        case CMD_MESSAGE:
+            emit(EVENT_MESSAGE, msg->get(symData));
+            break;
+        default:
+            break;
+        }
+    }
+
+    class OnMessage : LIBJ_JS_FUNCTION(OnMessage)
+     public:
+        OnMessage(Worker* self) : self_(self) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            self_->onMessage(args->getPtr<libj::JsObject>(0), args->get(1));
+            return Status::OK;
+        }
+
+     private:
+        Worker* self_;
+    };
+
+    class OnDisconnect : LIBJ_JS_FUNCTION(OnDisconnect)
+     public:
+        OnDisconnect(Worker* self) : self_(self) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            self_->emit(EVENT_DISCONNECT);
+            return Status::OK;
+        }
+
+     private:
+        Worker* self_;
+    };
+
+    // keeps the worker alive until the process exits
+    class OnExit : LIBJ_JS_FUNCTION(OnExit)
+     public:
+        OnExit(Worker::Ptr self) : self_(self) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            self_->dead_ = true;
+            self_->process_->close();
+            self_->process_ = NULL;
+            self_->channel_.close();
+            self_->releaseSharedHandles();
+            self_->emit(EVENT_EXIT, args->get(0), args->get(1));
+
+            workers()->remove(self_);
+            return Status::OK;
+        }
+
+     private:
+        Worker::Ptr self_;
+    };
+
+    void releaseSharedHandles() {
+        Size len = sharedKeys_->length();
+        for (Size i = 0; i < len; i++) {
+            releaseSharedHandle(sharedKeys_->getCPtr<String>(i));
+        }
+        sharedKeys_->clear();
+    }
+
+    Worker(Int id, uv::Pipe* pipe, uv::Process* process)
+        : id_(id)
+        , dead_(false)
+        , channel_(pipe)
+        , process_(process)
+        , queries_(JsArray::create())
+        , sharedKeys_(JsArray::create()) {
+        channel_.setOnMessage(JsFunction::Ptr(new OnMessage(this)));
+        channel_.setOnClose(JsFunction::Ptr(new OnDisconnect(this)));
+    }
+
+ public:
+    virtual ~Worker() {
+        channel_.setOnClose(JsFunction::null());
+        if (process_) process_->close();
+    }
+
+ private:
+    Int id_;
+    Boolean dead_;
+    Channel channel_;
+    uv::Process* process_;
+    JsArray::Ptr queries_;
+    JsArray::Ptr sharedKeys_;
+};
+
+}  // namespace cluster
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_CLUSTER_WORKER_H_
@@ -377,7 +377,7 @@ class Socket : public events::EventEmitter<node::dgram::Socket> {
     JsArray::Ptr sendQueue_;
 
     Socket(Type type)
-        : handle_(new uv::Udp())
+        : handle_(new uv::Udp(uv::currentLoop()))
         , type_(type)
         , receiving_(false)
         , bindState_(UNBOUND)
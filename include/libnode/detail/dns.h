@@ -8,6 +8,7 @@
 #include <libnode/invoke.h>
 #include <libnode/process.h>
 #include <libnode/uv/error.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/req.h>
 
 #include <uv.h>
@@ -96,7 +97,7 @@ static int getAddrInfo(
     info.ai_socktype = SOCK_STREAM;
 
     int err = uv_getaddrinfo(
-        uv_default_loop(),
+        uv::currentLoop(),
         &get->req,
         afterGetAddrInfo,
         domain->toStdString().c_str(),
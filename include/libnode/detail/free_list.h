@@ -1,4 +1,4 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_FREE_LIST_H_
 #define LIBNODE_DETAIL_FREE_LIST_H_
@@ -41,6 +41,17 @@ class FreeList {
         }
     }
 
+    Size max() const {
+        return max_;
+    }
+
+    void setMax(Size max) {
+        max_ = max;
+        while (list_->length() > max_) {
+            list_->shiftTyped();
+        }
+    }
+
     void clear() {
         list_->clear();
     }
@@ -87,6 +98,17 @@ class FreeList<T, false> {
         }
     }
 
+    Size max() const {
+        return max_;
+    }
+
+    void setMax(Size max) {
+        max_ = max;
+        while (list_->length() > max_) {
+            delete list_->shiftTyped();
+        }
+    }
+
     void clear() {
         list_->clear();
     }
@@ -10,6 +10,7 @@
 #include <libnode/uv/error.h>
 #include <libnode/detail/fs/stats.h>
 #include <libnode/detail/uv/fs_req.h>
+#include <libnode/detail/uv/loop.h>
 
 #include <libj/js_regexp.h>
 #include <libj/bridge/abstract_js_object.h>
@@ -158,7 +159,7 @@ void stat(String::CPtr path, JsFunction::Ptr callback) {
     }
 
     int r = uv_fs_stat(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         after);
@@ -170,7 +171,7 @@ void fstat(const Value& fd, JsFunction::Ptr callback) {
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_fstat(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         after);
@@ -184,7 +185,7 @@ void lstat(String::CPtr path, JsFunction::Ptr callback) {
     }
 
     int r = uv_fs_lstat(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         after);
@@ -205,7 +206,7 @@ void chown(
     Int _gid = to<Int>(gid, INVALID_GID);
 
     int r = uv_fs_chown(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         _uid,
@@ -226,7 +227,7 @@ void fchown(
     Int _gid = to<Int>(gid, INVALID_GID);
 
     int r = uv_fs_fchown(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         _uid,
@@ -245,7 +246,7 @@ void chmod(
     }
 
     int r = uv_fs_chmod(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         mode,
@@ -261,7 +262,7 @@ void fchmod(
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_fchmod(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         mode,
@@ -277,7 +278,7 @@ void ftruncate(
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_ftruncate(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         len,
@@ -296,7 +297,7 @@ void utimes(
     }
 
     int r = uv_fs_utime(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         atime,
@@ -314,7 +315,7 @@ void futimes(
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_futime(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         atime,
@@ -330,7 +331,7 @@ void fsync(
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_fsync(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         after);
@@ -347,7 +348,7 @@ void mkdir(
     }
 
     int r = uv_fs_mkdir(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         mode,
@@ -364,7 +365,7 @@ void rmdir(
     }
 
     int r = uv_fs_rmdir(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         after);
@@ -380,7 +381,7 @@ void readdir(
     }
 
     int r = uv_fs_scandir(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         0,
@@ -406,7 +407,7 @@ void rename(
     const char* _oldPath = fsReq->path.c_str();
     const char* _newPath = _oldPath + secondStart;
     int r = uv_fs_rename(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         _oldPath,
         _newPath,
@@ -432,7 +433,7 @@ void link(
     const char* _srcPath = fsReq->path.c_str();
     const char* _dstPath = _srcPath + secondStart;
     int r = uv_fs_link(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         _srcPath,
         _dstPath,
@@ -459,7 +460,7 @@ void symlink(
     const char* _srcPath = fsReq->path.c_str();
     const char* _dstPath = _srcPath + secondStart;
     int r = uv_fs_symlink(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         _srcPath,
         _dstPath,
@@ -477,7 +478,7 @@ void unlink(
     }
 
     int r = uv_fs_unlink(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         after);
@@ -493,7 +494,7 @@ void readlink(
     }
 
     int r = uv_fs_readlink(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         after);
@@ -511,7 +512,7 @@ void open(
     }
 
     int r = uv_fs_open(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->path.c_str(),
         convertFlag(flag),
@@ -527,7 +528,7 @@ void close(
     fsReq->file = to<uv_file>(fd, INVALID_FD);
 
     int r = uv_fs_close(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         after);
@@ -558,7 +559,7 @@ void read(
     uv_buf_t uvbuf = uv_buf_init(static_cast<char*>(buf), len);
 
     int r = uv_fs_read(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         &uvbuf,
@@ -680,7 +681,7 @@ void write(
     uv_buf_t uvbuf = uv_buf_init(static_cast<char*>(buf), len);
 
     int r = uv_fs_write(
-        uv_default_loop(),
+        uv::currentLoop(),
         &(fsReq->req),
         fsReq->file,
         &uvbuf,
@@ -0,0 +1,124 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_HISTOGRAM_H_
+#define LIBNODE_DETAIL_HISTOGRAM_H_
+
+#include <libj/typedef.h>
+
+#include <string.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+// a fixed-size log-linear histogram in the manner of HdrHistogram.
+// values below 2^SUB_BITS are counted exactly, and larger ones
+// within 1/2^(SUB_BITS-1) of their values, so recording is O(1)
+// and never allocates.
+class Histogram {
+ public:
+    Histogram() {
+        reset();
+    }
+
+    void record(ULong value) {
+        if (value > MAX_VALUE) value = MAX_VALUE;
+        counts_[index(value)]++;
+        count_++;
+        sum_ += value;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    void reset() {
+        memset(counts_, 0, sizeof(counts_));
+        count_ = 0;
+        sum_ = 0;
+        min_ = MAX_VALUE;
+        max_ = 0;
+    }
+
+    ULong count() const {
+        return count_;
+    }
+
+    ULong min() const {
+        return count_ ? min_ : 0;
+    }
+
+    ULong max() const {
+        return max_;
+    }
+
+    Double mean() const {
+        return count_ ? static_cast<Double>(sum_) / count_ : 0;
+    }
+
+    // the highest value equivalent to the value at the percentile
+    ULong percentile(Double percent) const {
+        if (!count_) return 0;
+
+        ULong rank = static_cast<ULong>(percent / 100 * count_ + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > count_) rank = count_;
+
+        ULong seen = 0;
+        for (Size i = 0; i < NUM_BUCKETS; i++) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                ULong value = highestEquivalent(i);
+                return value < max_ ? value : max_;
+            }
+        }
+        return max_;
+    }
+
+ private:
+    static const Size SUB_BITS = 7;
+    static const Size SUB_COUNT = 1 << SUB_BITS;
+    static const Size HALF_COUNT = SUB_COUNT >> 1;
+    static const Size MAX_BITS = 40;
+    static const ULong MAX_VALUE = (static_cast<ULong>(1) << MAX_BITS) - 1;
+    static const Size NUM_BUCKETS =
+        SUB_COUNT + (MAX_BITS - SUB_BITS) * HALF_COUNT;
+
+    static Size msb(ULong value) {
+        Size n = 0;
+        if (value >> 32) { value >>= 32; n += 32; }
+        if (value >> 16) { value >>= 16; n += 16; }
+        if (value >> 8)  { value >>= 8;  n += 8; }
+        if (value >> 4)  { value >>= 4;  n += 4; }
+        if (value >> 2)  { value >>= 2;  n += 2; }
+        if (value >> 1)  { n += 1; }
+        return n;
+    }
+
+    static Size index(ULong value) {
+        if (value < SUB_COUNT) return static_cast<Size>(value);
+
+        Size shift = msb(value) - (SUB_BITS - 1);
+        Size sub = static_cast<Size>(value >> shift);
+        return SUB_COUNT + (shift - 1) * HALF_COUNT + (sub - HALF_COUNT);
+    }
+
+    static ULong highestEquivalent(Size index) {
+        if (index < SUB_COUNT) return index;
+
+        Size k = index - SUB_COUNT;
+        Size shift = k / HALF_COUNT + 1;
+        ULong sub = k % HALF_COUNT + HALF_COUNT;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    ULong counts_[NUM_BUCKETS];
+    ULong count_;
+    ULong sum_;
+    ULong min_;
+    ULong max_;
+};
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_HISTOGRAM_H_
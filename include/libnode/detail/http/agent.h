@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_AGENT_H_
 #define LIBNODE_DETAIL_HTTP_AGENT_H_
@@ -22,8 +22,12 @@ class Agent : public events::EventEmitter<node::http::Agent> {
     LIBJ_MUTABLE_DEFS(Agent, LIBNODE_HTTP_AGENT);
 
     static Ptr create(libj::JsObject::CPtr options) {
-        LIBJ_STATIC_SYMBOL_DEF(EVENT_FREE,         "free");
-        LIBJ_STATIC_SYMBOL_DEF(OPTION_MAX_SOCKETS, "maxSockets");
+        LIBJ_STATIC_SYMBOL_DEF(EVENT_FREE,                 "free");
+        LIBJ_STATIC_SYMBOL_DEF(OPTION_MAX_SOCKETS,         "maxSockets");
+        LIBJ_STATIC_SYMBOL_DEF(OPTION_KEEP_ALIVE,          "keepAlive");
+        LIBJ_STATIC_SYMBOL_DEF(OPTION_MAX_FREE_SOCKETS,    "maxFreeSockets");
+        LIBJ_STATIC_SYMBOL_DEF(OPTION_FREE_SOCKET_TIMEOUT,
+                               "freeSocketTimeout");
 
         Agent* agent = new Agent();
         if (options) {
@@ -31,9 +35,18 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             agent->maxSockets_ = to<Size>(
                 options->get(OPTION_MAX_SOCKETS),
                 agent->maxSockets_);
+            agent->keepAlive_ = to<Boolean>(
+                options->get(OPTION_KEEP_ALIVE),
+                agent->keepAlive_);
+            agent->maxFreeSockets_ = to<Size>(
+                options->get(OPTION_MAX_FREE_SOCKETS),
+                agent->maxFreeSockets_);
+            agent->freeSocketTimeout_ = to<UInt>(
+                options->get(OPTION_FREE_SOCKET_TIMEOUT),
+                agent->freeSocketTimeout_);
         }
 
-        agent->on(EVENT_FREE, JsFunction::Ptr(new Free(agent->requests_)));
+        agent->on(EVENT_FREE, JsFunction::Ptr(new Free(agent)));
         return Ptr(agent);
     }
 
@@ -45,6 +58,45 @@ class Agent : public events::EventEmitter<node::http::Agent> {
         maxSockets_ = max;
     }
 
+    virtual Boolean keepAlive() const {
+        return keepAlive_;
+    }
+
+    virtual Size maxFreeSockets() const {
+        return maxFreeSockets_;
+    }
+
+    virtual void setMaxFreeSockets(Size max) {
+        maxFreeSockets_ = max;
+    }
+
+    virtual UInt freeSocketTimeout() const {
+        return freeSocketTimeout_;
+    }
+
+    virtual void setFreeSocketTimeout(UInt msecs) {
+        freeSocketTimeout_ = msecs;
+    }
+
+    virtual Size freeSocketHits() const {
+        return freeSocketHits_;
+    }
+
+    virtual Size freeSocketMisses() const {
+        return freeSocketMisses_;
+    }
+
+    virtual void destroy() {
+        JsArray::Ptr sockets = JsArray::create();
+        collectSockets(freeSockets_, sockets);
+        collectSockets(sockets_, sockets);
+
+        Size len = sockets->length();
+        for (Size i = 0; i < len; i++) {
+            sockets->getPtr<net::Socket>(i)->destroy();
+        }
+    }
+
     void addRequest(
         OutgoingMessage::Ptr req,
         String::CPtr host,
@@ -68,9 +120,15 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             sockets_->put(name, ss);
         }
 
-        if (ss->length() < maxSockets_) {
-            net::Socket::Ptr socket =
-                createSocket(name, host, port, localAddress, req);
+        net::Socket::Ptr socket = reuseSocket(name);
+        if (socket) {
+            freeSocketHits_++;
+            ss->push(socket);
+            req->onSocket(socket);
+            socket->put(symRequest, req);
+        } else if (ss->length() < maxSockets_) {
+            freeSocketMisses_++;
+            socket = createSocket(name, host, port, localAddress, req);
             req->onSocket(socket);
             socket->put(symRequest, req);
         } else {
@@ -126,8 +184,12 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             this, socket, name, host, port, localAddress));
         socket->on(EVENT_CLOSE, onClose);
 
+        OnTimeout::Ptr onTimeout(new OnTimeout(this, socket, name));
+        socket->on(net::Socket::EVENT_TIMEOUT, onTimeout);
+
         OnRemove::Ptr onRemove(new OnRemove(
-            this, socket, name, host, port, localAddress, onFree, onClose));
+            this, socket, name, host, port, localAddress,
+            onFree, onClose, onTimeout));
         socket->on(EVENT_AGENT_REMOVE, onRemove);
         return socket;
     }
@@ -148,6 +210,14 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             }
         }
 
+        JsArray::Ptr fs = freeSockets_->getPtr<JsArray>(name);
+        if (fs) {
+            fs->remove(socket);
+            if (fs->isEmpty()) {
+                freeSockets_->remove(name);
+            }
+        }
+
         JsArray::Ptr rs = requests_->getPtr<JsArray>(name);
         if (rs && rs->length()) {
             OutgoingMessage::Ptr req = rs->getPtr<OutgoingMessage>(0);
@@ -156,9 +226,80 @@ class Agent : public events::EventEmitter<node::http::Agent> {
     }
 
  private:
+    // idle sockets are reused LIFO, so the most recently used one,
+    // which is the least likely to have been closed by the peer, goes first
+    net::Socket::Ptr reuseSocket(String::CPtr name) {
+        JsArray::Ptr fs = freeSockets_->getPtr<JsArray>(name);
+        while (fs && fs->length()) {
+            net::Socket::Ptr socket = toPtr<net::Socket>(fs->pop());
+            if (fs->isEmpty()) {
+                freeSockets_->remove(name);
+            }
+
+            if (socket->readable() && socket->writable()) {
+                socket->setTimeout(0);
+                socket->ref();
+                return socket;
+            } else {
+                socket->destroy();
+            }
+        }
+        return net::Socket::null();
+    }
+
+    Boolean keepSocket(net::Socket::Ptr socket, String::CPtr name) {
+        if (!keepAlive_ || !socket->readable() || !socket->writable()) {
+            return false;
+        }
+
+        JsArray::Ptr fs = freeSockets_->getPtr<JsArray>(name);
+        if (fs && fs->length() >= maxFreeSockets_) {
+            return false;
+        } else if (!fs) {
+            fs = JsArray::create();
+            freeSockets_->put(name, fs);
+        }
+
+        JsArray::Ptr ss = sockets_->getPtr<JsArray>(name);
+        if (ss) {
+            ss->remove(socket);
+            if (ss->isEmpty()) {
+                sockets_->remove(name);
+            }
+        }
+
+        fs->push(socket);
+        socket->setHttpMessage(NULL);
+        socket->unref();
+        if (freeSocketTimeout_) {
+            socket->setTimeout(freeSocketTimeout_);
+        }
+        return true;
+    }
+
+    Boolean isFree(net::Socket::Ptr socket, String::CPtr name) const {
+        JsArray::Ptr fs = freeSockets_->getPtr<JsArray>(name);
+        return fs && fs->indexOf(socket) >= 0;
+    }
+
+    static void collectSockets(
+        libj::JsObject::CPtr sockets,
+        JsArray::Ptr dest) {
+        typedef libj::JsObject::Entry Entry;
+        TypedSet<Entry::CPtr>::CPtr entries = sockets->entrySet();
+        TypedIterator<Entry::CPtr>::Ptr itr = entries->iteratorTyped();
+        while (itr->hasNext()) {
+            JsArray::CPtr ss = toCPtr<JsArray>(itr->nextTyped()->getValue());
+            Size len = ss->length();
+            for (Size i = 0; i < len; i++) {
+                dest->push(ss->get(i));
+            }
+        }
+    }
+
     class Free : LIBJ_JS_FUNCTION(Free)
      public:
-        Free(libj::JsObject::Ptr reqs) : requests_(reqs) {}
+        Free(Agent* self) : self_(self) {}
 
         virtual Value operator()(JsArray::Ptr args) {
             LIBJ_STATIC_SYMBOL_DEF(symRequest, "$request");
@@ -178,15 +319,18 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             }
             String::CPtr name = sb->toString();
 
-            JsArray::Ptr rs = requests_->getPtr<JsArray>(name);
+            libj::JsObject::Ptr requests = self_->requests_;
+            JsArray::Ptr rs = requests->getPtr<JsArray>(name);
             if (rs && rs->length()) {
                 OutgoingMessage::Ptr req = toPtr<OutgoingMessage>(rs->shift());
                 req->onSocket(socket);
                 socket->put(symRequest, req);
 
                 if (rs->isEmpty()) {
-                    requests_->remove(name);
+                    requests->remove(name);
                 }
+            } else if (self_->keepSocket(socket, name)) {
+                socket->remove(symRequest);
             } else {
                 socket->destroy();
                 socket->remove(symRequest);
@@ -198,7 +342,7 @@ class Agent : public events::EventEmitter<node::http::Agent> {
         }
 
      private:
-        libj::JsObject::Ptr requests_;
+        Agent* self_;
     };
 
     class OnFree : LIBJ_JS_FUNCTION(OnFree)
@@ -261,6 +405,29 @@ class Agent : public events::EventEmitter<node::http::Agent> {
         String::CPtr localAddress_;
     };
 
+    class OnTimeout : LIBJ_JS_FUNCTION(OnTimeout)
+     public:
+        OnTimeout(
+            Agent* self,
+            net::Socket::Ptr socket,
+            String::CPtr name)
+            : self_(self)
+            , socket_(socket)
+            , name_(name) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            if (self_->isFree(socket_, name_)) {
+                socket_->destroy();
+            }
+            return Status::OK;
+        }
+
+     private:
+        Agent* self_;
+        net::Socket::Ptr socket_;
+        String::CPtr name_;
+    };
+
     class OnRemove : LIBJ_JS_FUNCTION(OnRemove)
         OnRemove(
             Agent* self,
@@ -270,7 +437,8 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             String::CPtr port,
             String::CPtr localAddress,
             OnFree::Ptr onFree,
-            OnClose::Ptr onClose)
+            OnClose::Ptr onClose,
+            OnTimeout::Ptr onTimeout)
             : self_(self)
             , socket_(socket)
             , name_(name)
@@ -278,7 +446,8 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             , port_(port)
             , localAddress_(localAddress)
             , onFree_(onFree)
-            , onClose_(onClose) {}
+            , onClose_(onClose)
+            , onTimeout_(onTimeout) {}
 
         virtual Value operator()(JsArray::Ptr args) {
             LIBJ_STATIC_SYMBOL_DEF(EVENT_FREE,         "free");
@@ -288,6 +457,7 @@ class Agent : public events::EventEmitter<node::http::Agent> {
             self_->removeSocket(socket_, name_, host_, port_, localAddress_);
             socket_->removeListener(EVENT_FREE, onFree_);
             socket_->removeListener(EVENT_CLOSE, onClose_);
+            socket_->removeListener(net::Socket::EVENT_TIMEOUT, onTimeout_);
             socket_->removeListener(
                 EVENT_AGENT_REMOVE, LIBJ_THIS_PTR(OnRemove));
             return Status::OK;
@@ -302,6 +472,7 @@ class Agent : public events::EventEmitter<node::http::Agent> {
         String::CPtr localAddress_;
         OnFree::Ptr onFree_;
         OnClose::Ptr onClose_;
+        OnTimeout::Ptr onTimeout_;
     };
 
     class SocketFree : LIBJ_JS_FUNCTION(SocketFree)
@@ -328,13 +499,25 @@ class Agent : public events::EventEmitter<node::http::Agent> {
 
  private:
     Size maxSockets_;
+    Size maxFreeSockets_;
+    UInt freeSocketTimeout_;
+    Boolean keepAlive_;
+    Size freeSocketHits_;
+    Size freeSocketMisses_;
     libj::JsObject::Ptr sockets_;
+    libj::JsObject::Ptr freeSockets_;
     libj::JsObject::Ptr requests_;
     libj::JsObject::CPtr options_;
 
     Agent()
         : maxSockets_(5)
+        , maxFreeSockets_(256)
+        , freeSocketTimeout_(15000)
+        , keepAlive_(false)
+        , freeSocketHits_(0)
+        , freeSocketMisses_(0)
         , sockets_(libj::JsObject::create())
+        , freeSockets_(libj::JsObject::create())
         , requests_(libj::JsObject::create())
         , options_(libj::JsObject::create()) {}
 };
@@ -1,5 +1,5 @@
 /* Generated by re2c 0.13.6 on Sun Sep  8 17:58:13 2013 */
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_HEADER_SCANNER_H_
 #define LIBNODE_DETAIL_HTTP_HEADER_SCANNER_H_
@@ -38,6 +38,24 @@ inline String::CPtr createLowerString(const char32_t* buf, size_t len) {
     return String::create(buf, String::UTF32, len)->toLowerCase();
 }
 
+template<typename YYCTYPE>
+inline String::CPtr createString(const YYCTYPE* buf, size_t len);
+
+template<>
+inline String::CPtr createString(const char* buf, size_t len) {
+    return String::create(buf, String::UTF8, len);
+}
+
+template<>
+inline String::CPtr createString(const char16_t* buf, size_t len) {
+    return String::create(buf, String::UTF16, len);
+}
+
+template<>
+inline String::CPtr createString(const char32_t* buf, size_t len) {
+    return String::create(buf, String::UTF32, len);
+}
+
 template<typename YYCTYPE>
 inline String::CPtr scanHeaderField(const YYCTYPE* buf, size_t len) {
     if (!buf || !len) return String::create();
@@ -3806,6 +3824,50 @@ yy629:
 
 }
 
+template<typename YYCTYPE, size_t N>
+inline bool matchHeaderValue(const YYCTYPE* buf, const char (&str)[N]) {
+    for (size_t i = 0; i < N - 1; i++) {
+        if (buf[i] != static_cast<YYCTYPE>(str[i])) return false;
+    }
+    return true;
+}
+
+// interns the common values as static symbols.
+// unlike a field, a value keeps its case, so the match is exact.
+template<typename YYCTYPE>
+inline String::CPtr scanHeaderValue(const YYCTYPE* buf, size_t len) {
+    LIBJ_STATIC_SYMBOL_DEF(symAny,       "*/*");
+    LIBJ_STATIC_SYMBOL_DEF(symGzip,      "gzip");
+    LIBJ_STATIC_SYMBOL_DEF(symClose,     "close");
+    LIBJ_STATIC_SYMBOL_DEF(symChunked,   "chunked");
+    LIBJ_STATIC_SYMBOL_DEF(symKeepAlive, "keep-alive");
+    LIBJ_STATIC_SYMBOL_DEF(symJson,      "application/json");
+
+    if (!buf || !len) return String::create();
+
+    switch (len) {
+    case 3:
+        if (matchHeaderValue(buf, "*/*")) return symAny;
+        break;
+    case 4:
+        if (matchHeaderValue(buf, "gzip")) return symGzip;
+        break;
+    case 5:
+        if (matchHeaderValue(buf, "close")) return symClose;
+        break;
+    case 7:
+        if (matchHeaderValue(buf, "chunked")) return symChunked;
+        break;
+    case 10:
+        if (matchHeaderValue(buf, "keep-alive")) return symKeepAlive;
+        break;
+    case 16:
+        if (matchHeaderValue(buf, "application/json")) return symJson;
+        break;
+    }
+    return createString(buf, len);
+}
+
 }  // namespace http
 }  // namespace detail
 }  // namespace node
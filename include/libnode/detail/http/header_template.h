@@ -0,0 +1,102 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_HTTP_HEADER_TEMPLATE_H_
+#define LIBNODE_DETAIL_HTTP_HEADER_TEMPLATE_H_
+
+#include <libnode/http/header_template.h>
+#include <libnode/detail/http/header_scanner.h>
+
+#include <string.h>
+#include <vector>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace http {
+
+template<typename I>
+class HeaderTemplate : public I {
+ public:
+    // the bytes of a line in the buffer, and its lowercase name
+    struct Line {
+        String::CPtr name;
+        Size begin;
+        Size end;
+    };
+
+    typedef std::vector<Line> Lines;
+
+    // values has the values keyed by the lowercase names
+    HeaderTemplate(
+        Buffer::CPtr buffer,
+        libj::JsObject::CPtr values,
+        const Lines& lines)
+        : buffer_(buffer)
+        , values_(values)
+        , lines_(lines) {}
+
+    virtual Boolean has(String::CPtr name) const {
+        if (!name) return false;
+
+        return values_->containsKey(
+            scanHeaderField<Char>(name->data(), name->length()));
+    }
+
+    virtual Value get(String::CPtr name) const {
+        if (!name) return UNDEFINED;
+
+        return values_->get(
+            scanHeaderField<Char>(name->data(), name->length()));
+    }
+
+    virtual Buffer::CPtr toBuffer() const {
+        return buffer_;
+    }
+
+    virtual String::CPtr toString() const {
+        return buffer_->toString();
+    }
+
+    virtual Buffer::CPtr toBuffer(libj::JsObject::CPtr omitted) const {
+        if (!omitted) return buffer_;
+
+        const UByte* data = static_cast<const UByte*>(buffer_->data());
+        Size len = buffer_->length();
+        Size size = len;
+        for (typename Lines::const_iterator itr = lines_.begin();
+             itr != lines_.end();
+             ++itr) {
+            if (omitted->containsKey(itr->name)) {
+                size -= itr->end - itr->begin;
+            }
+        }
+        if (size == len) return buffer_;
+
+        Buffer::Ptr buf = Buffer::create(size);
+        UByte* dst = static_cast<UByte*>(const_cast<void*>(buf->data()));
+        Size start = 0;
+        for (typename Lines::const_iterator itr = lines_.begin();
+             itr != lines_.end();
+             ++itr) {
+            if (omitted->containsKey(itr->name)) {
+                memcpy(dst, data + start, itr->begin - start);
+                dst += itr->begin - start;
+                start = itr->end;
+            }
+        }
+        memcpy(dst, data + start, len - start);
+        return buf;
+    }
+
+ private:
+    Buffer::CPtr buffer_;
+    libj::JsObject::CPtr values_;
+    Lines lines_;
+};
+
+}  // namespace http
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_HTTP_HEADER_TEMPLATE_H_
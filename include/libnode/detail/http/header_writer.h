@@ -0,0 +1,206 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_HTTP_HEADER_WRITER_H_
+#define LIBNODE_DETAIL_HTTP_HEADER_WRITER_H_
+
+#include <libnode/buffer.h>
+#include <libnode/detail/util/utf.h>
+
+#include <string.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace http {
+
+// "HTTP/1.1 200 OK\r\n" for the known codes, or NULL
+const char* statusLine(Int code, Size* length);
+
+// assembles a message header in UTF-8, in a slab Buffer.
+// toBuffer() hands out the bytes as a slice of the slab without copying,
+// and the next message is written after them, so a pooled message
+// fills the same slab until it runs out.
+class HeaderWriter {
+ public:
+    static const Size SLAB_SIZE = 16 * 1024;
+    static const Size MAX_RETAINED = 64 * 1024;
+
+    HeaderWriter()
+        : slab_(Buffer::null())
+        , data_(NULL)
+        , start_(0)
+        , end_(0)
+        , capacity_(0) {}
+
+    Size length() const {
+        return end_ - start_;
+    }
+
+    const UByte* data() const {
+        return data_ + start_;
+    }
+
+    // the size of the current slab
+    Size capacity() const {
+        return capacity_;
+    }
+
+    // drops the bytes not handed out yet.
+    // a slab grown by a large body is not kept in the pool.
+    void clear() {
+        end_ = start_;
+        if (capacity_ > MAX_RETAINED) {
+            slab_ = Buffer::null();
+            data_ = NULL;
+            start_ = 0;
+            end_ = 0;
+            capacity_ = 0;
+        }
+    }
+
+    void append(const void* data, Size len) {
+        memcpy(reserve(len), data, len);
+        end_ += len;
+    }
+
+    template<Size N>
+    void appendLiteral(const char (&str)[N]) {
+        append(str, N - 1);
+    }
+
+    void append(char c) {
+        *reserve(1) = static_cast<UByte>(c);
+        end_++;
+    }
+
+    void append(String::CPtr str) {
+        if (!str) return;
+
+        // a unit of UTF-16 or UTF-32 is at most 4 bytes in UTF-8.
+        // a string that may not fit is measured first,
+        // so that a large body does not grow the slab to 4x its size.
+        const util::Unit* units = util::units(str->data());
+        Size len = str->length();
+        Size max = len * 4;
+        if (capacity_ - end_ < max) max = util::utf8Length(units, len);
+        end_ += util::utf8Encode(units, len, reserve(max), max);
+    }
+
+    void appendValue(const Value& value) {
+        String::CPtr str = toCPtr<String>(value);
+        append(str ? str : String::valueOf(value));
+    }
+
+    void append(Buffer::CPtr buf) {
+        if (buf) append(buf->data(), buf->length());
+    }
+
+    // str in enc, like net::Socket::write
+    void append(String::CPtr str, Buffer::Encoding enc) {
+        if (enc == Buffer::NONE || enc == Buffer::UTF8) {
+            append(str);
+        } else {
+            append(Buffer::create(str, enc));
+        }
+    }
+
+    void appendDecimal(Long n) {
+        char buf[24];
+        char* end = buf + sizeof(buf);
+        char* p = end;
+        ULong u = n < 0 ? -static_cast<ULong>(n) : static_cast<ULong>(n);
+        do {
+            *--p = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u);
+        if (n < 0) *--p = '-';
+        append(p, end - p);
+    }
+
+    void appendHex(Size n) {
+        char buf[sizeof(Size) * 2];
+        char* end = buf + sizeof(buf);
+        char* p = formatHex(n, end);
+        append(p, end - p);
+    }
+
+    void appendCRLF() {
+        appendLiteral("\r\n");
+    }
+
+    void appendStatusLine(Int code, String::CPtr reasonPhrase) {
+        Size len = 0;
+        const char* line = reasonPhrase ? NULL : statusLine(code, &len);
+        if (line) {
+            append(line, len);
+        } else {
+            appendLiteral("HTTP/1.1 ");
+            appendDecimal(code);
+            append(' ');
+            if (reasonPhrase) {
+                append(reasonPhrase);
+            } else {
+                appendLiteral("Unknown");
+            }
+            appendCRLF();
+        }
+    }
+
+    // the bytes written since the last call, not copied
+    Buffer::CPtr toBuffer() {
+        if (!slab_) return Buffer::create();
+
+        Buffer::CPtr buf = slab_->slice(start_, end_);
+        start_ = end_;
+        return buf;
+    }
+
+    // writes the lowercase hex digits of n just before end,
+    // and returns the first digit
+    static char* formatHex(Size n, char* end) {
+        static const char DIGITS[] = "0123456789abcdef";
+        char* p = end;
+        do {
+            *--p = DIGITS[n & 0xf];
+            n >>= 4;
+        } while (n);
+        return p;
+    }
+
+ private:
+    // the bytes handed out stay in the old slab with their slices
+    UByte* reserve(Size len) {
+        if (capacity_ - end_ < len) {
+            Size pending = end_ - start_;
+            Size capacity = SLAB_SIZE;
+            while (capacity - pending < len) capacity *= 2;
+
+            Buffer::Ptr slab = Buffer::create(capacity);
+            UByte* data = static_cast<UByte*>(const_cast<void*>(slab->data()));
+            if (pending) memcpy(data, data_ + start_, pending);
+            slab_ = slab;
+            data_ = data;
+            start_ = 0;
+            end_ = pending;
+            capacity_ = capacity;
+        }
+        return data_ + end_;
+    }
+
+    HeaderWriter(const HeaderWriter&);
+    HeaderWriter& operator=(const HeaderWriter&);
+
+ private:
+    Buffer::Ptr slab_;
+    UByte* data_;
+    Size start_;
+    Size end_;
+    Size capacity_;
+};
+
+}  // namespace http
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_HTTP_HEADER_WRITER_H_
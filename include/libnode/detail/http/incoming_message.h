@@ -1,18 +1,21 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_INCOMING_MESSAGE_H_
 #define LIBNODE_DETAIL_HTTP_INCOMING_MESSAGE_H_
 
 #include <libnode/config.h>
+#include <libnode/buffer_list.h>
 #include <libnode/http/header.h>
 #include <libnode/process.h>
 #include <libnode/stream/readable.h>
 #include <libnode/string_decoder.h>
+#include <libnode/detail/stream_pipe.h>
 #include <libnode/detail/net/socket.h>
 #include <libnode/detail/events/event_emitter.h>
+#include <libnode/detail/http/header_scanner.h>
 
 #include <libj/debug_print.h>
-#include <libj/linked_list.h>
+#include <libj/this.h>
 
 #include <assert.h>
 
@@ -24,6 +27,9 @@ namespace http {
 class OutgoingMessage;
 
 class IncomingMessage : public events::EventEmitter<stream::Readable> {
+ private:
+    typedef TypedJsArray<Buffer::CPtr> BufferArray;
+
  public:
     LIBJ_MUTABLE_DEFS(IncomingMessage, LIBNODE_STREAM_READABLE);
 
@@ -56,6 +62,18 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
         return res;
     }
 
+    virtual Boolean pipe(
+        stream::Stream::Ptr dest,
+        JsObject::CPtr options = JsObject::null()) {
+        return pipeStream<stream::Readable>(
+            LIBJ_THIS_PTR(IncomingMessage), dest, options);
+    }
+
+    virtual Boolean unpipe(stream::Stream::CPtr dest = stream::Stream::null()) {
+        return unpipeStream<stream::Readable>(
+            LIBJ_THIS_PTR(IncomingMessage), dest);
+    }
+
     virtual Boolean destroy() {
         return socket_ && socket_->destroy();
     }
@@ -70,6 +88,7 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
     }
 
     libj::JsObject::CPtr headers() const {
+        decodeRawHeaders();
         return headers_;
     }
 
@@ -119,22 +138,102 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
     }
 
     String::CPtr getHeader(String::CPtr name) const {
+        if (!rawFields_->isEmpty() && name &&
+            !name->equals(node::http::LHEADER_SET_COOKIE)) {
+            // decode only the requested header if it appears just once
+            Size n = rawFields_->length();
+            Size found = NO_POS;
+            for (Size i = 0; i < n; i++) {
+                if (equalsRawField(rawFields_->getTyped(i), name)) {
+                    if (found == NO_POS) {
+                        found = i;
+                    } else {
+                        found = NO_POS;
+                        decodeRawHeaders();
+                        break;
+                    }
+                }
+            }
+            if (found != NO_POS) {
+                return decodeHeaderValue(rawValues_->getTyped(found));
+            }
+        }
         return headers_->getCPtr<String>(name);
     }
 
     void setHeader(String::CPtr name, String::CPtr value) {
+        decodeRawHeaders();
         headers_->put(name->toLowerCase(), value);
     }
 
     void addHeaderLine(String::CPtr name, String::CPtr value) {
+        putHeaderLine(hasFlag(COMPLETE) ? trailers_ : headers_, name, value);
+    }
+
+    void addRawHeaderLine(Buffer::CPtr name, Buffer::CPtr value) {
+        assert(name && value);
+
+        if (hasFlag(COMPLETE)) {
+            putHeaderLine(
+                trailers_,
+                decodeHeaderField(name),
+                decodeHeaderValue(value));
+        } else {
+            rawFields_->addTyped(name);
+            rawValues_->addTyped(value);
+        }
+    }
+
+ private:
+    static String::CPtr decodeHeaderField(Buffer::CPtr buf) {
+        return scanHeaderField<char>(
+            static_cast<const char*>(buf->data()), buf->length());
+    }
+
+    static String::CPtr decodeHeaderValue(Buffer::CPtr buf) {
+        return scanHeaderValue<char>(
+            static_cast<const char*>(buf->data()), buf->length());
+    }
+
+    static Boolean equalsRawField(Buffer::CPtr field, String::CPtr name) {
+        Size len = field->length();
+        if (len != name->length()) return false;
+
+        const char* s = static_cast<const char*>(field->data());
+        const Char* n = name->data();
+        for (Size i = 0; i < len; i++) {
+            char c = s[i];
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+            if (static_cast<Char>(c) != n[i]) return false;
+        }
+        return true;
+    }
+
+    void decodeRawHeaders() const {
+        Size n = rawFields_->length();
+        if (!n) return;
+
+        for (Size i = 0; i < n; i++) {
+            putHeaderLine(
+                headers_,
+                decodeHeaderField(rawFields_->getTyped(i)),
+                decodeHeaderValue(rawValues_->getTyped(i)));
+        }
+        rawFields_->clear();
+        rawValues_->clear();
+    }
+
+    static void putHeaderLine(
+        libj::JsObject::Ptr dest,
+        String::CPtr name,
+        String::CPtr value) {
         LIBJ_STATIC_SYMBOL_DEF(symExtPrefix, "x-");
 
         assert(name && value);
 
-        libj::JsObject::Ptr dest = hasFlag(COMPLETE) ? trailers_ : headers_;
         String::CPtr field = name->toLowerCase();
         if (field->equals(node::http::LHEADER_SET_COOKIE)) {
-            JsArray::Ptr vals = headers_->getPtr<JsArray>(field);
+            JsArray::Ptr vals = dest->getPtr<JsArray>(field);
             if (vals) {
                 vals->add(value);
             } else {
@@ -155,7 +254,7 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
             field->equals(node::http::LHEADER_PROXY_AUTHENTICATE) ||
             field->equals(node::http::LHEADER_SEC_WEBSOCKET_EXTENSIONS) ||
             field->equals(node::http::LHEADER_SEC_WEBSOCKET_PROTOCOL)) {
-            String::CPtr vals = headers_->getCPtr<String>(field);
+            String::CPtr vals = dest->getCPtr<String>(field);
             if (vals) {
                 StringBuilder::Ptr sb = StringBuilder::create();
                 sb->appendStr(vals);
@@ -170,6 +269,7 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
         }
     }
 
+ public:
     void setMethod(String::CPtr method) {
         method_ = method;
     }
@@ -190,12 +290,12 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
         req_ = req;
     }
 
-    LinkedList::Ptr pendings() const {
+    BufferList::Ptr pendings() const {
         return pendings_;
     }
 
     void emitPending(JsFunction::Ptr callback = JsFunction::null()) {
-        if (pendings_->isEmpty()) {
+        if (pendings_->isEmpty() && !hasFlag(END_PENDING)) {
             if (callback) (*callback)();
         } else {
             JsFunction::Ptr emit(new EmitPending(this, callback));
@@ -242,6 +342,8 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
 
         headers_->clear();
         trailers_->clear();
+        rawFields_->clear();
+        rawValues_->clear();
         pendings_->clear();
         decoder_ = StringDecoder::null();
         req_ = NULL;
@@ -259,18 +361,15 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
             , callback_(callback) {}
 
         virtual Value operator()(JsArray::Ptr args) {
-            LinkedList::Ptr pendings = self_->pendings_;
+            BufferList::Ptr pendings = self_->pendings_;
             assert(pendings);
-            while (!self_->hasFlag(PAUSED) && pendings->length()) {
-                Buffer::Ptr chunk = toPtr<Buffer>(pendings->shift());
-                if (chunk) {
-                    assert(Buffer::isBuffer(chunk));
-                    self_->emitData(chunk);
-                } else {
-                    assert(pendings->isEmpty());
-                    self_->unsetFlag(READABLE);
-                    self_->emitEnd();
-                }
+            while (!self_->hasFlag(PAUSED) && !pendings->isEmpty()) {
+                self_->emitData(pendings->shift());
+            }
+            if (!self_->hasFlag(PAUSED) && self_->hasFlag(END_PENDING)) {
+                self_->unsetFlag(END_PENDING);
+                self_->unsetFlag(READABLE);
+                self_->emitEnd();
             }
             if (callback_) (*callback_)();
             return Status::OK;
@@ -289,6 +388,7 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
         END_EMITTED = 1 << 3,
         UPGRADE     = 1 << 4,
         UNUSED      = 1 << 5,
+        END_PENDING = 1 << 6,
     } Flag;
 
  private:
@@ -301,7 +401,9 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
     Int statusCode_;
     libj::JsObject::Ptr headers_;
     libj::JsObject::Ptr trailers_;
-    LinkedList::Ptr pendings_;
+    BufferArray::Ptr rawFields_;
+    BufferArray::Ptr rawValues_;
+    BufferList::Ptr pendings_;
     StringDecoder::Ptr decoder_;
     OutgoingMessage* req_;
 
@@ -315,7 +417,9 @@ class IncomingMessage : public events::EventEmitter<stream::Readable> {
         , statusCode_(0)
         , headers_(libj::JsObject::create())
         , trailers_(libj::JsObject::create())
-        , pendings_(LinkedList::create())
+        , rawFields_(BufferArray::create())
+        , rawValues_(BufferArray::create())
+        , pendings_(BufferList::create())
         , decoder_(StringDecoder::null())
         , req_(NULL) {
         setFlag(READABLE);
@@ -1,9 +1,10 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_INCOMING_MESSAGE_LIST_H_
 #define LIBNODE_DETAIL_HTTP_INCOMING_MESSAGE_LIST_H_
 
 #include <libnode/detail/free_list.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/http/incoming_message.h>
 
 namespace libj {
@@ -11,13 +12,23 @@ namespace node {
 namespace detail {
 namespace http {
 
-inline FreeList<IncomingMessage::Ptr>* incomingMessageList() {
+typedef FreeList<IncomingMessage::Ptr> IncomingMessageList;
+
+inline IncomingMessageList* incomingMessageList() {
+    uv::LoopContext* context = uv::loopContext();
+    void* list = context->get(uv::LoopContext::INCOMING_MESSAGE_LIST);
+    if (!list) {
 #ifdef LIBJ_USE_SP
-    static FreeList<IncomingMessage::Ptr> list(100);
+        list = new IncomingMessageList(100);
 #else
-    static FreeList<IncomingMessage::Ptr> list(0);
+        list = new IncomingMessageList(0);
 #endif
-    return &list;
+        context->set(
+            uv::LoopContext::INCOMING_MESSAGE_LIST,
+            list,
+            uv::destroy<IncomingMessageList>);
+    }
+    return static_cast<IncomingMessageList*>(list);
 }
 
 }  // namespace http
@@ -4,16 +4,17 @@
 #define LIBNODE_DETAIL_HTTP_OUTGOING_MESSAGE_H_
 
 #include <libnode/http/agent.h>
+#include <libnode/http/header_template.h>
 #include <libnode/http/status.h>
 #include <libnode/http/client_request.h>
+#include <libnode/buffer_list.h>
 #include <libnode/debug_print.h>
-#include <libnode/detail/http/parser.h>
+#include <libnode/detail/http/parser_list.h>
+#include <libnode/detail/http/header_writer.h>
 #include <libnode/detail/http/client_response.h>
 
 #include <libj/js_date.h>
-#include <libj/typed_linked_list.h>
 #include <libj/typed_value_holder.h>
-#include <libj/detail/to_string.h>
 
 #include <assert.h>
 #include <stdio.h>
@@ -39,7 +40,7 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
     virtual Boolean write(const Value& chunk, Buffer::Encoding enc) {
         LIBJ_STATIC_SYMBOL_DEF(symCRLF, "\r\n");
 
-        if (!header_) {
+        if (!hasFlag(HEADER_STORED)) {
             implicitHeader();
         }
 
@@ -58,32 +59,27 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         }
 
         if (hasFlag(CHUNKED_ENCODING)) {
-            if (str) {
-                Size len = Buffer::byteLength(str, enc);
-                StringBuilder::Ptr sb = StringBuilder::create();
-                appendHex(sb, len);
-                sb->appendStr(LIBJ_U("\r\n"));
-                sb->appendStr(str);
-                sb->appendStr(LIBJ_U("\r\n"));
-                return send(sb->toString(), enc);
-            } else {
-                Size len = buf->length();
-                StringBuilder::Ptr sb = StringBuilder::create();
-                appendHex(sb, len);
-                sb->appendStr(LIBJ_U("\r\n"));
-                send(sb->toString());
-                send(buf);
-                return send(symCRLF);
-            }
+            if (str) buf = net::Socket::toBuffer(str, enc);
+
+            // size, payload and CRLF go out in a single write
+            net::Socket::Ptr socket = socket_;
+            if (socket) socket->cork();
+            send(chunkSize(buf->length()));
+            send(buf);
+            Boolean ret = send(symCRLF);
+            if (socket) socket->uncork();
+            return ret;
         } else {
             return send(chunk, enc);
         }
     }
 
     virtual Boolean end(const Value& data, Buffer::Encoding enc) {
+        LIBJ_STATIC_SYMBOL_DEF(symLastChunk, "0\r\n\r\n");
+
         if (hasFlag(FINISHED)) return false;
 
-        if (!header_) {
+        if (!hasFlag(HEADER_STORED)) {
             implicitHeader();
         }
 
@@ -95,36 +91,44 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         }
 
         String::CPtr str = toCPtr<String>(d);
+        Buffer::CPtr buf = toCPtr<Buffer>(d);
         Boolean hot =
             !hasFlag(HEADER_SENT) &&
-            str &&
-            !str->isEmpty() &&
+            ((str && !str->isEmpty()) || (buf && buf->length())) &&
             output_->isEmpty() &&
             socket_ &&
             socket_->writable() &&
             socket_->httpMessage() == this;
 
+        net::Socket::Ptr socket = socket_;
+        if (socket) socket->cork();
+
         Boolean ret;
-        if (hot) {
+        if (hot && str) {
+            // the header and the body go out in a single buffer
             if (hasFlag(CHUNKED_ENCODING)) {
                 Size len = Buffer::byteLength(str, enc);
-                appendHex(resBuf_, len);
-                resBuf_->appendStr(LIBJ_U("\r\n"));
-                resBuf_->appendStr(str);
-                resBuf_->appendStr(LIBJ_U("\r\n0\r\n"));
-                resBuf_->appendStr(trailer_);
-                resBuf_->appendStr(LIBJ_U("\r\n"));
+                writer_.appendHex(len);
+                writer_.appendCRLF();
+                writer_.append(str, enc);
+                writer_.appendLiteral("\r\n0\r\n");
+                writer_.append(trailer_);
+                writer_.appendCRLF();
             } else {
-                resBuf_->appendStr(str);
+                writer_.append(str, enc);
             }
-            ret = socket_->write(resBuf_, enc);
+            ret = socket_->write(writer_.toBuffer());
             setFlag(HEADER_SENT);
+        } else if (hot) {
+            ret = sendWithBody(buf);
         } else if (!d.isUndefined()) {
             ret = write(d, enc);
         }
 
         if (!hot) {
-            if (hasFlag(CHUNKED_ENCODING)) {
+            if (hasFlag(CHUNKED_ENCODING) && trailer_->isEmpty()) {
+                ret = send(symLastChunk);
+            } else if (hasFlag(CHUNKED_ENCODING)) {
                 StringBuilder::Ptr chunk = StringBuilder::create();
                 chunk->appendStr(LIBJ_U("0\r\n"));
                 chunk->appendStr(trailer_);
@@ -135,6 +139,8 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
             }
         }
 
+        if (socket) socket->uncork();
+
         setFlag(FINISHED);
         if (output_->isEmpty() && socket_->httpMessage() == this) {
             finish();
@@ -156,16 +162,18 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
     }
 
     String::CPtr getHeader(String::CPtr name) const {
-        if (name) {
-            return headers_->getCPtr<String>(
-                scanHeaderField<Char>(name->data(), name->length()));
+        if (!name) return String::null();
+
+        String::CPtr key = scanHeaderField<Char>(name->data(), name->length());
+        if (headers_->containsKey(key) || !headerTemplate_) {
+            return headers_->getCPtr<String>(key);
         } else {
-            return String::null();
+            return toCPtr<String>(headerTemplate_->get(key));
         }
     }
 
     Boolean setHeader(String::CPtr name, String::CPtr value) {
-        if (header_) return false;
+        if (hasFlag(HEADER_STORED)) return false;
         if (!name || !value) return false;
 
         String::CPtr key = scanHeaderField<Char>(name->data(), name->length());
@@ -175,7 +183,7 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
     }
 
     Boolean removeHeader(String::CPtr name) {
-        if (header_) return false;
+        if (hasFlag(HEADER_STORED)) return false;
         if (!name) return false;
 
         String::CPtr key = scanHeaderField<Char>(name->data(), name->length());
@@ -184,6 +192,13 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         return true;
     }
 
+    Boolean setHeaderTemplate(node::http::HeaderTemplate::CPtr tmpl) {
+        if (hasFlag(HEADER_STORED)) return false;
+
+        headerTemplate_ = tmpl;
+        return true;
+    }
+
     Boolean addTrailers(libj::JsObject::CPtr headers) {
         if (!headers) return false;
 
@@ -217,8 +232,6 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         String::CPtr reasonPhrase = String::null(),
         libj::JsObject::CPtr obj = libj::JsObject::null()) {
         statusCode_ = statusCode;
-        node::http::Status::CPtr status =
-            node::http::Status::create(statusCode, reasonPhrase);
 
         libj::JsObject::CPtr headers;
         Boolean empty = headers_->isEmpty();
@@ -238,14 +251,8 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
             headers = obj;
         }
 
-        assert(!resBuf_ || !resBuf_->length());
-        StringBuilder::Ptr statusLine =
-            resBuf_ ? resBuf_ : StringBuilder::create();
-        statusLine->appendStr(LIBJ_U("HTTP/1.1 "));
-        statusLine->append(status->code());
-        statusLine->appendChar(' ');
-        statusLine->appendStr(status->message());
-        statusLine->appendStr(LIBJ_U("\r\n"));
+        writer_.clear();
+        writer_.appendStatusLine(statusCode, reasonPhrase);
 
         if (statusCode == 204 || statusCode == 304 ||
             (statusCode >= 100 && statusCode < 200)) {
@@ -256,11 +263,11 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
             unsetFlag(SHOULD_KEEP_ALIVE);
         }
 
-        storeHeader(statusLine, headers);
+        storeHeader(headers);
     }
 
     Boolean headersSent() const {
-        return !!header_;
+        return hasFlag(HEADER_STORED);
     }
 
     Boolean sendDate() const {
@@ -353,17 +360,20 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
     }
 
  private:
-    static void appendHex(StringBuilder::Ptr sb, Size n) {
-        const Size kLen = sizeof(Size) * 2;
-        Char buf[kLen];
-        sb->appendStr(libj::detail::unsignedToString<Size>(n, buf, kLen, 16));
+    static Buffer::CPtr chunkSize(Size len) {
+        char buf[sizeof(Size) * 2 + 2];
+        char* end = buf + sizeof(buf);
+        end[-2] = '\r';
+        end[-1] = '\n';
+        char* p = HeaderWriter::formatHex(len, end - 2);
+        return Buffer::create(p, end - p);
     }
 
     static JsArray::Ptr freeParser(Parser* parser, OutgoingMessage* req) {
         assert(parser);
         assert(!req || !req->parser_ || req->parser_ == parser);
         JsArray::Ptr keeper = parser->free();
-        delete parser;
+        parserList()->free(parser);
         if (req) {
             req->parser_ = NULL;
         }
@@ -376,29 +386,42 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
 
     typedef TypedValueHolder<String::CPtr> DateCache;
 
-    static String::CPtr utcDate() {
-        static DateCache::Ptr cache = DateCache::null();
-        static JsFunction::Ptr clearCache = JsFunction::null();
+    // the cache is per loop as it is cleared by a timer of the loop
+    struct DateCacheHolder {
+        DateCache::Ptr cache;
+        JsFunction::Ptr clearCache;
+    };
 
-        if (!cache) {
-            assert(!clearCache);
-            cache = DateCache::create(String::null());
-            clearCache = JsFunction::Ptr(new ClearDateCache(cache));
+    static String::CPtr utcDate() {
+        uv::LoopContext* context = uv::loopContext();
+        DateCacheHolder* holder = static_cast<DateCacheHolder*>(
+            context->get(uv::LoopContext::DATE_CACHE));
+
+        if (!holder) {
+            holder = new DateCacheHolder();
+            holder->cache = DateCache::create(String::null());
+            holder->clearCache =
+                JsFunction::Ptr(new ClearDateCache(holder->cache));
+            context->set(
+                uv::LoopContext::DATE_CACHE,
+                holder,
+                uv::destroy<DateCacheHolder>);
 
             LIBJ_DEBUG_PRINT(
                 "static: DateCache %p",
-                LIBJ_DEBUG_OBJECT_PTR(cache));
+                LIBJ_DEBUG_OBJECT_PTR(holder->cache));
             LIBJ_DEBUG_PRINT(
                 "static: ClearDateCache %p",
-                LIBJ_DEBUG_OBJECT_PTR(clearCache));
+                LIBJ_DEBUG_OBJECT_PTR(holder->clearCache));
         }
 
+        DateCache::Ptr cache = holder->cache;
         if (!cache->getTyped()) {
             LIBNODE_DEBUG_PRINT("set DateCache");
             JsDate::CPtr date = JsDate::create();
             cache->setTyped(date->toUTCString());
             node::setTimeout(
-                clearCache,
+                holder->clearCache,
                 1000 - date->getMilliseconds());
         }
         return cache->getTyped();
@@ -408,19 +431,42 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         if (hasFlag(HEADER_SENT)) {
             return writeRaw(data, enc);
         } else {
-            assert(header_);
+            assert(hasFlag(HEADER_STORED));
             setFlag(HEADER_SENT);
             String::CPtr str = toCPtr<String>(data);
             if (str) {
-                return writeRaw(header_->concat(str), enc);
+                writer_.append(str, enc);
+                return writeRaw(writer_.toBuffer(), Buffer::NONE);
             } else {
-                output_->unshift(header_);
-                outputEncodings_->unshiftTyped(Buffer::UTF8);
+                output_->prepend(writer_.toBuffer());
                 return writeRaw(data, enc);
             }
         }
     }
 
+    // the header, the framing and buf go out in a single vectored write,
+    // and buf is not copied
+    Boolean sendWithBody(Buffer::CPtr buf) {
+        JsArray::Ptr chunks = JsArray::create();
+        if (hasFlag(CHUNKED_ENCODING)) {
+            writer_.appendHex(buf->length());
+            writer_.appendCRLF();
+            chunks->push(writer_.toBuffer());
+            chunks->push(buf);
+
+            writer_.clear();
+            writer_.appendLiteral("\r\n0\r\n");
+            writer_.append(trailer_);
+            writer_.appendCRLF();
+            chunks->push(writer_.toBuffer());
+        } else {
+            chunks->push(writer_.toBuffer());
+            chunks->push(buf);
+        }
+        setFlag(HEADER_SENT);
+        return socket_->writev(chunks);
+    }
+
     Boolean writeRaw(const Value& data, Buffer::Encoding enc) {
         String::CPtr str = toCPtr<String>(data);
         if (str && str->isEmpty()) return true;
@@ -433,71 +479,62 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         if (socket_ &&
             socket_->httpMessage() == this &&
             socket_->writable()) {
-            while (output_->length()) {
-                if (!socket_->writable()) {
-                    buffer(data, enc);
-                    return false;
-                }
-                Value c = output_->shift();
-                Buffer::Encoding e = outputEncodings_->shiftTyped();
-                socket_->write(c, e);
+            if (output_->isEmpty()) {
+                return socket_->write(data, enc);
             }
-            return socket_->write(data, enc);
+
+            buffer(data, enc);
+            return writeOutput();
         } else {
             buffer(data, enc);
             return false;
         }
     }
 
-    Boolean buffer(const Value& data, Buffer::Encoding enc) {
-        String::CPtr str = toCPtr<String>(data);
-        if (str && str->isEmpty()) return true;
-
-        Buffer::CPtr buf = toCPtr<Buffer>(data);
-        if (buf && !buf->length()) return true;
-
-        assert(str || buf);
-
-        Size length = output_->length();
-
-        if (!length || !str) {
-            output_->push(data);
-            outputEncodings_->pushTyped(enc);
-            return false;
+    // the queued buffers go out in a single vectored write,
+    // and are not copied
+    Boolean writeOutput() {
+        JsArray::Ptr chunks = JsArray::create();
+        while (!output_->isEmpty()) {
+            chunks->push(output_->shift());
         }
+        return socket_->writev(chunks);
+    }
 
-        Buffer::Encoding lastEnc = outputEncodings_->getTyped(length - 1);
-        Value lastData = output_->get(length - 1);
+    Boolean buffer(const Value& data, Buffer::Encoding enc) {
+        output_->append(net::Socket::toBuffer(data, enc));
+        return false;
+    }
 
-        if ((enc != Buffer::NONE && lastEnc == enc) ||
-            (enc == Buffer::NONE && data.type() == lastData.type())) {
-            if (str) {
-                output_->set(
-                    length - 1,
-                    toCPtr<String>(lastData)->concat(str));
-            } else {
-                output_->set(
-                    length -1,
-                    toCPtr<Buffer>(lastData)->concat(buf));
+    // a header of this message replaces the template lines of its name
+    void storeHeaderTemplate(libj::JsObject::CPtr headers) {
+        libj::JsObject::Ptr overridden = libj::JsObject::null();
+        if (headers) {
+            typedef libj::JsObject::Entry Entry;
+            TypedSet<Entry::CPtr>::CPtr entrys = headers->entrySet();
+            TypedIterator<Entry::CPtr>::Ptr itr = entrys->iteratorTyped();
+            while (itr->hasNext()) {
+                String::CPtr name = toCPtr<String>(itr->nextTyped()->getKey());
+                if (!headerTemplate_->has(name)) continue;
+
+                if (!overridden) overridden = libj::JsObject::create();
+                overridden->put(
+                    scanHeaderField<Char>(name->data(), name->length()),
+                    true);
             }
         }
 
-        output_->push(data);
-        outputEncodings_->pushTyped(enc);
-        return false;
+        writer_.append(headerTemplate_->toBuffer(overridden));
     }
 
-    void store(
-        StringBuilder::Ptr messageHeader,
-        String::CPtr field,
-        const Value& value) {
+    void store(String::CPtr field, const Value& value) {
         LIBJ_STATIC_SYMBOL_DEF(symClose,   "close");
         LIBJ_STATIC_SYMBOL_DEF(symChunked, "chunked");
 
-        messageHeader->appendStr(field);
-        messageHeader->appendStr(LIBJ_U(": "));
-        messageHeader->append(value);
-        messageHeader->appendStr(LIBJ_U("\r\n"));
+        writer_.append(field);
+        writer_.appendLiteral(": ");
+        writer_.appendValue(value);
+        writer_.appendCRLF();
 
         String::CPtr lowerField =
             scanHeaderField<Char>(field->data(), field->length());
@@ -522,16 +559,17 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         }
     }
 
-    void storeHeader(
-        StringBuilder::Ptr firstLine,
-        libj::JsObject::CPtr headers) {
+    // the first line is already in writer_
+    void storeHeader(libj::JsObject::CPtr headers) {
         unsetFlag(SENT_CONNECTION_HEADER);
         unsetFlag(SENT_CONTENT_LENGTH_HEADER);
         unsetFlag(SENT_TRANSFER_ENCODING_HEADER);
         unsetFlag(SENT_DATE_HEADER);
         unsetFlag(SENT_EXPECT_HEADER);
 
-        StringBuilder::Ptr messageHeader = firstLine;
+        if (headerTemplate_) {
+            storeHeaderTemplate(headers);
+        }
 
         if (headers) {
             typedef libj::JsObject::Entry Entry;
@@ -546,18 +584,18 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
                 if (ary) {
                     Size len = ary->length();
                     for (Size i = 0; i < len; i++) {
-                        store(messageHeader, field, ary->get(i));
+                        store(field, ary->get(i));
                     }
                 } else {
-                    store(messageHeader, field, value);
+                    store(field, value);
                 }
             }
         }
 
         if (hasFlag(SEND_DATE) && !hasFlag(SENT_DATE_HEADER)) {
-            messageHeader->appendStr(LIBJ_U("Date: "));
-            messageHeader->append(utcDate());
-            messageHeader->appendStr(LIBJ_U("\r\n"));
+            writer_.appendLiteral("Date: ");
+            writer_.append(utcDate());
+            writer_.appendCRLF();
         }
 
         if (!hasFlag(SENT_CONNECTION_HEADER)) {
@@ -566,24 +604,19 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
                 (hasFlag(SENT_CONTENT_LENGTH_HEADER) ||
                  hasFlag(USE_CHUNKED_ENCODING_BY_DEFAULT) ||
                  agent_);
-            messageHeader->appendStr(node::http::HEADER_CONNECTION);
-            messageHeader->appendStr(LIBJ_U(": "));
             if (shouldSendKeepAlive) {
-                messageHeader->appendStr(LIBJ_U("keep-alive"));
+                writer_.appendLiteral("Connection: keep-alive\r\n");
             } else {
                 setFlag(LAST);
-                messageHeader->appendStr(LIBJ_U("close"));
+                writer_.appendLiteral("Connection: close\r\n");
             }
-            messageHeader->appendStr(LIBJ_U("\r\n"));
         }
 
         if (!hasFlag(SENT_CONTENT_LENGTH_HEADER) &&
             !hasFlag(SENT_TRANSFER_ENCODING_HEADER)) {
             if (hasFlag(HAS_BODY)) {
                 if (hasFlag(USE_CHUNKED_ENCODING_BY_DEFAULT)) {
-                    messageHeader->appendStr(
-                        node::http::HEADER_TRANSFER_ENCODING);
-                    messageHeader->appendStr(LIBJ_U(": chunked\r\n"));
+                    writer_.appendLiteral("Transfer-Encoding: chunked\r\n");
                     setFlag(CHUNKED_ENCODING);
                 } else {
                     setFlag(LAST);
@@ -593,16 +626,15 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
             }
         }
 
-        messageHeader->appendStr(LIBJ_U("\r\n"));
-        resBuf_ = messageHeader;
-        header_ = messageHeader->toString();
+        writer_.appendCRLF();
+        setFlag(HEADER_STORED);
         unsetFlag(HEADER_SENT);
 
         if (hasFlag(SENT_EXPECT_HEADER)) send(String::create());
     }
 
     libj::JsObject::Ptr renderHeaders() {
-        if (header_) return libj::JsObject::null();
+        if (hasFlag(HEADER_STORED)) return libj::JsObject::null();
         if (headers_->isEmpty()) return libj::JsObject::create();
 
         libj::JsObject::Ptr headers = libj::JsObject::create();
@@ -628,12 +660,10 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         if (!socket_) return;
 
         Boolean ret = false;
-        while (output_->length()) {
+        if (!output_->isEmpty()) {
             if (!socket_->writable()) return;
 
-            Value data = output_->shift();
-            Buffer::Encoding enc = outputEncodings_->shiftTyped();
-            ret = socket_->write(data, enc);
+            ret = writeOutput();
         }
 
         if (hasFlag(FINISHED)) {
@@ -648,12 +678,12 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
             writeHead(statusCode_);
         } else {
             assert(method_ && path_);
-            StringBuilder::Ptr firstLine = StringBuilder::create();
-            firstLine->appendStr(method_);
-            firstLine->appendChar(' ');
-            firstLine->appendStr(path_);
-            firstLine->appendStr(LIBJ_U(" HTTP/1.1\r\n"));
-            storeHeader(firstLine, renderHeaders());
+            writer_.clear();
+            writer_.append(method_);
+            writer_.append(' ');
+            writer_.append(path_);
+            writer_.appendLiteral(" HTTP/1.1\r\n");
+            storeHeader(renderHeaders());
         }
     }
 
@@ -673,13 +703,12 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         statusCode_ = node::http::Status::OK;
         method_ = String::null();
         path_ = String::null();
-        header_ = String::null();
         trailer_ = String::create();
-        if (resBuf_) resBuf_->clear();
+        writer_.clear();
+        headerTemplate_ = node::http::HeaderTemplate::null();
         headers_->clear();
         headerNames_->clear();
         output_->clear();
-        outputEncodings_->clear();
         parser_ = NULL;
         agent_ = node::http::Agent::null();
         socketPath_ = String::null();
@@ -1016,7 +1045,7 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
                 freeParser(parser, self_);
             }
 
-            parser = new Parser(HTTP_RESPONSE, socket_);
+            parser = allocParser(HTTP_RESPONSE, socket_);
             self_->socket_ = socket_;
             self_->parser_ = parser;
 
@@ -1210,23 +1239,21 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         SENT_TRANSFER_ENCODING_HEADER   = 1 << 16,
         SENT_DATE_HEADER                = 1 << 17,
         SENT_EXPECT_HEADER              = 1 << 18,
-        UNUSED                          = 1 << 19,
+        HEADER_STORED                   = 1 << 19,
+        UNUSED                          = 1 << 20,
     };
 
  private:
-    typedef TypedLinkedList<Buffer::Encoding> EncodingList;
-
     net::Socket::Ptr socket_;
     Int statusCode_;
     String::CPtr method_;
     String::CPtr path_;
-    String::CPtr header_;
     String::CPtr trailer_;
-    StringBuilder::Ptr resBuf_;
+    HeaderWriter writer_;
+    node::http::HeaderTemplate::CPtr headerTemplate_;
     libj::JsObject::Ptr headers_;
     libj::JsObject::Ptr headerNames_;
-    LinkedList::Ptr output_;
-    EncodingList::Ptr outputEncodings_;
+    BufferList::Ptr output_;
     Parser* parser_;
     node::http::Agent::Ptr agent_;
     String::CPtr socketPath_;
@@ -1240,13 +1267,12 @@ class OutgoingMessage : public events::EventEmitter<stream::Writable> {
         , statusCode_(node::http::Status::OK)
         , method_(String::null())
         , path_(String::null())
-        , header_(String::null())
         , trailer_(String::create())
-        , resBuf_(StringBuilder::null())
+        , writer_()
+        , headerTemplate_(node::http::HeaderTemplate::null())
         , headers_(libj::JsObject::create())
         , headerNames_(libj::JsObject::create())
-        , output_(LinkedList::create())
-        , outputEncodings_(EncodingList::create())
+        , output_(BufferList::create())
         , parser_(NULL)
         , agent_(node::http::Agent::null())
         , socketPath_(String::null())
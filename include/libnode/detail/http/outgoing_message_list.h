@@ -1,9 +1,10 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_OUTGOING_MESSAGE_LIST_H_
 #define LIBNODE_DETAIL_HTTP_OUTGOING_MESSAGE_LIST_H_
 
 #include <libnode/detail/free_list.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/http/outgoing_message.h>
 
 namespace libj {
@@ -11,13 +12,23 @@ namespace node {
 namespace detail {
 namespace http {
 
-inline FreeList<OutgoingMessage::Ptr>* outgoingMessageList() {
+typedef FreeList<OutgoingMessage::Ptr> OutgoingMessageList;
+
+inline OutgoingMessageList* outgoingMessageList() {
+    uv::LoopContext* context = uv::loopContext();
+    void* list = context->get(uv::LoopContext::OUTGOING_MESSAGE_LIST);
+    if (!list) {
 #ifdef LIBJ_USE_SP
-    static FreeList<OutgoingMessage::Ptr> list(100);
+        list = new OutgoingMessageList(100);
 #else
-    static FreeList<OutgoingMessage::Ptr> list(0);
+        list = new OutgoingMessageList(0);
 #endif
-    return &list;
+        context->set(
+            uv::LoopContext::OUTGOING_MESSAGE_LIST,
+            list,
+            uv::destroy<OutgoingMessageList>);
+    }
+    return static_cast<OutgoingMessageList*>(list);
 }
 
 }  // namespace http
@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_HTTP_PARSER_H_
 #define LIBNODE_DETAIL_HTTP_PARSER_H_
@@ -21,6 +21,7 @@ namespace http {
 class Parser : public Flags {
  private:
     typedef TypedJsArray<String::CPtr> StringArray;
+    typedef TypedJsArray<Buffer::CPtr> BufferArray;
 
  public:
     Parser(
@@ -31,6 +32,9 @@ class Parser : public Flags {
         , method_(String::null())
         , fields_(StringArray::create())
         , values_(StringArray::create())
+        , rawFields_(BufferArray::create())
+        , rawValues_(BufferArray::create())
+        , buffer_(Buffer::null())
         , maxHeadersCount_(maxHeadersCount)
         , socket_(sock)
         , incoming_(IncomingMessage::null())
@@ -53,13 +57,34 @@ class Parser : public Flags {
         settings_ = &settings;
     }
 
+    // prepares a freed parser for a new connection
+    void reinit(
+        enum http_parser_type type,
+        net::Socket::Ptr sock,
+        Size maxHeadersCount = 0) {
+        assert(!socket_);
+        http_parser_init(&parser_, type);
+        parser_.data = this;
+        url_ = String::null();
+        method_ = String::null();
+        fields_->clear();
+        values_->clear();
+        rawFields_->clear();
+        rawValues_->clear();
+        maxHeadersCount_ = maxHeadersCount;
+        socket_ = sock;
+        unsetAllFlags();
+    }
+
     Int execute(Buffer::CPtr buf) {
         size_t len = buf->length();
+        buffer_ = buf;
         size_t numParsed = http_parser_execute(
                                 &parser_,
                                 settings_,
                                 static_cast<const char*>(buf->data()),
                                 len);
+        buffer_ = Buffer::null();
         if (!parser_.upgrade && numParsed != len) {
             return -1;
         } else {
@@ -79,6 +104,8 @@ class Parser : public Flags {
     JsArray::Ptr free() {
         fields_->clear();
         values_->clear();
+        rawFields_->clear();
+        rawValues_->clear();
 
         JsArray::Ptr keeper = JsArray::create();
         if (socket_) {
@@ -101,6 +128,20 @@ class Parser : public Flags {
         onIncoming_ = onIncoming;
     }
 
+    // header lines are kept as slices of the parsed buffers,
+    // and decoded only when IncomingMessage needs them
+    Boolean lazyHeaders() const {
+        return hasFlag(LAZY_HEADERS);
+    }
+
+    void setLazyHeaders(Boolean lazy) {
+        if (lazy) {
+            setFlag(LAZY_HEADERS);
+        } else {
+            unsetFlag(LAZY_HEADERS);
+        }
+    }
+
  private:
     static String::CPtr concat(String::CPtr s, const char* at, size_t len) {
         if (s) {
@@ -110,11 +151,25 @@ class Parser : public Flags {
         }
     }
 
+    // a fragment split across two reads is copied into a new buffer
+    Buffer::CPtr appendSlice(Buffer::CPtr b, const char* at, size_t len) {
+        assert(buffer_);
+        Size start = at - static_cast<const char*>(buffer_->data());
+        Buffer::CPtr slice = buffer_->slice(start, start + len);
+        if (b) {
+            return b->concat(slice);
+        } else {
+            return slice;
+        }
+    }
+
     static int onMessageBegin(http_parser* parser) {
         Parser* self = static_cast<Parser*>(parser->data);
         self->url_ = String::null();
         self->fields_->clear();
         self->values_->clear();
+        self->rawFields_->clear();
+        self->rawValues_->clear();
         return 0;
     }
 
@@ -127,6 +182,20 @@ class Parser : public Flags {
     static int onHeaderField(
         http_parser* parser, const char* at, size_t len) {
         Parser* self = static_cast<Parser*>(parser->data);
+        if (self->hasFlag(LAZY_HEADERS)) {
+            BufferArray::Ptr fields = self->rawFields_;
+            Size numFields = fields->size();
+            if (numFields == self->rawValues_->size()) {
+                fields->addTyped(
+                    self->appendSlice(Buffer::null(), at, len));
+            } else {
+                Buffer::CPtr field = fields->getTyped(numFields - 1);
+                field = self->appendSlice(field, at, len);
+                fields->setTyped(numFields - 1, field);
+            }
+            return 0;
+        }
+
         assert(self->fields_->size() == self->values_->size());
         self->fields_->addTyped(scanHeaderField<char>(at, len));
         return 0;
@@ -135,6 +204,20 @@ class Parser : public Flags {
     static int onHeaderValue(
         http_parser* parser, const char* at, size_t len) {
         Parser* self = static_cast<Parser*>(parser->data);
+        if (self->hasFlag(LAZY_HEADERS)) {
+            BufferArray::Ptr values = self->rawValues_;
+            Size numFields = self->rawFields_->size();
+            if (values->size() != numFields) {
+                values->addTyped(
+                    self->appendSlice(Buffer::null(), at, len));
+            } else {
+                Buffer::CPtr value = values->getTyped(numFields - 1);
+                value = self->appendSlice(value, at, len);
+                values->setTyped(numFields - 1, value);
+            }
+            return 0;
+        }
+
         StringArray::Ptr fields = self->fields_;
         StringArray::Ptr values = self->values_;
         Size numFields = fields->size();
@@ -145,7 +228,11 @@ class Parser : public Flags {
 
         assert(values->size() == numFields);
         String::CPtr value = values->getTyped(numFields - 1);
-        value = concat(value, at, len);
+        if (value) {
+            value = concat(value, at, len);
+        } else {
+            value = scanHeaderValue<char>(at, len);
+        }
         values->setTyped(numFields - 1, value);
         return 0;
     }
@@ -264,20 +351,8 @@ class Parser : public Flags {
             incoming_->setHttpVersion(httpVer->toString());
         }
 
-        Size n = values_->length();
-        assert(fields_->length() == n || fields_->length() == n + 1);
-        if (maxHeadersCount_) {
-            n = n < maxHeadersCount_ ? n : maxHeadersCount_;
-        }
-        for (Size i = 0; i < n; i++) {
-            incoming_->addHeaderLine(
-                fields_->getTyped(i),
-                values_->getTyped(i));
-        }
-
+        addHeaderLines();
         url_ = String::null();
-        fields_->clear();
-        values_->clear();
 
         if (method_) {
             incoming_->setMethod(method_);
@@ -300,36 +375,60 @@ class Parser : public Flags {
     }
 
     void onBody(Buffer::CPtr buf) {
-        LinkedList::Ptr pendings = incoming_->pendings();
+        BufferList::Ptr pendings = incoming_->pendings();
         if (incoming_->hasFlag(IncomingMessage::PAUSED) ||
-            pendings->length()) {
-            pendings->push(buf);
+            !pendings->isEmpty()) {
+            pendings->append(buf);
         } else {
             incoming_->emitData(buf);
         }
     }
 
-    void onMessageComplete() {
-        incoming_->setFlag(IncomingMessage::COMPLETE);
+    void addHeaderLines() {
+        Size n;
+        if (hasFlag(LAZY_HEADERS)) {
+            n = rawValues_->length();
+            assert(rawFields_->length() == n || rawFields_->length() == n + 1);
+        } else {
+            n = values_->length();
+            assert(fields_->length() == n || fields_->length() == n + 1);
+        }
+        if (maxHeadersCount_) {
+            n = n < maxHeadersCount_ ? n : maxHeadersCount_;
+        }
 
-        if (!fields_->isEmpty()) {
-            Size n = fields_->size();
-            assert(values_->size() == n);
+        if (hasFlag(LAZY_HEADERS)) {
+            for (Size i = 0; i < n; i++) {
+                incoming_->addRawHeaderLine(
+                    rawFields_->getTyped(i),
+                    rawValues_->getTyped(i));
+            }
+            rawFields_->clear();
+            rawValues_->clear();
+        } else {
             for (Size i = 0; i < n; i++) {
                 incoming_->addHeaderLine(
                     fields_->getTyped(i),
                     values_->getTyped(i));
             }
-            url_ = String::null();
             fields_->clear();
             values_->clear();
         }
+    }
+
+    void onMessageComplete() {
+        incoming_->setFlag(IncomingMessage::COMPLETE);
+
+        if (!fields_->isEmpty() || !rawFields_->isEmpty()) {
+            addHeaderLines();
+            url_ = String::null();
+        }
 
         if (!incoming_->hasFlag(IncomingMessage::UPGRADE)) {
-            LinkedList::Ptr pendings = incoming_->pendings();
+            BufferList::Ptr pendings = incoming_->pendings();
             if (incoming_->hasFlag(IncomingMessage::PAUSED) ||
-                pendings->length()) {
-                pendings->push(0);  // EOF
+                !pendings->isEmpty()) {
+                incoming_->setFlag(IncomingMessage::END_PENDING);
             } else {
                 incoming_->unsetFlag(IncomingMessage::READABLE);
                 incoming_->emitEnd();
@@ -346,6 +445,7 @@ class Parser : public Flags {
         HAVE_FLUSHED      = 1 << 0,
         UPGRADE           = 1 << 1,
         SHOULD_KEEP_ALIVE = 1 << 2,
+        LAZY_HEADERS      = 1 << 3,
     };
 
  private:
@@ -358,6 +458,9 @@ class Parser : public Flags {
     Int statusCode_;
     StringArray::Ptr fields_;
     StringArray::Ptr values_;
+    BufferArray::Ptr rawFields_;
+    BufferArray::Ptr rawValues_;
+    Buffer::CPtr buffer_;
     Size maxHeadersCount_;
     net::Socket::Ptr socket_;
     IncomingMessage::Ptr incoming_;
@@ -0,0 +1,48 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_HTTP_PARSER_LIST_H_
+#define LIBNODE_DETAIL_HTTP_PARSER_LIST_H_
+
+#include <libnode/detail/free_list.h>
+#include <libnode/detail/uv/loop.h>
+#include <libnode/detail/http/parser.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace http {
+
+typedef FreeList<Parser*> ParserList;
+
+inline ParserList* parserList() {
+    uv::LoopContext* context = uv::loopContext();
+    void* list = context->get(uv::LoopContext::PARSER_LIST);
+    if (!list) {
+        list = new ParserList(1000);
+        context->set(
+            uv::LoopContext::PARSER_LIST,
+            list,
+            uv::destroy<ParserList>);
+    }
+    return static_cast<ParserList*>(list);
+}
+
+inline Parser* allocParser(
+    enum http_parser_type type,
+    net::Socket::Ptr sock,
+    Size maxHeadersCount = 0) {
+    Parser* parser = parserList()->alloc();
+    if (parser) {
+        parser->reinit(type, sock, maxHeadersCount);
+    } else {
+        parser = new Parser(type, sock, maxHeadersCount);
+    }
+    return parser;
+}
+
+}  // namespace http
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_HTTP_PARSER_LIST_H_
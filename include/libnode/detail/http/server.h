@@ -7,7 +7,7 @@
 #include <libnode/http/server.h>
 #include <libnode/detail/net/server.h>
 #include <libnode/detail/net/socket.h>
-#include <libnode/detail/http/parser.h>
+#include <libnode/detail/http/parser_list.h>
 #include <libnode/detail/http/server_request.h>
 #include <libnode/detail/http/server_response.h>
 #include <libnode/detail/http/outgoing_message_list.h>
@@ -54,6 +54,14 @@ class Server : public net::Server<node::http::Server> {
         maxHeadersCount_ = max;
     }
 
+    virtual Boolean lazyHeaders() const {
+        return lazyHeaders_;
+    }
+
+    virtual void setLazyHeaders(Boolean lazy) {
+        lazyHeaders_ = lazy;
+    }
+
     virtual UInt timeout() const {
         return timeout_;
     }
@@ -71,7 +79,7 @@ class Server : public net::Server<node::http::Server> {
     static void freeParser(Parser* parser) {
         assert(parser);
         parser->free();
-        delete parser;
+        parserList()->free(parser);
     }
 
     static void abortIncoming(JsArray::Ptr incomings) {
@@ -316,6 +324,9 @@ class Server : public net::Server<node::http::Server> {
                 OutgoingMessage::Ptr out =
                     toPtr<OutgoingMessage>(outgoings_->shift());
                 if (out) {
+                    // the queued responses finished in this tick
+                    // are flushed together
+                    socket_->corkUntilNextTick();
                     out->assignSocket(out, socket_);
                 }
             }
@@ -358,6 +369,10 @@ class Server : public net::Server<node::http::Server> {
             IncomingMessage::Ptr in = args->getPtr<IncomingMessage>(0);
             Boolean shouldKeepAlive = to<Boolean>(args->get(1));
 
+            // the responses to the requests pipelined in a read
+            // go out in a single vectored write
+            socket_->corkUntilNextTick();
+
             incomings_->push(in);
 
             OutgoingMessage::Ptr out = OutgoingMessage::createInServer(in);
@@ -432,7 +447,9 @@ class Server : public net::Server<node::http::Server> {
                 maxHeadersCount = 2000 >> 1;
             }
 
-            Parser* parser = new Parser(HTTP_REQUEST, socket, maxHeadersCount);
+            Parser* parser =
+                allocParser(HTTP_REQUEST, socket, maxHeadersCount);
+            parser->setLazyHeaders(self_->lazyHeaders_);
             socket->setParser(parser);
 
             JsFunction::Ptr onClose(new SocketOnClose(parser, incomings));
@@ -473,10 +490,12 @@ class Server : public net::Server<node::http::Server> {
  private:
     Size maxHeadersCount_;
     UInt timeout_;
+    Boolean lazyHeaders_;
 
     Server()
         : maxHeadersCount_(0)
-        , timeout_(2 * 60 * 1000) {
+        , timeout_(2 * 60 * 1000)
+        , lazyHeaders_(false) {
         setFlag(ALLOW_HALF_OPEN);
     }
 };
@@ -0,0 +1,79 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_LOOP_H_
+#define LIBNODE_DETAIL_LOOP_H_
+
+#include <libnode/invoke.h>
+#include <libnode/detail/uv/loop.h>
+
+#include <libj/detail/js_object.h>
+
+#include <uv.h>
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+template<typename I>
+class Loop : public libj::detail::JsObject<I> {
+ public:
+    Loop()
+        : started_(false)
+        , joined_(false)
+        , setup_(JsFunction::null()) {
+        loop_.data = NULL;
+        Int r = uv_loop_init(&loop_);
+        assert(r == 0);
+    }
+
+    virtual ~Loop() {
+        join();
+        uv_loop_close(&loop_);
+    }
+
+    virtual Boolean start(JsFunction::Ptr setup) {
+        if (started_) return false;
+
+        setup_ = setup;
+        started_ = !uv_thread_create(&thread_, run, this);
+        return started_;
+    }
+
+    virtual Boolean join() {
+        if (!started_ || joined_) return false;
+
+        joined_ = !uv_thread_join(&thread_);
+        return joined_;
+    }
+
+ private:
+    static void run(void* arg) {
+        Loop* self = static_cast<Loop*>(arg);
+        uv_loop_t* loop = &self->loop_;
+        uv::setCurrentLoop(loop);
+        if (self->setup_) invoke(self->setup_);
+        self->setup_ = JsFunction::null();
+        uv_run(loop, UV_RUN_DEFAULT);
+
+        // releasing the per-loop state may close handles or
+        // bring the state back, so repeat until the loop is empty
+        while (loop->data) {
+            uv::closeLoopContext(loop);
+            uv_run(loop, UV_RUN_DEFAULT);
+        }
+        uv::setCurrentLoop(NULL);
+    }
+
+    uv_loop_t loop_;
+    uv_thread_t thread_;
+    Boolean started_;
+    Boolean joined_;
+    JsFunction::Ptr setup_;
+};
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_LOOP_H_
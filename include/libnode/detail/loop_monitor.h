@@ -0,0 +1,205 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_LOOP_MONITOR_H_
+#define LIBNODE_DETAIL_LOOP_MONITOR_H_
+
+#include <libnode/detail/histogram.h>
+#include <libnode/detail/uv/loop.h>
+
+#include <uv.h>
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+// samples the loop from its prepare and check phases.
+// the poll phase runs between them, and it is taken to be blocked
+// until the first callback in it, so only a few clock reads are made
+// per iteration and a callback costs an increment.
+class LoopMonitor {
+ public:
+    LoopMonitor(uv_loop_t* loop)
+        : active_(false)
+        , polling_(false)
+        , closing_(0)
+        , callbacks_(0)
+        , lastPrepare_(0)
+        , pollStart_(0)
+        , pollEnd_(0) {
+        Int r = uv_prepare_init(loop, &prepare_);
+        assert(r == 0);
+        r = uv_check_init(loop, &check_);
+        assert(r == 0);
+        prepare_.data = this;
+        check_.data = this;
+
+        // the monitor alone does not keep the loop alive
+        uv_unref(reinterpret_cast<uv_handle_t*>(&prepare_));
+        uv_unref(reinterpret_cast<uv_handle_t*>(&check_));
+    }
+
+    Boolean isActive() const {
+        return active_;
+    }
+
+    void start() {
+        if (active_) return;
+
+        active_ = true;
+        lastPrepare_ = 0;
+        polling_ = false;
+        used() = true;
+        uv_prepare_start(&prepare_, onPrepare);
+        uv_check_start(&check_, onCheck);
+    }
+
+    void stop() {
+        if (!active_) return;
+
+        active_ = false;
+        polling_ = false;
+        uv_prepare_stop(&prepare_);
+        uv_check_stop(&check_);
+    }
+
+    void reset() {
+        iterationTime_.reset();
+        pollTime_.reset();
+        timerDrift_.reset();
+        callbacksPerIteration_.reset();
+    }
+
+    void onCallback() {
+        if (!active_) return;
+
+        callbacks_++;
+        if (polling_ && !pollEnd_) pollEnd_ = uv_hrtime();
+    }
+
+    // deadline is in the loop time, in milliseconds
+    void onTimer(ULong deadline) {
+        if (!active_) return;
+
+        ULong now = uv_hrtime() / 1000;
+        deadline *= 1000;
+        timerDrift_.record(now > deadline ? now - deadline : 0);
+    }
+
+    // in microseconds
+    const Histogram& iterationTime() const {
+        return iterationTime_;
+    }
+
+    // in microseconds
+    const Histogram& pollTime() const {
+        return pollTime_;
+    }
+
+    // in microseconds
+    const Histogram& timerDrift() const {
+        return timerDrift_;
+    }
+
+    const Histogram& callbacksPerIteration() const {
+        return callbacksPerIteration_;
+    }
+
+    // true once a monitor has been started on any loop.
+    // it lets invoke() skip the lookup of the monitor otherwise.
+    static Boolean& used() {
+        static Boolean used = false;
+        return used;
+    }
+
+    // deletes this monitor once all the handles are closed
+    void close() {
+        stop();
+        closing_ = 2;
+        uv_close(reinterpret_cast<uv_handle_t*>(&prepare_), onClose);
+        uv_close(reinterpret_cast<uv_handle_t*>(&check_), onClose);
+    }
+
+    static void destroy(void* monitor) {
+        static_cast<LoopMonitor*>(monitor)->close();
+    }
+
+ private:
+    static void onPrepare(uv_prepare_t* handle) {
+        LoopMonitor* self = static_cast<LoopMonitor*>(handle->data);
+        ULong now = uv_hrtime();
+        if (self->lastPrepare_) {
+            self->iterationTime_.record((now - self->lastPrepare_) / 1000);
+            self->callbacksPerIteration_.record(self->callbacks_);
+        }
+        self->lastPrepare_ = now;
+        self->callbacks_ = 0;
+        self->polling_ = true;
+        self->pollStart_ = now;
+        self->pollEnd_ = 0;
+    }
+
+    static void onCheck(uv_check_t* handle) {
+        LoopMonitor* self = static_cast<LoopMonitor*>(handle->data);
+        if (!self->polling_) return;
+
+        ULong end = self->pollEnd_ ? self->pollEnd_ : uv_hrtime();
+        self->pollTime_.record((end - self->pollStart_) / 1000);
+        self->polling_ = false;
+    }
+
+    static void onClose(uv_handle_t* handle) {
+        LoopMonitor* self = static_cast<LoopMonitor*>(handle->data);
+        if (!--self->closing_) delete self;
+    }
+
+ private:
+    Boolean active_;
+    Boolean polling_;
+    Size closing_;
+    ULong callbacks_;
+    ULong lastPrepare_;
+    ULong pollStart_;
+    ULong pollEnd_;
+    uv_prepare_t prepare_;
+    uv_check_t check_;
+    Histogram iterationTime_;
+    Histogram pollTime_;
+    Histogram timerDrift_;
+    Histogram callbacksPerIteration_;
+};
+
+inline LoopMonitor* loopMonitor(
+    uv_loop_t* loop = uv::currentLoop(),
+    Boolean create = false) {
+    uv::LoopContext* context = uv::loopContext(loop);
+    void* monitor = context->get(uv::LoopContext::LOOP_MONITOR);
+    if (!monitor && create) {
+        monitor = new LoopMonitor(loop);
+        context->set(
+            uv::LoopContext::LOOP_MONITOR,
+            monitor,
+            LoopMonitor::destroy);
+    }
+    return static_cast<LoopMonitor*>(monitor);
+}
+
+inline void monitorCallback() {
+    if (!LoopMonitor::used()) return;
+
+    LoopMonitor* monitor = loopMonitor();
+    if (monitor) monitor->onCallback();
+}
+
+inline void monitorTimer(uv_loop_t* loop, ULong deadline) {
+    if (!LoopMonitor::used() || !loop->data) return;
+
+    LoopMonitor* monitor = loopMonitor(loop);
+    if (monitor) monitor->onTimer(deadline);
+}
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_LOOP_MONITOR_H_
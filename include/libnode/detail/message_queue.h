@@ -1,10 +1,11 @@
-// Copyright (c) 2013 Plenluno All rights reserved.
+// Copyright (c) 2013-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_MESSAGE_QUEUE_H_
 #define LIBNODE_DETAIL_MESSAGE_QUEUE_H_
 
 #include <libnode/config.h>
 #include <libnode/detail/events/event_emitter.h>
+#include <libnode/detail/uv/loop.h>
 
 #include <libj/concurrent_linked_queue.h>
 
@@ -34,7 +35,7 @@ class MessageQueue : public events::EventEmitter<I> {
             return false;
         } else {
             open_ = true;
-            return !uv_async_init(uv_default_loop(), &async_, receive);
+            return !uv_async_init(uv::currentLoop(), &async_, receive);
         }
     }
 
@@ -4,9 +4,12 @@
 #define LIBNODE_DETAIL_NET_SERVER_H_
 
 #include <libnode/config.h>
+#include <libnode/detail/tick_queue.h>
 #include <libnode/detail/net/socket.h>
+#include <libnode/detail/cluster/worker.h>
 
 #include <libj/string_builder.h>
+#include <libj/this.h>
 
 namespace libj {
 namespace node {
@@ -29,6 +32,11 @@ class Server : public events::EventEmitter<I> {
             Boolean allowHalfOpen = to<Boolean>(
                 options->get(node::net::OPTION_ALLOW_HALF_OPEN));
             if (allowHalfOpen) server->setFlag(ALLOW_HALF_OPEN);
+            Boolean reusePort = to<Boolean>(
+                options->get(node::net::OPTION_REUSE_PORT));
+            if (reusePort) server->setFlag(REUSE_PORT);
+            server->acceptBatch_ = to<Size>(
+                options->get(node::net::OPTION_ACCEPT_BATCH), 0);
         }
 
         if (listener) {
@@ -61,6 +69,49 @@ class Server : public events::EventEmitter<I> {
 
     virtual void setMaxConnections(Size max) {
         maxConnections_ = max;
+        updateAccept();
+    }
+
+    // accepting resumes when the connections drop to this after
+    // maxConnections is reached. 0 means 90% of maxConnections.
+    virtual Size lowConnections() const {
+        return lowConnections_;
+    }
+
+    virtual void setLowConnections(Size low) {
+        lowConnections_ = low;
+        updateAccept();
+    }
+
+    // the max number of connections accepted in a loop iteration.
+    // 0 means no limit.
+    virtual Size acceptBatch() const {
+        return acceptBatch_;
+    }
+
+    virtual void setAcceptBatch(Size batch) {
+        acceptBatch_ = batch;
+        updateAccept();
+    }
+
+    virtual Size accepted() const {
+        return accepted_;
+    }
+
+    virtual Size acceptPauses() const {
+        return acceptPauses_;
+    }
+
+    virtual Boolean reusePort() const {
+        return this->hasFlag(REUSE_PORT);
+    }
+
+    virtual void setReusePort(Boolean reuse) {
+        if (reuse) {
+            this->setFlag(REUSE_PORT);
+        } else {
+            this->unsetFlag(REUSE_PORT);
+        }
     }
 
     virtual Boolean listen(
@@ -68,7 +119,7 @@ class Server : public events::EventEmitter<I> {
         String::CPtr host = node::net::Server::IN_ADDR_ANY,
         Int backlog = 511,
         JsFunction::Ptr callback = JsFunction::null()) {
-        if (handle_) return false;
+        if (handle_ || this->hasFlag(QUERYING)) return false;
 
         if (callback) this->once(node::net::Server::EVENT_LISTENING, callback);
 
@@ -86,7 +137,7 @@ class Server : public events::EventEmitter<I> {
     virtual Boolean listen(
         String::CPtr path,
         JsFunction::Ptr callback = JsFunction::null()) {
-        if (handle_) return false;
+        if (handle_ || this->hasFlag(QUERYING)) return false;
 
         if (callback) this->once(node::net::Server::EVENT_LISTENING, callback);
 
@@ -95,6 +146,16 @@ class Server : public events::EventEmitter<I> {
 
     virtual Boolean close(
         JsFunction::Ptr callback = JsFunction::null()) {
+        if (this->hasFlag(QUERYING)) {
+            // the handle replied by the master is closed on arrival
+            this->unsetFlag(QUERYING);
+            if (callback) {
+                this->once(node::net::Server::EVENT_CLOSE, callback);
+            }
+            emitCloseIfDrained();
+            return true;
+        }
+
         if (!handle_) {
 #ifdef LIBNODE_REMOVE_LISTENER
             this->removeAllListeners();
@@ -124,13 +185,20 @@ class Server : public events::EventEmitter<I> {
     static const Int INVALID_FD = -1;
     static const Int INVALID_PORT = -1;
 
+    // with reusePort, every loop can listen on the same port
+    // and the kernel spreads the connections over them
     static uv::Stream* createServerHandle(
-        String::CPtr address, Int port, Int addressType, Int fd) {
+        String::CPtr address,
+        Int port,
+        Int addressType,
+        Int fd,
+        Boolean reusePort) {
+        uv_loop_t* loop = uv::currentLoop();
         uv::Stream* handle;
         if (fd >= 0) {
             uv_handle_type type = uv::Handle::guessHandleType(fd);
             if (type == UV_NAMED_PIPE) {
-                uv::Pipe* pipe = new uv::Pipe();
+                uv::Pipe* pipe = new uv::Pipe(false, loop);
                 pipe->open(fd);
                 // pipe->readable = true;
                 // pipe->writable = true;
@@ -140,13 +208,17 @@ class Server : public events::EventEmitter<I> {
             }
         } else if (addressType == PATH_TYPE) {
             assert(port == INVALID_PORT);
-            handle = new uv::Pipe();
+            handle = new uv::Pipe(false, loop);
         } else {
-            handle = new uv::Tcp();
+            handle = new uv::Tcp(loop);
         }
 
         int err = 0;
-        if (address) {
+        if (reusePort && addressType != PATH_TYPE) {
+            uv::Tcp* tcp = static_cast<uv::Tcp*>(handle);
+            err = tcp->reusePort(addressType == 6 ? AF_INET6 : AF_INET);
+        }
+        if (!err && address) {
             if (addressType == 6) {
                 uv::Tcp* tcp = static_cast<uv::Tcp*>(handle);
                 err = tcp->bind6(address, port);
@@ -174,8 +246,13 @@ class Server : public events::EventEmitter<I> {
         Int addressType,
         Int backlog = 511,
         Int fd = INVALID_FD) {
+        if (!handle_ && queryServer(address, port, addressType, backlog)) {
+            return true;
+        }
+
         if (!handle_) {
-            handle_ = createServerHandle(address, port, addressType, fd);
+            handle_ = createServerHandle(
+                address, port, addressType, fd, this->hasFlag(REUSE_PORT));
             if (!handle_) {
                 typename EmitError::Ptr emitError(
                     new EmitError(this, UV_EINVAL));
@@ -205,10 +282,85 @@ class Server : public events::EventEmitter<I> {
             connectionKey_ = key->toString();
             typename EmitListening::Ptr emitListening(new EmitListening(this));
             process::nextTick(emitListening);
+
+            // the channel to the master belongs to the default loop
+            if (addressType != PATH_TYPE &&
+                uv::currentLoop() == uv_default_loop()) {
+                cluster::Worker::Ptr worker = cluster::Worker::self();
+                if (worker) worker->listening(address, port, addressType);
+            }
+            return true;
+        }
+    }
+
+    // in a cluster worker, the master binds the address and
+    // sends the handle back, unless each worker binds it with reusePort
+    Boolean queryServer(
+        String::CPtr address,
+        Int port,
+        Int addressType,
+        Int backlog) {
+        if (addressType == PATH_TYPE ||
+            this->hasFlag(REUSE_PORT) ||
+            uv::currentLoop() != uv_default_loop()) {
+            return false;
+        }
+
+        cluster::Worker::Ptr worker = cluster::Worker::self();
+        if (!worker) return false;
+
+        typename OnServerHandle::Ptr onServerHandle(new OnServerHandle(
+            LIBJ_THIS_PTR(Server), address, port, addressType, backlog));
+        if (worker->queryServer(address, port, addressType, onServerHandle)) {
+            this->setFlag(QUERYING);
             return true;
+        } else {
+            return false;
         }
     }
 
+    Boolean isFull() const {
+        if (!maxConnections_) return false;
+
+        if (this->hasFlag(ACCEPT_FULL)) {
+            Size low = lowConnections_
+                ? lowConnections_
+                : maxConnections_ * 9 / 10;
+            if (low >= maxConnections_) low = maxConnections_ - 1;
+            return connections_ > low;
+        } else {
+            return connections_ >= maxConnections_;
+        }
+    }
+
+    // pauses accepting while full or after a batch in this iteration
+    void updateAccept() {
+        if (isFull()) {
+            this->setFlag(ACCEPT_FULL);
+        } else {
+            this->unsetFlag(ACCEPT_FULL);
+        }
+
+        if (!handle_) return;
+
+        Boolean pause =
+            this->hasFlag(ACCEPT_FULL) ||
+            (acceptBatch_ && acceptedInBatch_ >= acceptBatch_);
+        if (pause && !handle_->isAcceptPaused()) {
+            acceptPauses_++;
+            handle_->pauseAccept();
+        } else if (!pause && handle_->isAcceptPaused()) {
+            handle_->resumeAccept();
+        }
+    }
+
+    // the batch is over at the check phase of this iteration
+    void endAcceptBatchAtCheck() {
+        typename EndAcceptBatch::Ptr endAcceptBatch(
+            new EndAcceptBatch(LIBJ_THIS_PTR(Server)));
+        tickQueue()->pushImmediate(endAcceptBatch);
+    }
+
     void emitCloseIfDrained() {
         if (handle_ || connections_) return;
 
@@ -239,11 +391,10 @@ class Server : public events::EventEmitter<I> {
                 return err;
             }
 
-            if (self_->maxConnections_ &&
-                self_->connections_ >= self_->maxConnections_) {
-                clientHandle->close();
-                return Status::OK;
+            if (self_->acceptBatch_ && !self_->acceptedInBatch_++) {
+                self_->endAcceptBatchAtCheck();
             }
+            self_->accepted_++;
 
             Socket::Ptr socket = Socket::create(
                 clientHandle,
@@ -256,6 +407,7 @@ class Server : public events::EventEmitter<I> {
             self_->connections_++;
             JsFunction::Ptr removeConnection(new RemoveConnection(self_));
             socket->on(node::net::Server::EVENT_CLOSE, removeConnection);
+            self_->updateAccept();
 
             self_->emit(node::net::Server::EVENT_CONNECTION, socket);
             socket->emit(Socket::EVENT_CONNECT);
@@ -266,12 +418,61 @@ class Server : public events::EventEmitter<I> {
         Server* self_;
     };
 
+    class OnServerHandle : LIBJ_JS_FUNCTION_TEMPLATE(OnServerHandle)
+     public:
+        OnServerHandle(
+            typename Server::Ptr srv,
+            String::CPtr address,
+            Int port,
+            Int addressType,
+            Int backlog)
+            : self_(srv)
+            , address_(address)
+            , port_(port)
+            , addressType_(addressType)
+            , backlog_(backlog) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            Int err = to<Int>(args->get(0), UV_EINVAL);
+            uv::Stream* handle = NULL;
+            to<uv::Stream*>(args->get(1), &handle);
+
+            // the server was closed before the reply
+            if (!self_->hasFlag(QUERYING)) {
+                if (handle) handle->close();
+                return Status::OK;
+            }
+
+            self_->unsetFlag(QUERYING);
+            if (err || !handle || self_->handle_) {
+                if (handle) handle->close();
+                if (!err) err = UV_EINVAL;
+                self_->emit(
+                    node::net::Server::EVENT_ERROR,
+                    LIBNODE_UV_ERROR(err));
+                return Status::OK;
+            }
+
+            self_->handle_ = handle;
+            self_->listen(address_, port_, addressType_, backlog_);
+            return Status::OK;
+        }
+
+     private:
+        typename Server::Ptr self_;
+        String::CPtr address_;
+        Int port_;
+        Int addressType_;
+        Int backlog_;
+    };
+
     class RemoveConnection : LIBJ_JS_FUNCTION_TEMPLATE(RemoveConnection)
      public:
         RemoveConnection(Server* srv) : self_(srv) {}
 
         virtual Value operator()(JsArray::Ptr args) {
             self_->connections_--;
+            self_->updateAccept();
             self_->emitCloseIfDrained();
             return Status::OK;
         }
@@ -280,6 +481,20 @@ class Server : public events::EventEmitter<I> {
         Server* self_;
     };
 
+    class EndAcceptBatch : LIBJ_JS_FUNCTION_TEMPLATE(EndAcceptBatch)
+     public:
+        EndAcceptBatch(typename Server::Ptr srv) : self_(srv) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            self_->acceptedInBatch_ = 0;
+            self_->updateAccept();
+            return Status::OK;
+        }
+
+     private:
+        typename Server::Ptr self_;
+    };
+
     class EmitClose : LIBJ_JS_FUNCTION_TEMPLATE(EmitClose)
      public:
         EmitClose(Server* srv) : self_(srv) {}
@@ -347,12 +562,20 @@ class Server : public events::EventEmitter<I> {
     enum Flag {
         ALLOW_HALF_OPEN      = 1 << 0,
         HTTP_ALLOW_HALF_OPEN = 1 << 1,
+        REUSE_PORT           = 1 << 2,
+        ACCEPT_FULL          = 1 << 3,
+        QUERYING             = 1 << 4,
     };
 
  private:
     uv::Stream* handle_;
     Size connections_;
     Size maxConnections_;
+    Size lowConnections_;
+    Size acceptBatch_;
+    Size acceptedInBatch_;
+    Size accepted_;
+    Size acceptPauses_;
     String::CPtr pipeName_;
     String::CPtr connectionKey_;
 
@@ -361,6 +584,11 @@ class Server : public events::EventEmitter<I> {
         : handle_(NULL)
         , connections_(0)
         , maxConnections_(0)
+        , lowConnections_(0)
+        , acceptBatch_(0)
+        , acceptedInBatch_(0)
+        , accepted_(0)
+        , acceptPauses_(0)
         , pipeName_(String::null())
         , connectionKey_(String::null()) {}
 
@@ -10,6 +10,9 @@
 #include <libnode/string_decoder.h>
 #include <libnode/timer.h>
 #include <libnode/uv/error.h>
+#include <libnode/detail/stream_pipe.h>
+#include <libnode/detail/timer_list.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/stream_common.h>
 #include <libnode/detail/events/event_emitter.h>
 
@@ -36,6 +39,22 @@ namespace node {
 namespace detail {
 namespace net {
 
+typedef node::net::WriteStats WriteStats;
+
+inline WriteStats* writeStats() {
+    uv::LoopContext* context = uv::loopContext();
+    void* stats = context->get(uv::LoopContext::WRITE_STATS);
+    if (!stats) {
+        WriteStats init = {0, 0, 0, 0};
+        stats = new WriteStats(init);
+        context->set(
+            uv::LoopContext::WRITE_STATS,
+            stats,
+            uv::destroy<WriteStats>);
+    }
+    return static_cast<WriteStats*>(stats);
+}
+
 class Socket : public events::EventEmitter<node::net::Socket> {
  public:
     LIBJ_MUTABLE_DEFS(Socket, LIBNODE_NET_SOCKET);
@@ -47,13 +66,20 @@ class Socket : public events::EventEmitter<node::net::Socket> {
             Boolean allowHalfOpen =
                 to<Boolean>(options->get(OPTION_ALLOW_HALF_OPEN));
             uv_file fd;
-            if (to<uv_file>(options->get(OPTION_FD), &fd)) {
-                return create(fd, allowHalfOpen);
-            } else {
-                uv::Stream* handle =
-                    to<uv::Stream*>(options->get(OPTION_HANDLE));
-                return create(handle, allowHalfOpen);
+            Ptr sock = to<uv_file>(options->get(OPTION_FD), &fd)
+                ? create(fd, allowHalfOpen)
+                : create(
+                    to<uv::Stream*>(options->get(OPTION_HANDLE)),
+                    allowHalfOpen);
+
+            Int highWaterMark;
+            if (to<Int>(
+                    options->get(OPTION_HIGH_WATER_MARK),
+                    &highWaterMark) &&
+                highWaterMark >= 0) {
+                sock->setHighWaterMark(highWaterMark);
             }
+            return sock;
         } else {
             return create(static_cast<uv::Stream*>(NULL), false);
         }
@@ -101,6 +127,16 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         return handle_ && !hasFlag(CONNECTING) && !handle_->readStart();
     }
 
+    virtual Boolean pipe(
+        stream::Stream::Ptr dest,
+        JsObject::CPtr options = JsObject::null()) {
+        return pipeStream<stream::Duplex>(LIBJ_THIS_PTR(Socket), dest, options);
+    }
+
+    virtual Boolean unpipe(stream::Stream::CPtr dest = stream::Stream::null()) {
+        return unpipeStream<stream::Duplex>(LIBJ_THIS_PTR(Socket), dest);
+    }
+
     virtual Boolean write(
         const Value& data,
         Buffer::Encoding enc = Buffer::NONE) {
@@ -123,6 +159,7 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         }
 
         if (!data.isUndefined()) write(data, enc);
+        uncorkAll();
 
         if (!hasFlag(READABLE)) {
             return destroySoon();
@@ -145,6 +182,7 @@ class Socket : public events::EventEmitter<node::net::Socket> {
     virtual Boolean destroySoon() {
         if (hasFlag(DESTROYED)) return false;
 
+        uncorkAll();
         unsetFlag(WRITABLE);
         setFlag(DESTROY_SOON);
         if (pendingWriteReqs_) {
@@ -191,12 +229,64 @@ class Socket : public events::EventEmitter<node::net::Socket> {
     }
 
     virtual Size bytesWritten() const {
-        Size bytes = bytesDispatched_;
-        Size len = connectBufQueue_->length();
+        return bytesDispatched_ + connectQueueSize_ + corkQueueSize_;
+    }
+
+    virtual Size bufferSize() const {
+        Size size = connectQueueSize_ + corkQueueSize_;
+        if (handle_) size += handle_->writeQueueSize();
+        return size;
+    }
+
+    virtual Size highWaterMark() const {
+        return highWaterMark_;
+    }
+
+    virtual void setHighWaterMark(Size highWaterMark) {
+        highWaterMark_ = highWaterMark;
+    }
+
+    virtual Boolean writev(
+        JsArray::CPtr chunks,
+        JsFunction::Ptr cb = JsFunction::null()) {
+        if (!chunks) return false;
+
+        JsArray::Ptr bufs = JsArray::create();
+        Size len = chunks->length();
         for (Size i = 0; i < len; i++) {
-            bytes += connectBufQueue_->getCPtr<Buffer>(i)->length();
+            Buffer::CPtr buf = toBuffer(chunks->get(i), Buffer::NONE);
+            if (!buf) return false;
+            if (buf->length()) bufs->push(buf);
+        }
+
+        // nothing is queued, so no drain would follow a false
+        len = bufs->length();
+        if (!len) {
+            if (cb) process::nextTick(cb);
+            return belowHighWaterMark();
+        }
+
+        if (hasFlag(CONNECTING) || corked_) {
+            Boolean ret = false;
+            for (Size i = 0; i < len; i++) {
+                ret = write(
+                    bufs->get(i),
+                    i == len - 1 ? cb : JsFunction::null());
+            }
+            return ret;
+        }
+
+        return writeBuffers(bufs, cb);
+    }
+
+    virtual void cork() {
+        corked_++;
+    }
+
+    virtual void uncork() {
+        if (corked_ && !--corked_) {
+            flushCorked();
         }
-        return bytes;
     }
 
     virtual Boolean connect(
@@ -273,18 +363,7 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         const Value& data,
         Buffer::Encoding enc,
         JsFunction::Ptr cb) {
-        Buffer::CPtr buf;
-        if (data.is<String>()) {
-            String::CPtr str = toCPtr<String>(data);
-            if (enc == Buffer::NONE) enc = Buffer::UTF8;
-            buf = Buffer::create(str, enc);
-        } else if (data.is<StringBuilder>()) {
-            StringBuilder::CPtr sb = toCPtr<StringBuilder>(data);
-            if (enc == Buffer::NONE) enc = Buffer::UTF8;
-            buf = Buffer::create(sb, enc);
-        } else {
-            buf = toCPtr<Buffer>(data);
-        }
+        Buffer::CPtr buf = toBuffer(data, enc);
         if (!buf) return false;
 
         if (hasFlag(CONNECTING)) {
@@ -296,9 +375,22 @@ class Socket : public events::EventEmitter<node::net::Socket> {
             }
             connectBufQueue_->push(buf);
             connectCbQueue_->push(cb);
+            setFlag(NEED_DRAIN);
             return false;
         }
 
+        if (corked_) {
+            corkQueueSize_ += buf->length();
+            if (!corkBufQueue_) {
+                assert(!corkCbQueue_);
+                corkBufQueue_ = JsArray::create();
+                corkCbQueue_ = JsArray::create();
+            }
+            corkBufQueue_->push(buf);
+            if (cb) corkCbQueue_->push(cb);
+            return belowHighWaterMark();
+        }
+
         return writeBuffer(buf, cb);
     }
 
@@ -390,11 +482,20 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         httpMessage_ = msg;
     }
 
+    // corks the socket until the next tick,
+    // so the writes in this tick go out in a single vectored write
+    void corkUntilNextTick() {
+        if (hasFlag(TICK_CORKED) || !hasFlag(WRITABLE)) return;
+
+        setFlag(TICK_CORKED);
+        cork();
+        JsFunction::Ptr uncorkAfterTick(
+            new UncorkAfterTick(LIBJ_THIS_PTR(Socket)));
+        process::nextTick(uncorkAfterTick);
+    }
+
     void active() {
-        if (hasTimer()) {
-            finishTimer();
-            startTimer(timeout_);
-        }
+        timerLists()->active(&timer_);
     }
 
     void ref() {
@@ -407,7 +508,7 @@ class Socket : public events::EventEmitter<node::net::Socket> {
 
  private:
     static Ptr create(int fd, Boolean allowHalfOpen = false) {
-        uv::Pipe* pipe = new uv::Pipe();
+        uv::Pipe* pipe = new uv::Pipe(false, uv::currentLoop());
         pipe->open(fd);
 
         Socket* sock = new Socket();
@@ -432,6 +533,8 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         self->flags_ = 0;
         self->pendingWriteReqs_ = 0;
         self->connectQueueSize_ = 0;
+        self->corked_ = 0;
+        self->corkQueueSize_ = 0;
         self->bytesRead_ = 0;
         self->bytesDispatched_ = 0;
 
@@ -497,9 +600,10 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         Boolean pipe = !!path;
 
         if (hasFlag(DESTROYED) || !handle_) {
+            uv_loop_t* loop = uv::currentLoop();
             handle_ = pipe
-                ? reinterpret_cast<uv::Stream*>(new uv::Pipe())
-                : reinterpret_cast<uv::Stream*>(new uv::Tcp());
+                ? reinterpret_cast<uv::Stream*>(new uv::Pipe(false, loop))
+                : reinterpret_cast<uv::Stream*>(new uv::Tcp(loop));
             initSocketHandle(this);
         }
 
@@ -525,6 +629,57 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         }
     }
 
+    static Buffer::CPtr toBuffer(const Value& data, Buffer::Encoding enc) {
+        if (data.is<String>()) {
+            String::CPtr str = toCPtr<String>(data);
+            if (enc == Buffer::NONE) enc = Buffer::UTF8;
+            return Buffer::create(str, enc);
+        } else if (data.is<StringBuilder>()) {
+            StringBuilder::CPtr sb = toCPtr<StringBuilder>(data);
+            if (enc == Buffer::NONE) enc = Buffer::UTF8;
+            return Buffer::create(sb, enc);
+        } else {
+            return toCPtr<Buffer>(data);
+        }
+    }
+
+    void flushCorked() {
+        if (!corkBufQueue_) return;
+
+        JsArray::Ptr bufs = corkBufQueue_;
+        JsArray::Ptr cbs = corkCbQueue_;
+        corkQueueCleanUp();
+
+        JsFunction::Ptr cb;
+        switch (cbs->length()) {
+        case 0:
+            cb = JsFunction::null();
+            break;
+        case 1:
+            cb = cbs->getPtr<JsFunction>(0);
+            break;
+        default:
+            cb = JsFunction::Ptr(new InvokeCallbacks(cbs));
+        }
+        writeBuffers(bufs, cb);
+    }
+
+    void uncorkAll() {
+        unsetFlag(TICK_CORKED);
+        if (corked_) {
+            corked_ = 1;
+            uncork();
+        }
+    }
+
+    void corkQueueCleanUp() {
+        unsetFlag(TICK_CORKED);
+        corked_ = 0;
+        corkQueueSize_ = 0;
+        corkBufQueue_ = JsArray::null();
+        corkCbQueue_ = JsArray::null();
+    }
+
     void connectQueueCleanUp() {
         unsetFlag(CONNECTING);
         connectQueueSize_ = 0;
@@ -553,6 +708,7 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         }
 
         connectQueueCleanUp();
+        corkQueueCleanUp();
         unsetFlag(READABLE);
         unsetFlag(WRITABLE);
         finishTimer();
@@ -590,6 +746,15 @@ class Socket : public events::EventEmitter<node::net::Socket> {
             return false;
         }
 
+        Size length = buf->length();
+        Size written = handle_->tryWrite(buf);
+        writeStats()->inlineBytes += written;
+        if (written == length) {
+            return afterWriteInline(length, cb);
+        } else if (written) {
+            buf = buf->slice(written);
+        }
+
         AfterWrite::Ptr afterWrite(new AfterWrite(this, cb));
         int err = handle_->writeBuffer(buf, afterWrite, cb);
         if (err) {
@@ -597,26 +762,109 @@ class Socket : public events::EventEmitter<node::net::Socket> {
             return false;
         }
 
+        writeStats()->queuedWrites++;
+        writeStats()->queuedBytes += buf->length();
         pendingWriteReqs_++;
-        bytesDispatched_ += buf->length();
-        return true;
+        bytesDispatched_ += length;
+        return belowHighWaterMark();
     }
 
-    Boolean hasTimer() {
-        return !timer_.isUndefined();
+    Boolean writeBuffers(JsArray::CPtr bufs, JsFunction::Ptr cb) {
+        if (bufs->length() == 1) {
+            return writeBuffer(bufs->getCPtr<Buffer>(0), cb);
+        }
+
+        active();
+
+        if (!handle_) {
+            destroy(Error::create(Error::ILLEGAL_STATE), cb);
+            return false;
+        }
+
+        Size length = 0;
+        Size len = bufs->length();
+        for (Size i = 0; i < len; i++) {
+            length += bufs->getCPtr<Buffer>(i)->length();
+        }
+
+        Size written = handle_->tryWrite(bufs);
+        writeStats()->inlineBytes += written;
+        if (written == length) {
+            return afterWriteInline(length, cb);
+        }
+
+        JsArray::Ptr rest = JsArray::create();
+        for (Size i = 0; i < len; i++) {
+            Buffer::CPtr buf = bufs->getCPtr<Buffer>(i);
+            Size bufLen = buf->length();
+            if (written >= bufLen) {
+                written -= bufLen;
+            } else if (written) {
+                rest->push(buf->slice(written));
+                written = 0;
+            } else {
+                rest->push(buf);
+            }
+        }
+
+        AfterWrite::Ptr afterWrite(new AfterWrite(this, cb));
+        int err = rest->length() == 1
+            ? handle_->writeBuffer(rest->getCPtr<Buffer>(0), afterWrite, cb)
+            : handle_->writeBuffers(rest, afterWrite, cb);
+        if (err) {
+            destroy(LIBNODE_UV_ERROR(err), cb);
+            return false;
+        }
+
+        writeStats()->queuedWrites++;
+        for (Size i = 0; i < rest->length(); i++) {
+            writeStats()->queuedBytes += rest->getCPtr<Buffer>(i)->length();
+        }
+        pendingWriteReqs_++;
+        bytesDispatched_ += length;
+        return belowHighWaterMark();
     }
 
-    void startTimer(Int timeout) {
-        if (hasTimer()) finishTimer();
+    // everything went out synchronously.
+    // complete the write on the tick queue as uv_write would.
+    Boolean afterWriteInline(Size length, JsFunction::Ptr cb) {
+        AfterWrite::Ptr afterWrite(new AfterWrite(this, cb, true));
+        process::nextTick(afterWrite);
+
+        writeStats()->inlineWrites++;
+        pendingWriteReqs_++;
+        bytesDispatched_ += length;
+        return belowHighWaterMark();
+    }
 
-        JsFunction::Ptr emitTimeout(new EmitTimeout(this));
-        timer_ = node::setTimeout(emitTimeout, timeout);
-        timeout_ = timeout;
+    Boolean belowHighWaterMark() {
+        if (drained()) {
+            return true;
+        } else {
+            setFlag(NEED_DRAIN);
+            return false;
+        }
+    }
+
+    // an empty buffer is drained even if highWaterMark is 0
+    Boolean drained() const {
+        Size size = bufferSize();
+        return size == 0 || size < highWaterMark_;
+    }
+
+    Boolean hasTimer() {
+        return timer_.enrolled();
+    }
+
+    void startTimer(UInt timeout) {
+        if (!hasTimer()) {
+            timer_.setOnTimeout(JsFunction::Ptr(new EmitTimeout(this)));
+        }
+        timerLists()->enroll(&timer_, timeout);
     }
 
     void finishTimer() {
-        clearTimeout(timer_);
-        timer_ = UNDEFINED;
+        timerLists()->unenroll(&timer_);
     }
 
  private:
@@ -705,17 +953,22 @@ class Socket : public events::EventEmitter<node::net::Socket> {
      public:
         AfterWrite(
             Socket* sock,
-            JsFunction::Ptr cb)
+            JsFunction::Ptr cb,
+            Boolean written = false)
             : self_(sock)
-            , cb_(cb) {}
+            , cb_(cb)
+            , written_(written) {}
 
         virtual Value operator()(JsArray::Ptr args) {
             if (self_->hasFlag(DESTROYED)) {
                 return Error::ILLEGAL_STATE;
             }
 
-            assert(args->get(0).is<int>());
-            int status = to<int>(args->get(0));
+            int status = 0;
+            if (!written_) {
+                assert(args->get(0).is<int>());
+                status = to<int>(args->get(0));
+            }
             if (status) {
                 self_->destroy(LIBNODE_UV_ERROR(status), cb_);
                 return status;
@@ -723,7 +976,8 @@ class Socket : public events::EventEmitter<node::net::Socket> {
 
             self_->active();
             self_->pendingWriteReqs_--;
-            if (self_->pendingWriteReqs_ == 0) {
+            if (self_->hasFlag(NEED_DRAIN) && self_->drained()) {
+                self_->unsetFlag(NEED_DRAIN);
                 self_->emit(EVENT_DRAIN);
             }
 
@@ -739,6 +993,24 @@ class Socket : public events::EventEmitter<node::net::Socket> {
      private:
         Socket* self_;
         JsFunction::Ptr cb_;
+        Boolean written_;
+    };
+
+    class InvokeCallbacks : LIBJ_JS_FUNCTION(InvokeCallbacks)
+     public:
+        InvokeCallbacks(JsArray::Ptr cbs) : cbs_(cbs) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            Size len = cbs_->length();
+            for (Size i = 0; i < len; i++) {
+                JsFunction::Ptr cb = cbs_->getPtr<JsFunction>(i);
+                (*cb)(args);
+            }
+            return Status::OK;
+        }
+
+     private:
+        JsArray::Ptr cbs_;
     };
 
     class AfterConnect : LIBJ_JS_FUNCTION(AfterConnect)
@@ -924,6 +1196,23 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         Socket* self_;
     };
 
+    class UncorkAfterTick : LIBJ_JS_FUNCTION(UncorkAfterTick)
+     public:
+        UncorkAfterTick(Socket::Ptr sock) : self_(sock) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            // uncorkAll or destroy has already flushed the queue
+            if (self_->hasFlag(TICK_CORKED)) {
+                self_->unsetFlag(TICK_CORKED);
+                self_->uncork();
+            }
+            return Status::OK;
+        }
+
+     private:
+        Socket::Ptr self_;
+    };
+
     class OnDestroy : LIBJ_JS_FUNCTION(OnDestroy)
      public:
         OnDestroy(Socket::Ptr sock) : self_(sock) {}
@@ -954,16 +1243,24 @@ class Socket : public events::EventEmitter<node::net::Socket> {
         SHUTDOWN_QUEUED = 1 << 8,
         ERROR_EMITTED   = 1 << 9,
         ALLOW_HALF_OPEN = 1 << 10,
+        NEED_DRAIN      = 1 << 11,
+        TICK_CORKED     = 1 << 12,
     };
 
+    static const Size DEFAULT_HIGH_WATER_MARK = 16 * 1024;
+
  private:
     uv::Stream* handle_;
-    Value timer_;
-    Int timeout_;
+    Size highWaterMark_;
+    TimerItem timer_;
     Size pendingWriteReqs_;
     Size connectQueueSize_;
     JsArray::Ptr connectBufQueue_;
     JsArray::Ptr connectCbQueue_;
+    Size corked_;
+    Size corkQueueSize_;
+    JsArray::Ptr corkBufQueue_;
+    JsArray::Ptr corkCbQueue_;
     Size bytesRead_;
     Size bytesDispatched_;
     StringDecoder::Ptr decoder_;
@@ -976,12 +1273,16 @@ class Socket : public events::EventEmitter<node::net::Socket> {
 
     Socket()
         : handle_(NULL)
-        , timer_(UNDEFINED)
-        , timeout_(0)
+        , highWaterMark_(DEFAULT_HIGH_WATER_MARK)
+        , timer_()
         , pendingWriteReqs_(0)
         , connectQueueSize_(0)
         , connectBufQueue_(JsArray::null())
         , connectCbQueue_(JsArray::null())
+        , corked_(0)
+        , corkQueueSize_(0)
+        , corkBufQueue_(JsArray::null())
+        , corkCbQueue_(JsArray::null())
         , bytesRead_(0)
         , bytesDispatched_(0)
         , decoder_(StringDecoder::null())
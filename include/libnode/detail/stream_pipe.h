@@ -0,0 +1,222 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_STREAM_PIPE_H_
+#define LIBNODE_DETAIL_STREAM_PIPE_H_
+
+#include <libnode/process.h>
+#include <libnode/stream/duplex.h>
+#include <libnode/stream/readable.h>
+#include <libnode/stream/writable.h>
+
+#include <libj/status.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+// S is Readable or Duplex, D is Writable or Duplex
+template<typename S, typename D>
+class StreamPipe : LIBJ_JS_FUNCTION_TEMPLATE(StreamPipe)
+ public:
+    static Ptr create(
+        typename S::Ptr src,
+        typename D::Ptr dest,
+        Boolean end) {
+        Ptr self(new StreamPipe(src, dest, end));
+        self->onDrain_ = JsFunction::Ptr(new Listener(self, ON_DRAIN));
+        self->onEnd_ = JsFunction::Ptr(new Listener(self, ON_END));
+        self->onClose_ = JsFunction::Ptr(new Listener(self, ON_CLOSE));
+        self->onError_ = JsFunction::Ptr(new Listener(self, ON_ERROR));
+        self->onDestClose_ =
+            JsFunction::Ptr(new Listener(self, ON_DEST_CLOSE));
+
+        src->on(S::EVENT_DATA, self);
+        src->on(S::EVENT_END, self->onEnd_);
+        src->on(S::EVENT_CLOSE, self->onClose_);
+        src->on(S::EVENT_ERROR, self->onError_);
+        dest->on(D::EVENT_DRAIN, self->onDrain_);
+        dest->on(D::EVENT_ERROR, self->onError_);
+        dest->on(D::EVENT_CLOSE, self->onDestClose_);
+        return self;
+    }
+
+    static void cleanup(Ptr self) {
+        if (!self->onDrain_) return;
+
+        typename S::Ptr src = self->src_;
+        typename D::Ptr dest = self->dest_;
+        src->removeListener(S::EVENT_DATA, self);
+        src->removeListener(S::EVENT_END, self->onEnd_);
+        src->removeListener(S::EVENT_CLOSE, self->onClose_);
+        src->removeListener(S::EVENT_ERROR, self->onError_);
+        dest->removeListener(D::EVENT_DRAIN, self->onDrain_);
+        dest->removeListener(D::EVENT_ERROR, self->onError_);
+        dest->removeListener(D::EVENT_CLOSE, self->onDestClose_);
+
+        // the listeners refer to this pipe
+        self->onDrain_ = JsFunction::null();
+        self->onEnd_ = JsFunction::null();
+        self->onClose_ = JsFunction::null();
+        self->onError_ = JsFunction::null();
+        self->onDestClose_ = JsFunction::null();
+    }
+
+    Boolean pipesTo(node::stream::Stream::CPtr dest) const {
+        return !dest || dest_ == dest;
+    }
+
+    // source 'data'
+    virtual Value operator()(JsArray::Ptr args) {
+        if (dest_->writable() && !dest_->write(args->get(0))) {
+            src_->pause();
+        }
+        return Status::OK;
+    }
+
+ private:
+    enum Kind {
+        ON_DRAIN,
+        ON_END,
+        ON_CLOSE,
+        ON_ERROR,
+        ON_DEST_CLOSE,
+        ON_CLEANUP,
+    };
+
+    class Listener : LIBJ_JS_FUNCTION_TEMPLATE(Listener)
+     public:
+        Listener(
+            typename StreamPipe::Ptr pipe,
+            Kind kind)
+            : pipe_(pipe)
+            , kind_(kind) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            switch (kind_) {
+            case ON_DRAIN:
+                if (pipe_->src_->readable()) pipe_->src_->resume();
+                return Status::OK;
+            case ON_END:
+                if (pipe_->end_ && !pipe_->ended_) {
+                    pipe_->ended_ = true;
+                    pipe_->dest_->end();
+                }
+                break;
+            case ON_CLOSE:
+                if (pipe_->end_ && !pipe_->ended_) {
+                    pipe_->ended_ = true;
+                    pipe_->dest_->destroy();
+                }
+                break;
+            case ON_CLEANUP:
+                cleanup(pipe_);
+                return Status::OK;
+            default:
+                break;
+            }
+
+            // the emitter being iterated must not lose its listeners
+            process::nextTick(
+                JsFunction::Ptr(new Listener(pipe_, ON_CLEANUP)));
+            return Status::OK;
+        }
+
+     private:
+        typename StreamPipe::Ptr pipe_;
+        Kind kind_;
+    };
+
+    StreamPipe(
+        typename S::Ptr src,
+        typename D::Ptr dest,
+        Boolean end)
+        : src_(src)
+        , dest_(dest)
+        , end_(end)
+        , ended_(false)
+        , onDrain_(JsFunction::null())
+        , onEnd_(JsFunction::null())
+        , onClose_(JsFunction::null())
+        , onError_(JsFunction::null())
+        , onDestClose_(JsFunction::null()) {}
+
+    typename S::Ptr src_;
+    typename D::Ptr dest_;
+    Boolean end_;
+    Boolean ended_;
+    JsFunction::Ptr onDrain_;
+    JsFunction::Ptr onEnd_;
+    JsFunction::Ptr onClose_;
+    JsFunction::Ptr onError_;
+    JsFunction::Ptr onDestClose_;
+};
+
+template<typename S>
+inline Boolean pipeStream(
+    typename S::Ptr src,
+    node::stream::Stream::Ptr dest,
+    libj::JsObject::CPtr options) {
+    LIBJ_STATIC_SYMBOL_DEF(OPTION_END, "end");
+
+    if (!src || !dest) return false;
+
+    Boolean end = true;
+    if (options) to<Boolean>(options->get(OPTION_END), &end);
+
+    Value d = dest;
+    if (d.is<node::stream::Writable>()) {
+        StreamPipe<S, node::stream::Writable>::create(
+            src, toPtr<node::stream::Writable>(d), end);
+    } else if (d.is<node::stream::Duplex>()) {
+        StreamPipe<S, node::stream::Duplex>::create(
+            src, toPtr<node::stream::Duplex>(d), end);
+    } else {
+        return false;
+    }
+
+    dest->emit(node::stream::Writable::EVENT_PIPE, src);
+    return true;
+}
+
+template<typename S>
+inline Boolean unpipeStream(
+    typename S::Ptr src,
+    node::stream::Stream::CPtr dest) {
+    typedef StreamPipe<S, node::stream::Writable> WritablePipe;
+    typedef StreamPipe<S, node::stream::Duplex> DuplexPipe;
+
+    if (!src) return false;
+
+    // cleanup modifies the listeners
+    JsArray::Ptr listeners = src->listeners(S::EVENT_DATA);
+    JsArray::Ptr ls = JsArray::create();
+    Size len = listeners->length();
+    for (Size i = 0; i < len; i++) {
+        ls->add(listeners->get(i));
+    }
+
+    Boolean found = false;
+    for (Size i = 0; i < len; i++) {
+        Value v = ls->get(i);
+        if (v.is<WritablePipe>()) {
+            typename WritablePipe::Ptr pipe = toPtr<WritablePipe>(v);
+            if (pipe->pipesTo(dest)) {
+                WritablePipe::cleanup(pipe);
+                found = true;
+            }
+        } else if (v.is<DuplexPipe>()) {
+            typename DuplexPipe::Ptr pipe = toPtr<DuplexPipe>(v);
+            if (pipe->pipesTo(dest)) {
+                DuplexPipe::cleanup(pipe);
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_STREAM_PIPE_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_TICK_QUEUE_H_
+#define LIBNODE_DETAIL_TICK_QUEUE_H_
+
+#include <libnode/invoke.h>
+#include <libnode/debug_print.h>
+#include <libnode/detail/uv/loop.h>
+
+#include <libj/typed_linked_list.h>
+
+#include <uv.h>
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+// ticks are drained in the prepare and check phases of the loop iteration
+// in which they are queued. immediates are run once per check phase.
+class TickQueue {
+ public:
+    typedef TypedLinkedList<JsFunction::Ptr> CallbackQueue;
+
+    TickQueue(uv_loop_t* loop)
+        : active_(false)
+        , closing_(0)
+        , ticks_(CallbackQueue::create())
+        , immediates_(CallbackQueue::create()) {
+        Int r = uv_prepare_init(loop, &prepare_);
+        assert(r == 0);
+        r = uv_check_init(loop, &check_);
+        assert(r == 0);
+        r = uv_idle_init(loop, &idle_);
+        assert(r == 0);
+        prepare_.data = this;
+        check_.data = this;
+        idle_.data = this;
+        LIBJ_DEBUG_PRINT(
+            "static: TickQueue::ticks_ %p",
+            LIBJ_DEBUG_OBJECT_PTR(ticks_));
+        LIBJ_DEBUG_PRINT(
+            "static: TickQueue::immediates_ %p",
+            LIBJ_DEBUG_OBJECT_PTR(immediates_));
+    }
+
+    void pushTick(JsFunction::Ptr cb) {
+        assert(cb);
+        ticks_->pushTyped(cb);
+        start();
+        LIBNODE_DEBUG_PRINT("nextTick: %d", ticks_->length());
+    }
+
+    void pushImmediate(JsFunction::Ptr cb) {
+        assert(cb);
+        immediates_->pushTyped(cb);
+        start();
+        uv_idle_start(&idle_, onIdle);
+    }
+
+    Size numTicks() const {
+        return ticks_->length();
+    }
+
+    Size numImmediates() const {
+        return immediates_->length();
+    }
+
+    void runTicks() {
+        while (!ticks_->isEmpty()) {
+            JsFunction::Ptr cb = ticks_->shiftTyped();
+            invoke(cb);
+        }
+    }
+
+    // deletes this queue once all the handles are closed
+    void close() {
+        closing_ = 3;
+        uv_close(reinterpret_cast<uv_handle_t*>(&prepare_), onClose);
+        uv_close(reinterpret_cast<uv_handle_t*>(&check_), onClose);
+        uv_close(reinterpret_cast<uv_handle_t*>(&idle_), onClose);
+    }
+
+    static void destroy(void* queue) {
+        static_cast<TickQueue*>(queue)->close();
+    }
+
+ private:
+    void start() {
+        if (!active_) {
+            active_ = true;
+            uv_prepare_start(&prepare_, onPrepare);
+            uv_check_start(&check_, onCheck);
+        }
+    }
+
+    void stopIfEmpty() {
+        if (immediates_->isEmpty()) {
+            uv_idle_stop(&idle_);
+            if (ticks_->isEmpty()) {
+                active_ = false;
+                uv_prepare_stop(&prepare_);
+                uv_check_stop(&check_);
+            }
+        }
+    }
+
+    void runImmediates() {
+        // immediates queued while running are deferred to the next iteration
+        Size len = immediates_->length();
+        for (Size i = 0; i < len; i++) {
+            JsFunction::Ptr cb = immediates_->shiftTyped();
+            invoke(cb);
+            runTicks();
+        }
+    }
+
+    static void onPrepare(uv_prepare_t* handle) {
+        TickQueue* self = static_cast<TickQueue*>(handle->data);
+        self->runTicks();
+        self->stopIfEmpty();
+    }
+
+    static void onCheck(uv_check_t* handle) {
+        TickQueue* self = static_cast<TickQueue*>(handle->data);
+        self->runTicks();
+        self->runImmediates();
+        self->stopIfEmpty();
+    }
+
+    // an active idle handle makes the poll phase non-blocking
+    static void onIdle(uv_idle_t* handle) {}
+
+    static void onClose(uv_handle_t* handle) {
+        TickQueue* self = static_cast<TickQueue*>(handle->data);
+        if (!--self->closing_) delete self;
+    }
+
+ private:
+    Boolean active_;
+    Size closing_;
+    uv_prepare_t prepare_;
+    uv_check_t check_;
+    uv_idle_t idle_;
+    CallbackQueue::Ptr ticks_;
+    CallbackQueue::Ptr immediates_;
+};
+
+inline TickQueue* tickQueue(uv_loop_t* loop = uv::currentLoop()) {
+    uv::LoopContext* context = uv::loopContext(loop);
+    void* queue = context->get(uv::LoopContext::TICK_QUEUE);
+    if (!queue) {
+        queue = new TickQueue(loop);
+        context->set(
+            uv::LoopContext::TICK_QUEUE,
+            queue,
+            TickQueue::destroy);
+    }
+    return static_cast<TickQueue*>(queue);
+}
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_TICK_QUEUE_H_
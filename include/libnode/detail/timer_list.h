@@ -0,0 +1,226 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_TIMER_LIST_H_
+#define LIBNODE_DETAIL_TIMER_LIST_H_
+
+#include <libnode/invoke.h>
+#include <libnode/detail/uv/loop.h>
+#include <libnode/detail/uv/timer.h>
+
+#include <libj/status.h>
+
+#include <uv.h>
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+
+class TimerList;
+
+class TimerItem {
+ public:
+    TimerItem()
+        : list_(NULL)
+        , prev_(NULL)
+        , next_(NULL)
+        , idleStart_(0)
+        , onTimeout_(JsFunction::null()) {}
+
+    ~TimerItem();
+
+    Boolean enrolled() const {
+        return !!list_;
+    }
+
+    UInt timeout() const;
+
+    void setOnTimeout(JsFunction::Ptr callback) {
+        onTimeout_ = callback;
+    }
+
+ private:
+    friend class TimerList;
+    friend class TimerLists;
+
+    TimerList* list_;
+    TimerItem* prev_;
+    TimerItem* next_;
+    ULong idleStart_;
+    JsFunction::Ptr onTimeout_;
+};
+
+// all the items in a list share the same timeout, so they are ordered
+// by their deadlines and a single uv timer is armed for the head.
+// re-arming an item just moves it to the tail.
+class TimerList {
+ public:
+    TimerList(uv_loop_t* loop, UInt msecs)
+        : loop_(loop)
+        , msecs_(msecs)
+        , head_(NULL)
+        , tail_(NULL)
+        , timer_(new uv::Timer(loop))
+        , next_(NULL) {
+        timer_->setOnTimeout(JsFunction::Ptr(new OnTimeout(this)));
+    }
+
+    UInt msecs() const {
+        return msecs_;
+    }
+
+    Boolean isEmpty() const {
+        return !head_;
+    }
+
+    void append(TimerItem* item) {
+        if (item->list_) item->list_->remove(item);
+
+        item->list_ = this;
+        item->idleStart_ = uv_now(loop_);
+        item->prev_ = tail_;
+        item->next_ = NULL;
+        if (tail_) {
+            tail_->next_ = item;
+        } else {
+            head_ = item;
+            timer_->start(msecs_, 0);
+        }
+        tail_ = item;
+    }
+
+    ~TimerList() {
+        while (head_) remove(head_);
+        timer_->close();
+    }
+
+    void remove(TimerItem* item) {
+        assert(item->list_ == this);
+
+        if (item->prev_) {
+            item->prev_->next_ = item->next_;
+        } else {
+            head_ = item->next_;
+        }
+        if (item->next_) {
+            item->next_->prev_ = item->prev_;
+        } else {
+            tail_ = item->prev_;
+        }
+        item->list_ = NULL;
+        item->prev_ = NULL;
+        item->next_ = NULL;
+
+        if (!head_) timer_->stop();
+    }
+
+ private:
+    void expire() {
+        ULong now = uv_now(loop_);
+        while (head_) {
+            TimerItem* item = head_;
+            ULong diff = now - item->idleStart_;
+            if (diff < msecs_) {
+                timer_->start(msecs_ - diff, 0);
+                return;
+            }
+
+            remove(item);
+            if (item->onTimeout_) invoke(item->onTimeout_);
+        }
+    }
+
+    class OnTimeout : LIBJ_JS_FUNCTION(OnTimeout)
+     public:
+        OnTimeout(TimerList* self) : self_(self) {}
+
+        virtual Value operator()(JsArray::Ptr args) {
+            self_->expire();
+            return Status::OK;
+        }
+
+     private:
+        TimerList* self_;
+    };
+
+ private:
+    friend class TimerLists;
+
+    uv_loop_t* loop_;
+    UInt msecs_;
+    TimerItem* head_;
+    TimerItem* tail_;
+    uv::Timer* timer_;
+    TimerList* next_;
+};
+
+// lists are kept for the lifetime of the loop, one per distinct timeout
+class TimerLists {
+ public:
+    TimerLists(uv_loop_t* loop)
+        : loop_(loop)
+        , lists_(NULL) {}
+
+    ~TimerLists() {
+        while (lists_) {
+            TimerList* l = lists_;
+            lists_ = l->next_;
+            delete l;
+        }
+    }
+
+    void enroll(TimerItem* item, UInt msecs) {
+        assert(msecs);
+        list(msecs)->append(item);
+    }
+
+    void unenroll(TimerItem* item) {
+        if (item->enrolled()) item->list_->remove(item);
+    }
+
+    void active(TimerItem* item) {
+        if (item->enrolled()) item->list_->append(item);
+    }
+
+ private:
+    TimerList* list(UInt msecs) {
+        for (TimerList* l = lists_; l; l = l->next_) {
+            if (l->msecs() == msecs) return l;
+        }
+
+        TimerList* l = new TimerList(loop_, msecs);
+        l->next_ = lists_;
+        lists_ = l;
+        return l;
+    }
+
+    uv_loop_t* loop_;
+    TimerList* lists_;
+};
+
+inline TimerItem::~TimerItem() {
+    if (list_) list_->remove(this);
+}
+
+inline UInt TimerItem::timeout() const {
+    return list_ ? list_->msecs() : 0;
+}
+
+inline TimerLists* timerLists(uv_loop_t* loop = uv::currentLoop()) {
+    uv::LoopContext* context = uv::loopContext(loop);
+    void* lists = context->get(uv::LoopContext::TIMER_LISTS);
+    if (!lists) {
+        lists = new TimerLists(loop);
+        context->set(
+            uv::LoopContext::TIMER_LISTS,
+            lists,
+            uv::destroy<TimerLists>);
+    }
+    return static_cast<TimerLists*>(lists);
+}
+
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_TIMER_LIST_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UTIL_BYTE_ORDER_H_
+#define LIBNODE_DETAIL_UTIL_BYTE_ORDER_H_
+
+#include <libj/typedef.h>
+
+#include <string.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+inline Boolean isLittleEndian() {
+    const UShort one = 1;
+    return *reinterpret_cast<const UByte*>(&one) == 1;
+}
+
+template<Size N>
+struct SwapUnit;
+
+template<>
+struct SwapUnit<1> {
+    typedef UByte Type;
+
+    static Type swap(Type v) {
+        return v;
+    }
+};
+
+template<>
+struct SwapUnit<2> {
+    typedef UShort Type;
+
+    static Type swap(Type v) {
+        return static_cast<Type>((v << 8) | (v >> 8));
+    }
+};
+
+template<>
+struct SwapUnit<4> {
+    typedef UInt Type;
+
+    static Type swap(Type v) {
+#ifdef __GNUC__
+        return __builtin_bswap32(v);
+#else
+        return (v << 24) | ((v << 8) & 0xff0000) |
+            ((v >> 8) & 0xff00) | (v >> 24);
+#endif
+    }
+};
+
+template<>
+struct SwapUnit<8> {
+    typedef ULong Type;
+
+    static Type swap(Type v) {
+#ifdef __GNUC__
+        return __builtin_bswap64(v);
+#else
+        return (static_cast<ULong>(SwapUnit<4>::swap(
+            static_cast<UInt>(v))) << 32) |
+            SwapUnit<4>::swap(static_cast<UInt>(v >> 32));
+#endif
+    }
+};
+
+// reads a T stored in the given byte order from unaligned memory
+template<typename T, Boolean LittleEndian>
+inline T load(const UByte* src) {
+    typedef SwapUnit<sizeof(T)> Unit;
+    typename Unit::Type u;
+    memcpy(&u, src, sizeof(T));
+    if (LittleEndian != isLittleEndian()) u = Unit::swap(u);
+
+    T v;
+    memcpy(&v, &u, sizeof(T));
+    return v;
+}
+
+template<typename T, Boolean LittleEndian>
+inline void store(UByte* dst, T v) {
+    typedef SwapUnit<sizeof(T)> Unit;
+    typename Unit::Type u;
+    memcpy(&u, &v, sizeof(T));
+    if (LittleEndian != isLittleEndian()) u = Unit::swap(u);
+
+    memcpy(dst, &u, sizeof(T));
+}
+
+// copies count units of size bytes (2, 4 or 8), reversing each unit.
+// dst and src may be the same.
+void swapCopy(UByte* dst, const UByte* src, Size count, Size size);
+
+template<typename T, Boolean LittleEndian>
+inline void loadArray(T* dst, const UByte* src, Size count) {
+    UByte* out = reinterpret_cast<UByte*>(dst);
+    if (sizeof(T) == 1 || LittleEndian == isLittleEndian()) {
+        memcpy(out, src, count * sizeof(T));
+    } else {
+        swapCopy(out, src, count, sizeof(T));
+    }
+}
+
+template<typename T, Boolean LittleEndian>
+inline void storeArray(UByte* dst, const T* src, Size count) {
+    const UByte* in = reinterpret_cast<const UByte*>(src);
+    if (sizeof(T) == 1 || LittleEndian == isLittleEndian()) {
+        memcpy(dst, in, count * sizeof(T));
+    } else {
+        swapCopy(dst, in, count, sizeof(T));
+    }
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UTIL_BYTE_ORDER_H_
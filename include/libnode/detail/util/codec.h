@@ -0,0 +1,51 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UTIL_CODEC_H_
+#define LIBNODE_DETAIL_UTIL_CODEC_H_
+
+#include <libj/typedef.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+// the instruction sets the codecs are dispatched to at runtime
+enum Isa {
+    ISA_SCALAR,
+    ISA_SSE2,
+    ISA_SSSE3,
+    ISA_AVX2,
+};
+
+// the best one supported by this cpu
+Isa detectedIsa();
+
+Isa isa();
+
+// for tests and benchmarks. isa is capped at the detected one.
+Isa setIsa(Isa isa);
+
+// writes len * 2 lowercase hex digits
+void hexEncode(const UByte* src, Size len, char* dst);
+
+// decodes len / 2 bytes. len must be even.
+Boolean hexDecode(const char* src, Size len, UByte* dst);
+
+Size base64EncodedLength(Size len);
+
+// writes base64EncodedLength(len) chars, padded with '='
+void base64Encode(const UByte* src, Size len, char* dst);
+
+// NO_POS if the padding or the length is invalid
+Size base64DecodedLength(const char* src, Size len);
+
+// decodes base64DecodedLength(src, len) bytes
+Boolean base64Decode(const char* src, Size len, UByte* dst);
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UTIL_CODEC_H_
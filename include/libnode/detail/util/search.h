@@ -0,0 +1,28 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UTIL_SEARCH_H_
+#define LIBNODE_DETAIL_UTIL_SEARCH_H_
+
+#include <libj/typedef.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+// the offset of the first needle in the haystack, or NO_POS
+Size search(
+    const UByte* haystack,
+    Size length,
+    const UByte* needle,
+    Size needleLength);
+
+// repeats the pattern over dst
+void fill(UByte* dst, Size length, const UByte* pattern, Size patternLength);
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UTIL_SEARCH_H_
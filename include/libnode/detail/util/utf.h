@@ -0,0 +1,70 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UTIL_UTF_H_
+#define LIBNODE_DETAIL_UTIL_UTF_H_
+
+#include <libj/typedef.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+// the transcoders read the chars of a String as UTF-16 or UTF-32 units,
+// and a lone surrogate or an invalid code point as U+FFFD.
+// the encoders write as many whole chars as dstLen allows,
+// and return the number of bytes written.
+
+Size utf8Length(const UShort* src, Size len);
+
+Size utf8Length(const UInt* src, Size len);
+
+Size utf8Encode(const UShort* src, Size len, UByte* dst, Size dstLen);
+
+Size utf8Encode(const UInt* src, Size len, UByte* dst, Size dstLen);
+
+Size utf16Length(const UShort* src, Size len);
+
+Size utf16Length(const UInt* src, Size len);
+
+Size utf16Encode(
+    const UShort* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian);
+
+Size utf16Encode(
+    const UInt* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian);
+
+Size utf32Length(const UShort* src, Size len);
+
+Size utf32Length(const UInt* src, Size len);
+
+Size utf32Encode(
+    const UShort* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian);
+
+Size utf32Encode(
+    const UInt* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian);
+
+template<Size N>
+struct CharUnit {};
+
+template<>
+struct CharUnit<2> {
+    typedef UShort Type;
+};
+
+template<>
+struct CharUnit<4> {
+    typedef UInt Type;
+};
+
+typedef CharUnit<sizeof(Char)>::Type Unit;
+
+inline const Unit* units(const Char* chars) {
+    return reinterpret_cast<const Unit*>(chars);
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UTIL_UTF_H_
@@ -0,0 +1,131 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UV_LOOP_H_
+#define LIBNODE_DETAIL_UV_LOOP_H_
+
+#include <libnode/config.h>
+
+#include <uv.h>
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace uv {
+
+// the state libnode keeps per loop, hung off uv_loop_t::data.
+// a loop is driven by a single thread, so the slots need no locking.
+class LoopContext {
+ public:
+    enum Slot {
+        TICK_QUEUE,
+        TIMER_LISTS,
+        SLAB_ALLOCATOR,
+        ARGUMENTS_LIST,
+        INCOMING_MESSAGE_LIST,
+        OUTGOING_MESSAGE_LIST,
+        PARSER_LIST,
+        DATE_CACHE,
+        WRITE_STATS,
+        LOOP_MONITOR,
+        NUM_SLOTS,
+    };
+
+    typedef void (*Destroy)(void* obj);
+
+    LoopContext(uv_loop_t* loop) : loop_(loop) {
+        for (int i = 0; i < NUM_SLOTS; i++) {
+            slots_[i] = NULL;
+            destroys_[i] = NULL;
+        }
+    }
+
+    // the objects may close their handles, so the loop has to be run
+    // once more before it is closed
+    ~LoopContext() {
+        for (int i = NUM_SLOTS - 1; i >= 0; i--) {
+            if (slots_[i] && destroys_[i]) destroys_[i](slots_[i]);
+        }
+    }
+
+    uv_loop_t* loop() const {
+        return loop_;
+    }
+
+    void* get(Slot slot) const {
+        return slots_[slot];
+    }
+
+    void set(Slot slot, void* obj, Destroy destroy) {
+        assert(!slots_[slot]);
+        slots_[slot] = obj;
+        destroys_[slot] = destroy;
+    }
+
+ private:
+    uv_loop_t* loop_;
+    void* slots_[NUM_SLOTS];
+    Destroy destroys_[NUM_SLOTS];
+};
+
+template<typename T>
+inline void destroy(void* obj) {
+    delete static_cast<T*>(obj);
+}
+
+#ifdef LIBNODE_USE_THREAD
+
+inline uv_key_t* currentLoopKey() {
+    static uv_key_t key;
+    static uv_once_t once = UV_ONCE_INIT;
+    struct Init {
+        static void create() {
+            int r = uv_key_create(&key);
+            assert(r == 0);
+        }
+    };
+    uv_once(&once, Init::create);
+    return &key;
+}
+
+inline uv_loop_t* currentLoop() {
+    void* loop = uv_key_get(currentLoopKey());
+    if (loop) {
+        return static_cast<uv_loop_t*>(loop);
+    } else {
+        return uv_default_loop();
+    }
+}
+
+// NULL makes the default loop current again
+inline void setCurrentLoop(uv_loop_t* loop) {
+    uv_key_set(currentLoopKey(), loop);
+}
+
+#else  // LIBNODE_USE_THREAD
+
+inline uv_loop_t* currentLoop() {
+    return uv_default_loop();
+}
+
+#endif  // LIBNODE_USE_THREAD
+
+inline LoopContext* loopContext(uv_loop_t* loop = currentLoop()) {
+    assert(loop);
+    if (!loop->data) loop->data = new LoopContext(loop);
+    return static_cast<LoopContext*>(loop->data);
+}
+
+inline void closeLoopContext(uv_loop_t* loop) {
+    assert(loop);
+    LoopContext* context = static_cast<LoopContext*>(loop->data);
+    loop->data = NULL;
+    delete context;
+}
+
+}  // namespace uv
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UV_LOOP_H_
@@ -3,6 +3,7 @@
 #ifndef LIBNODE_DETAIL_UV_PIPE_H_
 #define LIBNODE_DETAIL_UV_PIPE_H_
 
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/stream.h>
 
 namespace libj {
@@ -12,9 +13,9 @@ namespace uv {
 
 class Pipe : public Stream {
  public:
-    Pipe(Boolean ipc = false)
+    Pipe(Boolean ipc, uv_loop_t* loop)
         : Stream(reinterpret_cast<uv_stream_t*>(&pipe_)) {
-        Int r = uv_pipe_init(uv_default_loop(), &pipe_, ipc);
+        Int r = uv_pipe_init(loop, &pipe_, ipc);
         assert(r == 0);
         pipe_.data = this;
     }
@@ -48,18 +49,13 @@ class Pipe : public Stream {
             afterConnect);
     }
 
- private:
-    static void onConnection(uv_stream_t* handle, int status) {
-        Pipe* self = static_cast<Pipe*>(handle->data);
-        assert(self && self->stream_ == handle);
-
-        if (status) {
-            invoke(self->onConnection_);
-            return;
+ protected:
+    virtual void accept() {
+        Pipe* pipe = new Pipe(false, stream_->loop);
+        if (uv_accept(stream_, pipe->stream_)) {
+            pipe->close();
         } else {
-            Pipe* pipe = new Pipe(false);
-            if (uv_accept(handle, pipe->stream_)) return;
-            invoke(self->onConnection_, pipe);
+            invoke(onConnection_, pipe);
         }
     }
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UV_PROCESS_H_
+#define LIBNODE_DETAIL_UV_PROCESS_H_
+
+#include <libnode/invoke.h>
+#include <libnode/detail/uv/handle.h>
+#include <libnode/detail/uv/loop.h>
+#include <libnode/detail/uv/pipe.h>
+
+#include <libj/detail/gc_delete.h>
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace uv {
+
+class Process : public Handle {
+ public:
+    Process(uv_loop_t* loop)
+        : Handle(reinterpret_cast<uv_handle_t*>(&process_))
+        , loop_(loop)
+        , onExit_(JsFunction::null()) {}
+
+    virtual ~Process() {
+        LIBJ_GC_DELETE(onExit_);
+    }
+
+    void setOnExit(JsFunction::Ptr callback) {
+        onExit_ = callback;
+    }
+
+    // the child inherits stdin, stdout and stderr, and gets ipc as fd 3.
+    // the handle has to be closed even if spawn fails.
+    Int spawn(
+        String::CPtr file,
+        JsArray::CPtr args,
+        JsArray::CPtr env,
+        Pipe* ipc) {
+        assert(file && ipc);
+        std::vector<std::string> argStrs;
+        argStrs.push_back(file->toStdString());
+        toStdStrings(args, &argStrs);
+        std::vector<char*> argv;
+        toCStrings(&argStrs, &argv);
+
+        std::vector<std::string> envStrs;
+        toStdStrings(env, &envStrs);
+        std::vector<char*> envp;
+        toCStrings(&envStrs, &envp);
+
+        uv_stdio_container_t stdio[4];
+        for (int i = 0; i < 3; i++) {
+            stdio[i].flags = UV_INHERIT_FD;
+            stdio[i].data.fd = i;
+        }
+        stdio[3].flags = static_cast<uv_stdio_flags>(
+            UV_CREATE_PIPE | UV_READABLE_PIPE | UV_WRITABLE_PIPE);
+        stdio[3].data.stream = ipc->stream();
+
+        uv_process_options_t options;
+        memset(&options, 0, sizeof(options));
+        options.exit_cb = onExit;
+        options.file = argv[0];
+        options.args = &argv[0];
+        options.env = env ? &envp[0] : NULL;
+        options.stdio = stdio;
+        options.stdio_count = 4;
+
+        Int err = uv_spawn(loop_, &process_, &options);
+        process_.data = this;
+        return err;
+    }
+
+    Int kill(Int signal) {
+        return uv_process_kill(&process_, signal);
+    }
+
+    Int pid() const {
+        return process_.pid;
+    }
+
+ private:
+    static void toStdStrings(
+        JsArray::CPtr strs,
+        std::vector<std::string>* stdStrs) {
+        if (!strs) return;
+
+        Size len = strs->length();
+        for (Size i = 0; i < len; i++) {
+            String::CPtr s = strs->getCPtr<String>(i);
+            if (s) stdStrs->push_back(s->toStdString());
+        }
+    }
+
+    static void toCStrings(
+        std::vector<std::string>* stdStrs,
+        std::vector<char*>* cStrs) {
+        Size len = stdStrs->size();
+        for (Size i = 0; i < len; i++) {
+            cStrs->push_back(const_cast<char*>((*stdStrs)[i].c_str()));
+        }
+        cStrs->push_back(NULL);
+    }
+
+    static void onExit(
+        uv_process_t* handle,
+        int64_t exitStatus,
+        int termSignal) {
+        Process* self = static_cast<Process*>(handle->data);
+        assert(self);
+        invoke(
+            self->onExit_,
+            static_cast<Long>(exitStatus),
+            static_cast<Int>(termSignal));
+    }
+
+    uv_process_t process_;
+    uv_loop_t* loop_;
+    JsFunction::Ptr onExit_;
+};
+
+}  // namespace uv
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UV_PROCESS_H_
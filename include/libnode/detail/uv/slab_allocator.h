@@ -0,0 +1,131 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_DETAIL_UV_SLAB_ALLOCATOR_H_
+#define LIBNODE_DETAIL_UV_SLAB_ALLOCATOR_H_
+
+#include <libnode/buffer.h>
+#include <libnode/detail/uv/loop.h>
+
+#include <libj/debug_print.h>
+
+#include <assert.h>
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace uv {
+
+// carves read buffers out of large slabs shared by the streams of a loop.
+// a read buffer is shrunk to the bytes actually read, and the unused tail
+// is given back to the slab. a slab is released when the last slice of it
+// is released.
+class SlabAllocator {
+ public:
+    static const Size SLAB_SIZE = 128 * 1024;
+
+    SlabAllocator(Size slabSize = SLAB_SIZE)
+        : slabSize_(slabSize)
+        , slab_(Buffer::null())
+        , offset_(0)
+        , numSlabs_(0)
+        , numAllocs_(0)
+        , bytesUsed_(0)
+        , bytesReturned_(0) {
+        LIBJ_DEBUG_PRINT(
+            "static: SlabAllocator::slab_ %p",
+            LIBJ_DEBUG_OBJECT_PTR(slab_));
+    }
+
+    char* allocate(Size size, Buffer::Ptr* slab, Size* offset) {
+        assert(slab && offset);
+        numAllocs_++;
+
+        if (size > slabSize_) {
+            *slab = Buffer::create(size);
+            *offset = 0;
+        } else {
+            if (!slab_ || slabSize_ - offset_ < size) {
+                slab_ = Buffer::create(slabSize_);
+                offset_ = 0;
+                numSlabs_++;
+            }
+            *slab = slab_;
+            *offset = offset_;
+            offset_ += size;
+        }
+        return static_cast<char*>(const_cast<void*>((*slab)->data())) +
+            *offset;
+    }
+
+    Buffer::Ptr shrink(
+        Buffer::Ptr slab,
+        Size offset,
+        Size size,
+        Size used) {
+        assert(used <= size);
+        if (slab == slab_ && offset + size == offset_) {
+            offset_ = offset + used;
+            bytesReturned_ += size - used;
+        }
+        bytesUsed_ += used;
+
+        if (used) {
+            return slab->slice(offset, offset + used);
+        } else {
+            return Buffer::null();
+        }
+    }
+
+    Size slabSize() const {
+        return slabSize_;
+    }
+
+    Size slabOffset() const {
+        return offset_;
+    }
+
+    Size numSlabs() const {
+        return numSlabs_;
+    }
+
+    Size numAllocs() const {
+        return numAllocs_;
+    }
+
+    Size bytesUsed() const {
+        return bytesUsed_;
+    }
+
+    Size bytesReturned() const {
+        return bytesReturned_;
+    }
+
+ private:
+    Size slabSize_;
+    Buffer::Ptr slab_;
+    Size offset_;
+    Size numSlabs_;
+    Size numAllocs_;
+    Size bytesUsed_;
+    Size bytesReturned_;
+};
+
+inline SlabAllocator* slabAllocator(uv_loop_t* loop = currentLoop()) {
+    LoopContext* context = loopContext(loop);
+    void* allocator = context->get(LoopContext::SLAB_ALLOCATOR);
+    if (!allocator) {
+        allocator = new SlabAllocator();
+        context->set(
+            LoopContext::SLAB_ALLOCATOR,
+            allocator,
+            destroy<SlabAllocator>);
+    }
+    return static_cast<SlabAllocator*>(allocator);
+}
+
+}  // namespace uv
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_DETAIL_UV_SLAB_ALLOCATOR_H_
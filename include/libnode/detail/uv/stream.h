@@ -5,6 +5,7 @@
 
 #include <libnode/invoke.h>
 #include <libnode/detail/uv/handle.h>
+#include <libnode/detail/uv/slab_allocator.h>
 #include <libnode/detail/uv/write.h>
 
 namespace libj {
@@ -20,7 +21,11 @@ class Stream : public Handle {
     Stream(uv_stream_t* stream)
         : Handle(reinterpret_cast<uv_handle_t*>(stream))
         , stream_(stream)
-        , buffer_(Buffer::null())
+        , slab_(Buffer::null())
+        , slabOffset_(0)
+        , readSize_(MIN_READ_SIZE * 8)
+        , acceptPaused_(false)
+        , acceptPending_(false)
         , owner_(NULL)
         , onRead_(JsFunction::null())
         , onConnection_(JsFunction::null()) {
@@ -37,6 +42,10 @@ class Stream : public Handle {
         stream_->data = this;
     }
 
+    uv_stream_t* stream() const {
+        return stream_;
+    }
+
     void setOwner(void* owner) {
         owner_ = owner;
     }
@@ -49,6 +58,29 @@ class Stream : public Handle {
         onConnection_ = callback;
     }
 
+    // a connection arriving while paused is left unaccepted, which makes
+    // libuv stop polling the listening socket, so the rest of them wait
+    // in the backlog instead of being accepted and closed
+    void pauseAccept() {
+        acceptPaused_ = true;
+    }
+
+    void resumeAccept() {
+        acceptPaused_ = false;
+        if (acceptPending_) {
+            acceptPending_ = false;
+            accept();
+        }
+    }
+
+    Boolean isAcceptPaused() const {
+        return acceptPaused_;
+    }
+
+    Size writeQueueSize() const {
+        return stream_->write_queue_size;
+    }
+
     Int readStart() {
         return uv_read_start(stream_, onAlloc, onRead);
     }
@@ -85,10 +117,83 @@ class Stream : public Handle {
         return err;
     }
 
+    // returns the number of bytes written synchronously
+    Size tryWrite(Buffer::CPtr buf) {
+        uv_buf_t uvBuf;
+        uvBuf.base = static_cast<char*>(const_cast<void*>(buf->data()));
+        uvBuf.len = buf->length();
+        int r = uv_try_write(stream_, &uvBuf, 1);
+        return r > 0 ? static_cast<Size>(r) : 0;
+    }
+
+    Size tryWrite(JsArray::CPtr bufs) {
+        const Size kMaxBufs = 16;
+        uv_buf_t uvBufs[kMaxBufs];
+
+        // a partial write is fine, so the rest is simply left queued
+        Size nbufs = bufs->length();
+        if (nbufs > kMaxBufs) nbufs = kMaxBufs;
+        for (Size i = 0; i < nbufs; i++) {
+            Buffer::CPtr buf = bufs->getCPtr<Buffer>(i);
+            uvBufs[i].base =
+                static_cast<char*>(const_cast<void*>(buf->data()));
+            uvBufs[i].len = buf->length();
+        }
+        int r = uv_try_write(
+            stream_, uvBufs, static_cast<unsigned int>(nbufs));
+        return r > 0 ? static_cast<Size>(r) : 0;
+    }
+
+    Int writeBuffers(
+        JsArray::CPtr bufs,
+        JsFunction::Ptr onComplete,
+        JsFunction::Ptr cb) {
+        const Size kMaxStackBufs = 16;
+        uv_buf_t stackBufs[kMaxStackBufs];
+
+        Size nbufs = bufs->length();
+        uv_buf_t* uvBufs = nbufs > kMaxStackBufs
+            ? new uv_buf_t[nbufs]
+            : stackBufs;
+
+        Size length = 0;
+        for (Size i = 0; i < nbufs; i++) {
+            Buffer::CPtr buf = bufs->getCPtr<Buffer>(i);
+            assert(buf);
+            uvBufs[i].base =
+                static_cast<char*>(const_cast<void*>(buf->data()));
+            uvBufs[i].len = buf->length();
+            length += buf->length();
+        }
+
+        Write* req = new Write();
+        req->buffers = bufs;
+        req->bytes = length;
+        req->onComplete = onComplete;
+        req->cb = cb;
+        req->dispatched();
+
+        // uv_write copies the uv_buf_t array
+        int err = uv_write(
+                    &req->req,
+                    stream_,
+                    uvBufs,
+                    static_cast<unsigned int>(nbufs),
+                    afterWrite);
+        if (uvBufs != stackBufs) {
+            delete[] uvBufs;
+        }
+        if (err) {
+            delete req;
+        }
+        return err;
+    }
+
+    // sendHandle is passed along with the string over an ipc pipe
     Write* writeString(
         String::CPtr str,
         Buffer::Encoding enc,
-        uv_stream_t* sendStream = NULL) {
+        Stream* sendHandle = NULL) {
         Buffer::Ptr buf = Buffer::create(str, enc);
         Write* req = new Write();
         req->buffer = buf;
@@ -116,7 +221,7 @@ class Stream : public Handle {
                     stream_,
                     &uvBuf,
                     1,
-                    sendStream,
+                    sendHandle ? sendHandle->stream_ : NULL,
                     afterWrite);
         }
 
@@ -148,11 +253,26 @@ class Stream : public Handle {
         uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
         Stream* stream = static_cast<Stream*>(handle->data);
         assert(stream->stream_ == reinterpret_cast<uv_stream_t*>(handle));
-        stream->buffer_ = Buffer::create(suggestedSize);
+        if (stream->readSize_ > suggestedSize) {
+            stream->readSize_ = suggestedSize;
+        }
+        buf->base = slabAllocator(handle->loop)->allocate(
+            stream->readSize_, &stream->slab_, &stream->slabOffset_);
+        buf->len = stream->readSize_;
+    }
 
-        buf->base = static_cast<char*>(
-            const_cast<void*>(stream->buffer_->data()));
-        buf->len = suggestedSize;
+    Buffer::Ptr shrinkReadBuffer(Size size, Size nread) {
+        Buffer::Ptr buf = slabAllocator(stream_->loop)->shrink(
+            slab_, slabOffset_, size, nread);
+        slab_ = Buffer::null();
+
+        // grow after a full read, shrink after a small one
+        if (nread == size) {
+            if (readSize_ < MAX_READ_SIZE) readSize_ <<= 1;
+        } else if (nread && nread < (size >> 2)) {
+            if (readSize_ > MIN_READ_SIZE) readSize_ >>= 1;
+        }
+        return buf;
     }
 
     static void onReadCommon(
@@ -190,6 +310,23 @@ class Stream : public Handle {
     }
 
  protected:
+    // accepts a pending connection and invokes onConnection with it
+    virtual void accept() = 0;
+
+    // for Pipe and Tcp
+    static void onConnection(uv_stream_t* handle, int status) {
+        Stream* self = static_cast<Stream*>(handle->data);
+        assert(self && self->stream_ == handle);
+
+        if (status) {
+            invoke(self->onConnection_);
+        } else if (self->acceptPaused_) {
+            self->acceptPending_ = true;
+        } else {
+            self->accept();
+        }
+    }
+
     // for Pipe and Tcp
     static void afterConnect(uv_connect_t* req, int status) {
         Connect* creq = static_cast<Connect*>(req->data);
@@ -208,8 +345,15 @@ class Stream : public Handle {
     }
 
  protected:
+    static const Size MIN_READ_SIZE = 1024;
+    static const Size MAX_READ_SIZE = 64 * 1024;
+
     uv_stream_t* stream_;
-    Buffer::Ptr buffer_;
+    Buffer::Ptr slab_;
+    Size slabOffset_;
+    Size readSize_;
+    Boolean acceptPaused_;
+    Boolean acceptPending_;
     void* owner_;
     JsFunction::Ptr onRead_;
     JsFunction::Ptr onConnection_;
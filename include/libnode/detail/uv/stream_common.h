@@ -21,7 +21,7 @@ inline void Stream::onReadCommon(
 
     if (nread < 0)  {
         if (buf->base) {
-            stream->buffer_ = Buffer::null();
+            stream->shrinkReadBuffer(buf->len, 0);
         }
 
         if (onRead) invoke(onRead, nread, Buffer::null());
@@ -30,25 +30,38 @@ inline void Stream::onReadCommon(
 
     if (nread == 0) {
         if (buf->base) {
-            stream->buffer_ = Buffer::null();
+            stream->shrinkReadBuffer(buf->len, 0);
         }
         return;
     }
 
     assert(buf->base);
     assert(static_cast<size_t>(nread) <= buf->len);
-    stream->buffer_ = stream->buffer_->slice(0, nread);
-
-    // TODO(plenluno): create pendingObj
-    // Stream* pendingObj = NULL;
-    // if (type == UV_TCP) {
-    //     pendingObj = new Tcp();
-    // } else if (type == UV_NAMED_PIPE) {
-    //     pendingObj = new Pipe();
-    // } else {
-    //     assert(pending == UV_UNKNOWN_HANDLE);
-    // }
-    if (onRead) invoke(onRead, nread, stream->buffer_);
+    Buffer::Ptr buffer = stream->shrinkReadBuffer(buf->len, nread);
+
+    // the receiver of a handle over an ipc pipe takes ownership of it
+    Stream* pendingObj = NULL;
+    if (pending == UV_TCP) {
+        pendingObj = new Tcp(handle->loop);
+    } else if (pending == UV_NAMED_PIPE) {
+        pendingObj = new Pipe(false, handle->loop);
+    } else {
+        assert(pending == UV_UNKNOWN_HANDLE);
+    }
+    if (pendingObj && uv_accept(handle, pendingObj->stream_)) {
+        pendingObj->close();
+        pendingObj = NULL;
+    }
+
+    if (pendingObj) {
+        if (onRead) {
+            invoke(onRead, nread, buffer, pendingObj);
+        } else {
+            pendingObj->close();
+        }
+    } else {
+        if (onRead) invoke(onRead, nread, buffer);
+    }
 }
 
 }  // namespace uv
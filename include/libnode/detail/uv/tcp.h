@@ -3,8 +3,15 @@
 #ifndef LIBNODE_DETAIL_UV_TCP_H_
 #define LIBNODE_DETAIL_UV_TCP_H_
 
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/stream.h>
 
+#include <errno.h>
+#ifdef LIBJ_PF_UNIX
+# include <sys/socket.h>
+# include <unistd.h>
+#endif
+
 namespace libj {
 namespace node {
 namespace detail {
@@ -12,8 +19,9 @@ namespace uv {
 
 class Tcp : public Stream {
  public:
-    Tcp() : Stream(reinterpret_cast<uv_stream_t*>(&tcp_)) {
-        int r = uv_tcp_init(uv_default_loop(), &tcp_);
+    Tcp(uv_loop_t* loop)
+        : Stream(reinterpret_cast<uv_stream_t*>(&tcp_)) {
+        int r = uv_tcp_init(loop, &tcp_);
         assert(r == 0);
     }
 
@@ -60,6 +68,24 @@ class Tcp : public Stream {
         return uv_tcp_keepalive(&tcp_, enable ? 1 : 0, delay);
     }
 
+    // the socket is created here, since the option must be set before bind
+    Int reusePort(Int family) {
+#ifdef SO_REUSEPORT
+        int fd = socket(family, SOCK_STREAM, 0);
+        if (fd < 0) return -errno;
+
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on))) {
+            int err = -errno;
+            ::close(fd);
+            return err;
+        }
+        return uv_tcp_open(&tcp_, fd);
+#else
+        return UV_ENOTSUP;
+#endif
+    }
+
     Int bind(String::CPtr ip, Int port = 0) {
         assert(ip);
         struct sockaddr_in addr;
@@ -102,21 +128,17 @@ class Tcp : public Stream {
         return conn(reinterpret_cast<const sockaddr*>(&addr), onComplete);
     }
 
- private:
-    static void onConnection(uv_stream_t* handle, int status) {
-        Tcp* self = static_cast<Tcp*>(handle->data);
-        assert(self && self->stream_ == handle);
-
-        if (status) {
-            invoke(self->onConnection_);
-            return;
+ protected:
+    virtual void accept() {
+        Tcp* tcp = new Tcp(stream_->loop);
+        if (uv_accept(stream_, tcp->stream_)) {
+            tcp->close();
         } else {
-            Tcp* tcp = new Tcp();
-            if (uv_accept(handle, tcp->stream_)) return;
-            invoke(self->onConnection_, tcp);
+            invoke(onConnection_, tcp);
         }
     }
 
+ private:
     Int conn(const sockaddr* addr, JsFunction::Ptr onComplete) {
         Connect* creq = new Connect();
         creq->onComplete = onComplete;
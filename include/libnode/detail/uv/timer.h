@@ -1,10 +1,12 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_UV_TIMER_H_
 #define LIBNODE_DETAIL_UV_TIMER_H_
 
 #include <libnode/invoke.h>
+#include <libnode/detail/loop_monitor.h>
 #include <libnode/detail/uv/handle.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/write.h>
 
 #include <libj/detail/gc_delete.h>
@@ -16,10 +18,11 @@ namespace uv {
 
 class Timer : public Handle {
  public:
-    Timer()
+    Timer(uv_loop_t* loop)
         : Handle(reinterpret_cast<uv_handle_t*>(&timer_))
+        , deadline_(0)
         , onTimeout_(JsFunction::null()) {
-        Int r = uv_timer_init(uv_default_loop(), &timer_);
+        Int r = uv_timer_init(loop, &timer_);
         assert(r == 0);
         timer_.data = this;
     }
@@ -29,6 +32,7 @@ class Timer : public Handle {
     }
 
     Int start(Long timeout, Long repeat) {
+        deadline_ = uv_now(timer_.loop) + timeout;
         return uv_timer_start(&timer_, onTimeout, timeout, repeat);
     }
 
@@ -37,6 +41,7 @@ class Timer : public Handle {
     }
 
     Int again() {
+        deadline_ = uv_now(timer_.loop) + uv_timer_get_repeat(&timer_);
         return uv_timer_again(&timer_);
     }
 
@@ -56,11 +61,17 @@ class Timer : public Handle {
  private:
     static void onTimeout(uv_timer_t* handle) {
         Timer* self = static_cast<Timer*>(handle->data);
+        monitorTimer(handle->loop, self->deadline_);
+
+        // libuv re-arms a repeating timer before calling back
+        Long repeat = uv_timer_get_repeat(handle);
+        if (repeat) self->deadline_ = uv_now(handle->loop) + repeat;
         if (self->onTimeout_) invoke(self->onTimeout_);
     }
 
  private:
     uv_timer_t timer_;
+    ULong deadline_;
     JsFunction::Ptr onTimeout_;
 };
 
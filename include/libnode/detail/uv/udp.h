@@ -5,6 +5,7 @@
 
 #include <libnode/invoke.h>
 #include <libnode/detail/uv/handle.h>
+#include <libnode/detail/uv/loop.h>
 #include <libnode/detail/uv/udp_send.h>
 
 namespace libj {
@@ -14,11 +15,11 @@ namespace uv {
 
 class Udp : public Handle {
  public:
-    Udp()
+    Udp(uv_loop_t* loop)
         : Handle(reinterpret_cast<uv_handle_t*>(&udp_))
         , buffer_(Buffer::null())
         , onMessage_(JsFunction::null()) {
-        int r = uv_udp_init(uv_default_loop(), &udp_);
+        int r = uv_udp_init(loop, &udp_);
         assert(r == 0);
     }
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_DETAIL_UV_WRITE_H_
 #define LIBNODE_DETAIL_UV_WRITE_H_
@@ -16,10 +16,12 @@ class Write : public Req<uv_write_t> {
     Write()
         : bytes(0)
         , buffer(Buffer::null())
+        , buffers(JsArray::null())
         , cb(JsFunction::null()) {}
 
     Size bytes;
     Buffer::CPtr buffer;
+    JsArray::CPtr buffers;
     JsFunction::Ptr cb;
 };
 
@@ -1,10 +1,11 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_HTTP_H_
 #define LIBNODE_HTTP_H_
 
 #include <libnode/http/agent.h>
 #include <libnode/http/header.h>
+#include <libnode/http/header_template.h>
 #include <libnode/http/method.h>
 #include <libnode/http/option.h>
 #include <libnode/http/server.h>
@@ -26,6 +27,10 @@ ClientRequest::Ptr request(const Value& options, JsFunction::Ptr callback);
 
 ClientRequest::Ptr get(const Value& options, JsFunction::Ptr callback);
 
+Size maxFreeParsers();
+
+void setMaxFreeParsers(Size max);
+
 }  // namespace http
 }  // namespace node
 }  // namespace libj
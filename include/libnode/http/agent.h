@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_HTTP_AGENT_H_
 #define LIBNODE_HTTP_AGENT_H_
@@ -16,6 +16,22 @@ class Agent : LIBNODE_EVENT_EMITTER(Agent)
     virtual Size maxSockets() const = 0;
 
     virtual void setMaxSockets(Size max) = 0;
+
+    virtual Boolean keepAlive() const = 0;
+
+    virtual Size maxFreeSockets() const = 0;
+
+    virtual void setMaxFreeSockets(Size max) = 0;
+
+    virtual UInt freeSocketTimeout() const = 0;
+
+    virtual void setFreeSocketTimeout(UInt msecs) = 0;
+
+    virtual Size freeSocketHits() const = 0;
+
+    virtual Size freeSocketMisses() const = 0;
+
+    virtual void destroy() = 0;
 };
 
 }  // namespace http
@@ -0,0 +1,43 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_HTTP_HEADER_TEMPLATE_H_
+#define LIBNODE_HTTP_HEADER_TEMPLATE_H_
+
+#include <libnode/buffer.h>
+
+#include <libj/immutable.h>
+#include <libj/js_object.h>
+
+namespace libj {
+namespace node {
+namespace http {
+
+// a fixed set of headers serialized once, and copied into every
+// message it is attached to. a header set on the message itself
+// replaces the template lines of the same name.
+// Connection, Content-Length, Date, Expect and Transfer-Encoding decide
+// the framing of each message, so they are set per message instead.
+class HeaderTemplate : LIBJ_IMMUTABLE(HeaderTemplate)
+ public:
+    // the values are Strings, numbers or JsArrays of them.
+    // returns null if headers have one of the per-message headers above.
+    static CPtr create(JsObject::CPtr headers);
+
+    virtual Boolean has(String::CPtr name) const = 0;
+
+    // the value of the header, or undefined
+    virtual Value get(String::CPtr name) const = 0;
+
+    // "Name: value\r\n" for each header
+    virtual Buffer::CPtr toBuffer() const = 0;
+
+    // the lines except those of the headers whose lowercase names
+    // are the keys of omitted
+    virtual Buffer::CPtr toBuffer(JsObject::CPtr omitted) const = 0;
+};
+
+}  // namespace http
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_HTTP_HEADER_TEMPLATE_H_
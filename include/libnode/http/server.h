@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_HTTP_SERVER_H_
 #define LIBNODE_HTTP_SERVER_H_
@@ -23,6 +23,10 @@ class Server : LIBNODE_NET_SERVER(Server)
 
     virtual void setMaxHeadersCount(Size max) = 0;
 
+    virtual Boolean lazyHeaders() const = 0;
+
+    virtual void setLazyHeaders(Boolean lazy) = 0;
+
     virtual UInt timeout() const = 0;
 
     virtual void setTimeout(
@@ -1,9 +1,10 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_HTTP_SERVER_RESPONSE_H_
 #define LIBNODE_HTTP_SERVER_RESPONSE_H_
 
 #include <libnode/stream/writable.h>
+#include <libnode/http/header_template.h>
 
 namespace libj {
 namespace node {
@@ -26,6 +27,9 @@ class ServerResponse : LIBNODE_STREAM_WRITABLE(ServerResponse)
 
     virtual void removeHeader(String::CPtr name) = 0;
 
+    // written before the headers set by setHeader or writeHead
+    virtual void setHeaderTemplate(HeaderTemplate::CPtr tmpl) = 0;
+
     virtual void addTrailers(JsObject::CPtr headers) = 0;
 
     virtual Boolean headersSent() const = 0;
@@ -1,10 +1,11 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_IMPL_BUFFER_H_
 #define LIBNODE_IMPL_BUFFER_H_
 
 #include <libnode/util.h>
 #include <libnode/config.h>
+#include <libnode/detail/util/utf.h>
 
 #include <libj/exception.h>
 
@@ -16,25 +17,22 @@ inline Boolean Buffer::isBuffer(const Value& val) {
 }
 
 inline Size Buffer::byteLength(String::CPtr str, Encoding enc) {
-    if (str) {
-        if (enc == NONE || enc == UTF8) {
-            return str->toStdString().length();
-#ifdef LIBJ_USE_UTF32
-        } else if (enc == UTF16BE || enc == UTF16LE) {
-            return str->toStdU16String().length() << 1;
-        } else if (enc == UTF32BE || enc == UTF32LE) {
-            return str->length() << 2;
-#else
-        } else if (enc == UTF16BE || enc == UTF16LE) {
-            return str->length() << 1;
-        } else if (enc == UTF32BE || enc == UTF32LE) {
-            return str->toStdU32String().length() << 2;
-#endif
-        } else {
-            return create(str, enc)->length();
-        }
-    } else {
-        return 0;
+    if (!str) return 0;
+
+    const detail::util::Unit* src = detail::util::units(str->data());
+    Size len = str->length();
+    switch (enc) {
+    case NONE:
+    case UTF8:
+        return detail::util::utf8Length(src, len);
+    case UTF16BE:
+    case UTF16LE:
+        return detail::util::utf16Length(src, len);
+    case UTF32BE:
+    case UTF32LE:
+        return detail::util::utf32Length(src, len);
+    default:
+        return create(str, enc)->length();
     }
 }
 
@@ -0,0 +1,10 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_IMPL_CLUSTER_WORKER_H_
+#define LIBNODE_IMPL_CLUSTER_WORKER_H_
+
+#define LIBNODE_CLUSTER_WORKER_INSTANCEOF(ID) \
+    (ID == libj::Type<libj::node::cluster::Worker>::id() \
+        || LIBNODE_EVENT_EMITTER_INSTANCEOF(ID))
+
+#endif  // LIBNODE_IMPL_CLUSTER_WORKER_H_
@@ -1,20 +1,23 @@
-// Copyright (c) 2014 Plenluno All rights reserved.
+// Copyright (c) 2014-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_IMPL_INVOKE_H_
 #define LIBNODE_IMPL_INVOKE_H_
 
 #include <libnode/detail/arguments_list.h>
+#include <libnode/detail/loop_monitor.h>
 
 namespace libj {
 namespace node {
 
 inline Value invoke(JsFunction::Ptr func) {
+    detail::monitorCallback();
     return (*func)();
 }
 
 inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     Value res = (*func)(args);
@@ -25,6 +28,7 @@ inline Value invoke(
 inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1, const Value& arg2) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -36,6 +40,7 @@ inline Value invoke(
 inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1, const Value& arg2, const Value& arg3) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -49,6 +54,7 @@ inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -63,6 +69,7 @@ inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4, const Value& arg5) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -78,6 +85,7 @@ inline Value invoke(
     JsFunction::Ptr func,
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4, const Value& arg5, const Value& arg6) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -95,6 +103,7 @@ inline Value invoke(
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4, const Value& arg5, const Value& arg6,
     const Value& arg7) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -113,6 +122,7 @@ inline Value invoke(
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4, const Value& arg5, const Value& arg6,
     const Value& arg7, const Value& arg8) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -132,6 +142,7 @@ inline Value invoke(
     const Value& arg1, const Value& arg2, const Value& arg3,
     const Value& arg4, const Value& arg5, const Value& arg6,
     const Value& arg7, const Value& arg8, const Value& arg9) {
+    detail::monitorCallback();
     LIBNODE_ARGUMENTS_ALLOC(args);
     args->add(arg1);
     args->add(arg2);
@@ -0,0 +1,27 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_LOOP_H_
+#define LIBNODE_LOOP_H_
+
+#include <libj/js_object.h>
+#include <libj/js_function.h>
+
+namespace libj {
+namespace node {
+
+class Loop : LIBJ_JS_OBJECT(Loop)
+ public:
+    static Ptr create();
+
+    // runs setup and then the loop on a new thread.
+    // the loop ends when it has no more active handles,
+    // so the objects created in setup belong to the loop.
+    virtual Boolean start(JsFunction::Ptr setup) = 0;
+
+    virtual Boolean join() = 0;
+};
+
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_LOOP_H_
@@ -0,0 +1,33 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_MONITOR_H_
+#define LIBNODE_MONITOR_H_
+
+#include <libj/js_object.h>
+
+namespace libj {
+namespace node {
+namespace monitor {
+
+// starts measuring the loop of the current thread.
+// the monitor does not keep the loop alive.
+Boolean start();
+
+Boolean stop();
+
+Boolean isActive();
+
+void reset();
+
+// histograms keyed by "iterationTime", "pollTime", "timerDrift" and
+// "callbacks", each with count, min, max, mean, p50, p90, p99 and p999.
+// the times are in microseconds, and pollTime is the time the poll
+// phase is blocked for. callbacks counts the invoked callbacks
+// per iteration.
+JsObject::Ptr stats();
+
+}  // namespace monitor
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_MONITOR_H_
@@ -1,4 +1,4 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_NET_H_
 #define LIBNODE_NET_H_
@@ -6,6 +6,7 @@
 #include <libnode/net/option.h>
 #include <libnode/net/socket.h>
 #include <libnode/net/server.h>
+#include <libnode/net/write_stats.h>
 
 namespace libj {
 namespace node {
@@ -17,6 +18,10 @@ Boolean isIPv4(String::CPtr ip);
 
 Boolean isIPv6(String::CPtr ip);
 
+// the counters are per loop. returns those of the current loop,
+// which the servers and sockets on other loops do not add to.
+WriteStats writeStats();
+
 Socket::Ptr connect(
     JsObject::CPtr options,
     JsFunction::Ptr onConnect = JsFunction::null());
@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_NET_OPTION_H_
 #define LIBNODE_NET_OPTION_H_
@@ -14,7 +14,9 @@ namespace net {
     GEN(OPTION_PORT,            "port") \
     GEN(OPTION_HOST,            "host") \
     GEN(OPTION_LOCAL_ADDRESS,   "localAddress") \
-    GEN(OPTION_PATH,            "path")
+    GEN(OPTION_PATH,            "path") \
+    GEN(OPTION_REUSE_PORT,      "reusePort") \
+    GEN(OPTION_ACCEPT_BATCH,    "acceptBatch")
 
 #define LIBNODE_NET_OPTION_DECL_GEN(NAME, VAL) \
     extern Symbol::CPtr NAME;
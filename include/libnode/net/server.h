@@ -1,4 +1,4 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_NET_SERVER_H_
 #define LIBNODE_NET_SERVER_H_
@@ -27,6 +27,22 @@ class Server : LIBNODE_EVENT_EMITTER(Server)
 
     virtual void setMaxConnections(Size max) = 0;
 
+    virtual Size lowConnections() const = 0;
+
+    virtual void setLowConnections(Size low) = 0;
+
+    virtual Size acceptBatch() const = 0;
+
+    virtual void setAcceptBatch(Size batch) = 0;
+
+    virtual Size accepted() const = 0;
+
+    virtual Size acceptPauses() const = 0;
+
+    virtual Boolean reusePort() const = 0;
+
+    virtual void setReusePort(Boolean reuse) = 0;
+
     virtual Boolean listen(
         Int port,
         String::CPtr host = IN_ADDR_ANY,
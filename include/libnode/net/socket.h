@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_NET_SOCKET_H_
 #define LIBNODE_NET_SOCKET_H_
@@ -17,6 +17,7 @@ class Socket : LIBNODE_STREAM_DUPLEX(Socket)
     static Symbol::CPtr OPTION_FD;
     static Symbol::CPtr OPTION_TYPE;
     static Symbol::CPtr OPTION_ALLOW_HALF_OPEN;
+    static Symbol::CPtr OPTION_HIGH_WATER_MARK;
 
     static Ptr create(JsObject::CPtr options = JsObject::null());
 
@@ -30,6 +31,20 @@ class Socket : LIBNODE_STREAM_DUPLEX(Socket)
 
     virtual Size bytesWritten() const = 0;
 
+    virtual Size bufferSize() const = 0;
+
+    virtual Size highWaterMark() const = 0;
+
+    virtual void setHighWaterMark(Size highWaterMark) = 0;
+
+    virtual Boolean writev(
+        JsArray::CPtr chunks,
+        JsFunction::Ptr callback = JsFunction::null()) = 0;
+
+    virtual void cork() = 0;
+
+    virtual void uncork() = 0;
+
     virtual Boolean connect(
         Int port,
         String::CPtr host = String::null(),
@@ -0,0 +1,26 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#ifndef LIBNODE_NET_WRITE_STATS_H_
+#define LIBNODE_NET_WRITE_STATS_H_
+
+#include <libj/typedef.h>
+
+namespace libj {
+namespace node {
+namespace net {
+
+// the socket writes of a loop.
+// an inline write completed in uv_try_write, and a queued write
+// left the rest of its bytes to uv_write.
+struct WriteStats {
+    Size inlineWrites;
+    Size queuedWrites;
+    Size inlineBytes;
+    Size queuedBytes;
+};
+
+}  // namespace net
+}  // namespace node
+}  // namespace libj
+
+#endif  // LIBNODE_NET_WRITE_STATS_H_
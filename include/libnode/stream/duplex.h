@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_STREAM_DUPLEX_H_
 #define LIBNODE_STREAM_DUPLEX_H_
@@ -26,6 +26,12 @@ class Duplex : LIBNODE_STREAM(Duplex)
 
     virtual Boolean setEncoding(Buffer::Encoding enc) = 0;
 
+    virtual Boolean pipe(
+        Stream::Ptr dest,
+        JsObject::CPtr options = JsObject::null()) = 0;
+
+    virtual Boolean unpipe(Stream::CPtr dest = Stream::null()) = 0;
+
     // Writable
     virtual Boolean writable() const = 0;
 
@@ -1,4 +1,4 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #ifndef LIBNODE_TIMER_H_
 #define LIBNODE_TIMER_H_
@@ -23,6 +23,12 @@ Boolean clearTimeout(const Value& timeoutId);
 
 Boolean clearInterval(const Value& intervalId);
 
+Value setImmediate(
+    JsFunction::Ptr callback,
+    JsArray::Ptr args = JsArray::null());
+
+Boolean clearImmediate(const Value& immediateId);
+
 }  // namespace node
 }  // namespace libj
 
@@ -1,8 +1,15 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/buffer.h>
 #include <libnode/detail/buffer.h>
 
+#ifdef LIBJ_PF_UNIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 namespace libj {
 namespace node {
 
@@ -25,59 +32,124 @@ Buffer::Ptr Buffer::create(TypedJsArray<UByte>::CPtr array) {
 
     Size length = array->length();
     detail::Buffer<Buffer>* buf(new detail::Buffer<Buffer>(length));
+    UByte* dst = static_cast<UByte*>(const_cast<void*>(buf->data()));
     for (Size i = 0; i < length; i++) {
-        buf->writeUInt8(array->getTyped(i), i);
+        dst[i] = array->getTyped(i);
     }
     return Ptr(buf);
 }
 
-template<typename T>
-static Buffer::Ptr createBuffer(T t, Buffer::Encoding enc) {
-    if (!t) return Buffer::null();
+Buffer::Ptr Buffer::create(String::CPtr str, Buffer::Encoding enc) {
+    if (!str) return null();
 
-    std::string s;
     switch (enc) {
-    case Buffer::UTF8:
-        s = t->toStdString();
-        return Buffer::create(
-            reinterpret_cast<const UByte*>(s.c_str()),
-            s.length());
-    case Buffer::UTF16BE:
-        s = t->toStdString(String::UTF16BE);
-        return Buffer::create(
-            reinterpret_cast<const UByte*>(s.c_str()),
-            s.length() - 2);  // delete the last null character
-    case Buffer::UTF16LE:
-        s = t->toStdString(String::UTF16LE);
-        return Buffer::create(
-            reinterpret_cast<const UByte*>(s.c_str()),
-            s.length() - 2);  // delete the last null character
-    case Buffer::UTF32BE:
-        s = t->toStdString(String::UTF32BE);
-        return Buffer::create(
-            reinterpret_cast<const UByte*>(s.c_str()),
-            s.length() - 4);  // delete the last null character
-    case Buffer::UTF32LE:
-        s = t->toStdString(String::UTF32LE);
-        return Buffer::create(
-            reinterpret_cast<const UByte*>(s.c_str()),
-            s.length() - 4);  // delete the last null character
-    case Buffer::BASE64:
-        return util::base64Decode(t);
-    case Buffer::HEX:
-        return util::hexDecode(t);
+    case UTF8:
+    case UTF16BE:
+    case UTF16LE:
+    case UTF32BE:
+    case UTF32LE:
+        {
+            Size length = byteLength(str, enc);
+            detail::Buffer<Buffer>* buf(new detail::Buffer<Buffer>(length));
+            UByte* dst = static_cast<UByte*>(const_cast<void*>(buf->data()));
+            detail::encodeString<Buffer>(str, enc, dst, length);
+            return Ptr(buf);
+        }
+    case BASE64:
+        return util::base64Decode(str);
+    case HEX:
+        return util::hexDecode(str);
     default:
-        return Buffer::null();
+        return null();
     }
 }
 
-Buffer::Ptr Buffer::create(String::CPtr str, Buffer::Encoding enc) {
-    return createBuffer<String::CPtr>(str, enc);
+Buffer::Ptr Buffer::create(StringBuilder::CPtr sb, Buffer::Encoding enc) {
+    if (!sb) return null();
+
+    return create(sb->toString(), enc);
 }
 
-Buffer::Ptr Buffer::create(StringBuilder::CPtr sb, Buffer::Encoding enc) {
-    return createBuffer<StringBuilder::CPtr>(sb, enc);
+class ExternalDeleter {
+ public:
+    ExternalDeleter(Buffer::Deleter deleter) : deleter_(deleter) {}
+
+    void operator()(void* data) {
+        if (deleter_) deleter_(data);
+    }
+
+ private:
+    Buffer::Deleter deleter_;
+};
+
+Buffer::Ptr Buffer::createExternal(
+    void* data, Size length, Buffer::Deleter deleter) {
+    if (!data) return null();
+
+    detail::BufferStorage storage(data, ExternalDeleter(deleter));
+    return Ptr(new detail::Buffer<Buffer>(
+        storage, static_cast<UByte*>(data), length));
 }
 
+#ifdef LIBJ_PF_UNIX
+
+class Unmapper {
+ public:
+    Unmapper(Size length) : length_(length) {}
+
+    void operator()(void* addr) {
+        munmap(addr, length_);
+    }
+
+ private:
+    Size length_;
+};
+
+Buffer::Ptr Buffer::createMapped(
+    String::CPtr path, Size offset, Size length) {
+    if (!path) return null();
+
+    Int fd = open(path->toStdString().c_str(), O_RDONLY);
+    if (fd < 0) return null();
+
+    struct stat st;
+    if (fstat(fd, &st) || offset > static_cast<Size>(st.st_size)) {
+        close(fd);
+        return null();
+    }
+
+    Size remain = static_cast<Size>(st.st_size) - offset;
+    if (length > remain) length = remain;
+    if (!length) {
+        close(fd);
+        return create();
+    }
+
+    // the offset of mmap must be aligned to a page
+    Size skip = offset % static_cast<Size>(sysconf(_SC_PAGESIZE));
+    void* addr = mmap(
+        NULL,
+        length + skip,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE,
+        fd,
+        static_cast<off_t>(offset - skip));
+    close(fd);
+    if (addr == MAP_FAILED) return null();
+
+    detail::BufferStorage storage(addr, Unmapper(length + skip));
+    return Ptr(new detail::Buffer<Buffer>(
+        storage, static_cast<UByte*>(addr) + skip, length));
+}
+
+#else  // LIBJ_PF_UNIX
+
+Buffer::Ptr Buffer::createMapped(
+    String::CPtr path, Size offset, Size length) {
+    return null();
+}
+
+#endif  // LIBJ_PF_UNIX
+
 }  // namespace node
 }  // namespace libj
@@ -0,0 +1,14 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/buffer_list.h>
+#include <libnode/detail/buffer_list.h>
+
+namespace libj {
+namespace node {
+
+BufferList::Ptr BufferList::create() {
+    return Ptr(new detail::BufferList<BufferList>());
+}
+
+}  // namespace node
+}  // namespace libj
@@ -0,0 +1,38 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/cluster.h>
+#include <libnode/detail/cluster/worker.h>
+
+namespace libj {
+namespace node {
+namespace cluster {
+
+Boolean isMaster() {
+    return !isWorker();
+}
+
+Boolean isWorker() {
+    return !!getenv(detail::cluster::ENV_WORKER_ID);
+}
+
+Worker::Ptr fork(JsArray::CPtr args, JsObject::CPtr env) {
+    // only the default loop touches nextId and the shared handles
+    static Int nextId = 1;
+
+    if (isWorker()) return Worker::null();
+    if (detail::uv::currentLoop() != uv_default_loop()) return Worker::null();
+
+    return detail::cluster::Worker::fork(nextId++, args, env);
+}
+
+Worker::Ptr worker() {
+    return detail::cluster::Worker::self();
+}
+
+JsArray::CPtr workers() {
+    return detail::cluster::workers();
+}
+
+}  // namespace cluster
+}  // namespace node
+}  // namespace libj
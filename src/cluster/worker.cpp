@@ -0,0 +1,17 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/cluster/worker.h>
+
+namespace libj {
+namespace node {
+namespace cluster {
+
+LIBJ_SYMBOL_DEF(Worker::EVENT_ONLINE,     "online");
+LIBJ_SYMBOL_DEF(Worker::EVENT_LISTENING,  "listening");
+LIBJ_SYMBOL_DEF(Worker::EVENT_MESSAGE,    "message");
+LIBJ_SYMBOL_DEF(Worker::EVENT_DISCONNECT, "disconnect");
+LIBJ_SYMBOL_DEF(Worker::EVENT_EXIT,       "exit");
+
+}  // namespace cluster
+}  // namespace node
+}  // namespace libj
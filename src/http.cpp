@@ -1,8 +1,9 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/http.h>
 #include <libnode/url.h>
 #include <libnode/detail/http/client_request.h>
+#include <libnode/detail/http/parser_list.h>
 
 namespace libj {
 namespace node {
@@ -51,6 +52,14 @@ ClientRequest::Ptr get(
     return req;
 }
 
+Size maxFreeParsers() {
+    return detail::http::parserList()->max();
+}
+
+void setMaxFreeParsers(Size max) {
+    detail::http::parserList()->setMax(max);
+}
+
 }  // namespace http
 }  // namespace node
 }  // namespace libj
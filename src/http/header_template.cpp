@@ -0,0 +1,76 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/http/header_template.h>
+#include <libnode/detail/http/header_template.h>
+#include <libnode/detail/http/header_writer.h>
+
+namespace libj {
+namespace node {
+namespace http {
+
+static Boolean isPerMessage(String::CPtr lowerName) {
+    return lowerName->equals(LHEADER_CONNECTION)
+        || lowerName->equals(LHEADER_CONTENT_LENGTH)
+        || lowerName->equals(LHEADER_DATE)
+        || lowerName->equals(LHEADER_EXPECT)
+        || lowerName->equals(LHEADER_TRANSFER_ENCODING);
+}
+
+typedef detail::http::HeaderTemplate<HeaderTemplate> HeaderTemplateImpl;
+
+static void write(
+    detail::http::HeaderWriter* writer,
+    HeaderTemplateImpl::Lines* lines,
+    String::CPtr name,
+    String::CPtr lowerName,
+    const Value& value) {
+    HeaderTemplateImpl::Line line;
+    line.name = lowerName;
+    line.begin = writer->length();
+    writer->append(name);
+    writer->appendLiteral(": ");
+    writer->appendValue(value);
+    writer->appendCRLF();
+    line.end = writer->length();
+    lines->push_back(line);
+}
+
+HeaderTemplate::CPtr HeaderTemplate::create(JsObject::CPtr headers) {
+    if (!headers) return null();
+
+    detail::http::HeaderWriter writer;
+    HeaderTemplateImpl::Lines lines;
+    JsObject::Ptr values = JsObject::create();
+    typedef JsObject::Entry Entry;
+    TypedSet<Entry::CPtr>::CPtr entrys = headers->entrySet();
+    TypedIterator<Entry::CPtr>::Ptr itr = entrys->iteratorTyped();
+    while (itr->hasNext()) {
+        Entry::CPtr entry = itr->nextTyped();
+        String::CPtr name = toCPtr<String>(entry->getKey());
+        if (!name) return null();
+
+        String::CPtr lowerName =
+            detail::http::scanHeaderField<Char>(name->data(), name->length());
+        if (isPerMessage(lowerName)) return null();
+
+        Value value = entry->getValue();
+        JsArray::CPtr ary = toCPtr<JsArray>(value);
+        if (ary) {
+            Size len = ary->length();
+            for (Size i = 0; i < len; i++) {
+                write(&writer, &lines, name, lowerName, ary->get(i));
+            }
+            values->put(lowerName, value);
+        } else {
+            write(&writer, &lines, name, lowerName, value);
+            values->put(lowerName, String::valueOf(value));
+        }
+    }
+    // an exact copy, not a slice that would keep the whole slab
+    Buffer::CPtr buf = Buffer::create(writer.data(), writer.length());
+    return CPtr(new HeaderTemplateImpl(buf, values, lines));
+}
+
+}  // namespace http
+}  // namespace node
+}  // namespace libj
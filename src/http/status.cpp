@@ -1,9 +1,12 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/http/status.h>
+#include <libnode/detail/http/header_writer.h>
 
 #include <libj/detail/status.h>
 
+#include <string>
+
 namespace libj {
 namespace node {
 namespace http {
@@ -59,6 +62,9 @@ namespace http {
 #define LIBNODE_HTTP_STATUS_MSG_GEN(NAME, MESSAGE) \
     LIBJ_STATIC_CONST_STRING_DEF(MSG_##NAME, MESSAGE)
 
+#define LIBNODE_HTTP_STATUS_TEXT_GEN(NAME, MESSAGE) \
+    static const char TEXT_##NAME[] = MESSAGE;
+
 #define LIBNODE_HTTP_STATUS_CASE_GEN(NAME, MESSAGE) \
     case NAME: { \
         static CPtr STATUS_##NAME( \
@@ -67,6 +73,7 @@ namespace http {
     }
 
 LIBNODE_HTTP_STATUS_MSG_MAP(LIBNODE_HTTP_STATUS_MSG_GEN);
+LIBNODE_HTTP_STATUS_MSG_MAP(LIBNODE_HTTP_STATUS_TEXT_GEN);
 
 Status::CPtr Status::create(Int code, String::CPtr msg) {
     LIBJ_STATIC_SYMBOL_DEF(symUnknown, "Unknown");
@@ -83,5 +90,29 @@ Status::CPtr Status::create(Int code, String::CPtr msg) {
 }
 
 }  // namespace http
+
+namespace detail {
+namespace http {
+
+// the codes come from status.h, and each line is assembled once
+#define LIBNODE_HTTP_STATUS_LINE_GEN(CODE, NAME) \
+    case CODE: { \
+        static const std::string LINE = \
+            std::string("HTTP/1.1 " #CODE " ") + \
+            node::http::TEXT_##NAME + "\r\n"; \
+        *length = LINE.length(); \
+        return LINE.data(); \
+    }
+
+const char* statusLine(Int code, Size* length) {
+    switch (code) {
+        LIBNODE_HTTP_STATUS_MAP(LIBNODE_HTTP_STATUS_LINE_GEN);
+    default:
+        return NULL;
+    }
+}
+
+}  // namespace http
+}  // namespace detail
 }  // namespace node
 }  // namespace libj
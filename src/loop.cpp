@@ -0,0 +1,14 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/loop.h>
+#include <libnode/detail/loop.h>
+
+namespace libj {
+namespace node {
+
+Loop::Ptr Loop::create() {
+    return Ptr(new detail::Loop<Loop>());
+}
+
+}  // namespace node
+}  // namespace libj
@@ -0,0 +1,80 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/monitor.h>
+#include <libnode/detail/loop_monitor.h>
+
+#include <libj/symbol.h>
+
+namespace libj {
+namespace node {
+namespace monitor {
+
+static JsObject::Ptr toJs(const detail::Histogram& hist) {
+    LIBJ_STATIC_SYMBOL_DEF(symCount, "count");
+    LIBJ_STATIC_SYMBOL_DEF(symMin,   "min");
+    LIBJ_STATIC_SYMBOL_DEF(symMax,   "max");
+    LIBJ_STATIC_SYMBOL_DEF(symMean,  "mean");
+    LIBJ_STATIC_SYMBOL_DEF(symP50,   "p50");
+    LIBJ_STATIC_SYMBOL_DEF(symP90,   "p90");
+    LIBJ_STATIC_SYMBOL_DEF(symP99,   "p99");
+    LIBJ_STATIC_SYMBOL_DEF(symP999,  "p999");
+
+    JsObject::Ptr obj = JsObject::create();
+    obj->put(symCount, hist.count());
+    obj->put(symMin, hist.min());
+    obj->put(symMax, hist.max());
+    obj->put(symMean, hist.mean());
+    obj->put(symP50, hist.percentile(50));
+    obj->put(symP90, hist.percentile(90));
+    obj->put(symP99, hist.percentile(99));
+    obj->put(symP999, hist.percentile(99.9));
+    return obj;
+}
+
+Boolean start() {
+    detail::LoopMonitor* monitor =
+        detail::loopMonitor(detail::uv::currentLoop(), true);
+    if (monitor->isActive()) return false;
+
+    monitor->start();
+    return true;
+}
+
+Boolean stop() {
+    detail::LoopMonitor* monitor = detail::loopMonitor();
+    if (!monitor || !monitor->isActive()) return false;
+
+    monitor->stop();
+    return true;
+}
+
+Boolean isActive() {
+    detail::LoopMonitor* monitor = detail::loopMonitor();
+    return monitor && monitor->isActive();
+}
+
+void reset() {
+    detail::LoopMonitor* monitor = detail::loopMonitor();
+    if (monitor) monitor->reset();
+}
+
+JsObject::Ptr stats() {
+    LIBJ_STATIC_SYMBOL_DEF(symIterationTime, "iterationTime");
+    LIBJ_STATIC_SYMBOL_DEF(symPollTime,      "pollTime");
+    LIBJ_STATIC_SYMBOL_DEF(symTimerDrift,    "timerDrift");
+    LIBJ_STATIC_SYMBOL_DEF(symCallbacks,     "callbacks");
+
+    detail::LoopMonitor* monitor = detail::loopMonitor();
+    if (!monitor) return JsObject::null();
+
+    JsObject::Ptr obj = JsObject::create();
+    obj->put(symIterationTime, toJs(monitor->iterationTime()));
+    obj->put(symPollTime, toJs(monitor->pollTime()));
+    obj->put(symTimerDrift, toJs(monitor->timerDrift()));
+    obj->put(symCallbacks, toJs(monitor->callbacksPerIteration()));
+    return obj;
+}
+
+}  // namespace monitor
+}  // namespace node
+}  // namespace libj
@@ -1,4 +1,4 @@
-// Copyright (c) 2012-2014 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/net.h>
 #include <libnode/detail/net/server.h>
@@ -36,6 +36,10 @@ Boolean isIPv6(String::CPtr ip) {
     return isIP(ip) == 6;
 }
 
+WriteStats writeStats() {
+    return *detail::net::writeStats();
+}
+
 Server::Ptr createServer(
     JsObject::CPtr options,
     JsFunction::Ptr onConnection) {
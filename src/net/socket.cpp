@@ -1,4 +1,4 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/detail/net/socket.h>
 
@@ -11,6 +11,7 @@ LIBJ_SYMBOL_DEF(Socket::EVENT_TIMEOUT,          "timeout");
 LIBJ_SYMBOL_DEF(Socket::OPTION_FD,              "fd");
 LIBJ_SYMBOL_DEF(Socket::OPTION_TYPE,            "type");
 LIBJ_SYMBOL_DEF(Socket::OPTION_ALLOW_HALF_OPEN, "allowHalfOpen");
+LIBJ_SYMBOL_DEF(Socket::OPTION_HIGH_WATER_MARK, "highWaterMark");
 
 Socket::Ptr Socket::create(JsObject::CPtr options) {
     return detail::net::Socket::create(options);
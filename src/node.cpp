@@ -1,6 +1,7 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/node.h>
+#include <libnode/detail/uv/loop.h>
 
 #include <uv.h>
 
@@ -8,7 +9,7 @@ namespace libj {
 namespace node {
 
 void run() {
-    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    uv_run(detail::uv::currentLoop(), UV_RUN_DEFAULT);
 }
 
 }  // namespace node
@@ -1,7 +1,8 @@
-// Copyright (c) 2012 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
 #include <libnode/timer.h>
 #include <libnode/detail/uv/timer.h>
+#include <libnode/detail/tick_queue.h>
 
 namespace libj {
 namespace node {
@@ -37,13 +38,45 @@ namespace {
         Boolean repeat_;
     };
 
+    class Immediate : LIBJ_JS_FUNCTION(Immediate)
+     public:
+        Immediate(
+            JsFunction::Ptr callback,
+            JsArray::Ptr args)
+            : callback_(callback)
+            , args_(args) {}
+
+        Value operator()(JsArray::Ptr args) {
+            if (callback_) {
+                JsFunction::Ptr cb = callback_;
+                callback_ = JsFunction::null();
+                (*cb)(args_);
+            }
+            return libj::Status::OK;
+        }
+
+        Boolean clear() {
+            if (callback_) {
+                callback_ = JsFunction::null();
+                args_ = JsArray::null();
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+     private:
+        JsFunction::Ptr callback_;
+        JsArray::Ptr args_;
+    };
+
 }  // namespace
 
 Value setTimeout(JsFunction::Ptr callback, UInt delay, JsArray::Ptr args) {
     if (!callback) return UNDEFINED;
 
     if (delay == 0 || delay > TIMEOUT_MAX) delay = 1;
-    detail::uv::Timer* timer = new detail::uv::Timer();
+    detail::uv::Timer* timer = new detail::uv::Timer(detail::uv::currentLoop());
     OnTimeout::Ptr onTimeout(new OnTimeout(callback, args, timer, false));
     timer->setOnTimeout(onTimeout);
     timer->start(delay, 0);
@@ -54,7 +87,7 @@ Value setInterval(JsFunction::Ptr callback, UInt delay, JsArray::Ptr args) {
     if (!callback) return UNDEFINED;
 
     if (delay == 0 || delay > TIMEOUT_MAX) delay = 1;
-    detail::uv::Timer* timer = new detail::uv::Timer();
+    detail::uv::Timer* timer = new detail::uv::Timer(detail::uv::currentLoop());
     OnTimeout::Ptr onTimeout(new OnTimeout(callback, args, timer, true));
     timer->setOnTimeout(onTimeout);
     timer->start(delay, delay);
@@ -81,5 +114,22 @@ Boolean clearInterval(const Value& intervalId) {
     }
 }
 
+Value setImmediate(JsFunction::Ptr callback, JsArray::Ptr args) {
+    if (!callback) return UNDEFINED;
+
+    Immediate::Ptr immediate(new Immediate(callback, args));
+    detail::tickQueue()->pushImmediate(immediate);
+    return immediate;
+}
+
+Boolean clearImmediate(const Value& immediateId) {
+    Immediate::Ptr immediate = toPtr<Immediate>(immediateId);
+    if (immediate) {
+        return immediate->clear();
+    } else {
+        return false;
+    }
+}
+
 }  // namespace node
 }  // namespace libj
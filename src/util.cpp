@@ -1,7 +1,7 @@
-// Copyright (c) 2012-2013 Plenluno All rights reserved.
+// Copyright (c) 2012-2015 Plenluno All rights reserved.
 
-#include <libnode/config.h>
 #include <libnode/util.h>
+#include <libnode/detail/util/codec.h>
 
 #include <libj/error.h>
 #include <libj/endian.h>
@@ -10,13 +10,7 @@
 
 #include <assert.h>
 
-#ifdef LIBNODE_USE_CRYPTO
-# include <openssl/bio.h>
-# include <openssl/buffer.h>
-# include <openssl/evp.h>
-#else
-# include <b64/b64.h>
-#endif
+#include <string>
 
 namespace libj {
 namespace node {
@@ -63,53 +57,34 @@ String::CPtr hexEncode(Buffer::CPtr buf) {
 
 String::CPtr hexEncode(const void* data, Size len) {
     if (!data) return String::null();
+    if (!len) return String::create();
 
-    const UByte* bytes = static_cast<const UByte*>(data);
-    Buffer::Ptr encoded = Buffer::create(len * 2);
-    for (Size i = 0; i < len; i++) {
-        UByte byte = bytes[i];
-        const UByte msb = (byte >> 4) & 0x0f;
-        const UByte lsb = byte & 0x0f;
-        encoded->writeUInt8(
-            (msb < 10) ? msb + '0' : (msb - 10) + 'a', i * 2);
-        encoded->writeUInt8(
-            (lsb < 10) ? lsb + '0' : (lsb - 10) + 'a', i * 2 + 1);
-    }
-    return encoded->toString();
+    std::string encoded(len * 2, '\0');
+    detail::util::hexEncode(static_cast<const UByte*>(data), len, &encoded[0]);
+    return String::create(encoded.data(), String::UTF8, encoded.length());
 }
 
-static Boolean decodeHex(Char c, UByte* decoded) {
-    if (!decoded) return false;
-
-    if (c >= '0' && c <= '9') {
-        *decoded = c - '0';
-        return true;
-    } else if (c >= 'a' && c <= 'f') {
-        *decoded = c - 'a' + 10;
-        return true;
-    } else {
-        return false;
-    }
+static UByte* mutableData(Buffer::Ptr buf) {
+    return static_cast<UByte*>(const_cast<void*>(buf->data()));
 }
 
 template<typename T>
 static Buffer::Ptr hexDecode(T t) {
     if (!t) return Buffer::null();
     if (t->length() & 1) return Buffer::null();
+    if (!t->length()) return Buffer::create();
 
-    Size len = t->length() >> 1;
-    Buffer::Ptr decoded = Buffer::create(len);
-    for (Size i = 0; i < len; i++) {
-        Char c1 = t->charAt(i * 2);
-        Char c2 = t->charAt(i * 2 + 1);
-        UByte msb, lsb;
-        if (decodeHex(c1, &msb) && decodeHex(c2, &lsb)) {
-            decoded->writeUInt8((msb << 4) + lsb, i);
-        } else {
-            return Buffer::null();
-        }
+    // non-ASCII chars are longer in UTF-8
+    std::string src = t->toStdString();
+    if (src.length() != t->length()) return Buffer::null();
+
+    Buffer::Ptr decoded = Buffer::create(src.length() >> 1);
+    if (detail::util::hexDecode(
+            src.data(), src.length(), mutableData(decoded))) {
+        return decoded;
+    } else {
+        return Buffer::null();
     }
-    return decoded;
 }
 
 Buffer::Ptr hexDecode(String::CPtr str) {
@@ -134,26 +109,14 @@ String::CPtr base64Encode(Buffer::CPtr buf) {
     }
 }
 
-#ifdef LIBNODE_USE_CRYPTO
-
 String::CPtr base64Encode(const void* data, Size len) {
     if (!data) return String::null();
     if (!len) return String::create();
 
-    BIO* bio = BIO_new(BIO_f_base64());
-    BIO* bioMem = BIO_new(BIO_s_mem());
-    bio = BIO_push(bio, bioMem);
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, data, len);
-    int ret = BIO_flush(bio);
-    assert(ret == 1);
-
-    BUF_MEM* bufMem;
-    BIO_get_mem_ptr(bio, &bufMem);
-    String::CPtr encoded =
-        String::create(bufMem->data, String::UTF8, bufMem->length);
-    BIO_free_all(bio);
-    return encoded;
+    std::string encoded(detail::util::base64EncodedLength(len), '\0');
+    detail::util::base64Encode(
+        static_cast<const UByte*>(data), len, &encoded[0]);
+    return String::create(encoded.data(), String::UTF8, encoded.length());
 }
 
 template<typename T>
@@ -162,67 +125,20 @@ static Buffer::Ptr base64Decode(T t) {
     if (!t->length()) return Buffer::create();
 
     std::string src = t->toStdString();
-    Size len = src.length();
-    if (len != t->length()) return Buffer::null();
-
-    BIO* bio = BIO_new(BIO_f_base64());
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO* bioMem = BIO_new_mem_buf(const_cast<char*>(src.c_str()), len);
-    bio = BIO_push(bio, bioMem);
-
-    char* dst = new char[len + 1];
-    int readLen = BIO_read(bio, dst, len);
-    Buffer::Ptr decoded;
-    if (readLen > 0) {
-        decoded = Buffer::create(dst, readLen);
-    } else {
-        decoded = Buffer::null();
-    }
-    BIO_free_all(bio);
-    delete[] dst;
-    return decoded;
-}
-
-#else  // LIBNODE_USE_CRYPTO
-
-String::CPtr base64Encode(const void* data, Size len) {
-    if (!data) return String::null();
-    if (!len) return String::create();
+    if (src.length() != t->length()) return Buffer::null();
 
-    Size size = b64::b64_encode(data, len, NULL, 0);
-    char* buf = new char[size];
-    size = b64::b64_encode(data, len, buf, size);
-    String::CPtr encoded = String::create(buf, String::UTF8, size);
-    delete[] buf;
-    return encoded;
-}
+    Size len = detail::util::base64DecodedLength(src.data(), src.length());
+    if (len == NO_POS || !len) return Buffer::null();
 
-template<typename T>
-static Buffer::Ptr base64Decode(T t) {
-    if (!t) return Buffer::null();
-    if (!t->length()) return Buffer::create();
-
-    std::string src = t->toStdString();
-    Size len = src.length();
-    b64::B64_RC rc;
-    const char* bad = NULL;
-    const unsigned flags = b64::B64_F_STOP_ON_UNKNOWN_CHAR;
-    Size size = b64::b64_decode2(src.c_str(), len, NULL, 0, flags, &bad, &rc);
-
-    char* dst = new char[size];
-    size = b64::b64_decode2(src.c_str(), len, dst, size, flags, &bad, &rc);
-    Buffer::Ptr decoded;
-    if (size && rc == b64::B64_RC_OK && !bad) {
-        decoded = Buffer::create(dst, size);
+    Buffer::Ptr decoded = Buffer::create(len);
+    if (detail::util::base64Decode(
+            src.data(), src.length(), mutableData(decoded))) {
+        return decoded;
     } else {
-        decoded = Buffer::null();
+        return Buffer::null();
     }
-    delete[] dst;
-    return decoded;
 }
 
-#endif  // LIBNODE_USE_CRYPTO
-
 Buffer::Ptr base64Decode(String::CPtr str) {
     return base64Decode<String::CPtr>(str);
 }
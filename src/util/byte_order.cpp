@@ -0,0 +1,129 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/detail/util/byte_order.h>
+#include <libnode/detail/util/codec.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBNODE_BYTE_ORDER_X86
+# define LIBNODE_BYTE_ORDER_TARGET(T) __attribute__((target(T)))
+# include <immintrin.h>
+#endif
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+// -- scalar --
+
+template<Size N>
+static void swapCopyScalar(UByte* dst, const UByte* src, Size count) {
+    typedef SwapUnit<N> Unit;
+    for (Size i = 0; i < count; i++) {
+        typename Unit::Type u;
+        memcpy(&u, src + i * N, N);
+        u = Unit::swap(u);
+        memcpy(dst + i * N, &u, N);
+    }
+}
+
+static void swapCopyScalar(
+    UByte* dst, const UByte* src, Size count, Size size) {
+    switch (size) {
+    case 2:
+        swapCopyScalar<2>(dst, src, count);
+        break;
+    case 4:
+        swapCopyScalar<4>(dst, src, count);
+        break;
+    case 8:
+        swapCopyScalar<8>(dst, src, count);
+        break;
+    default:
+        memmove(dst, src, count * size);
+        break;
+    }
+}
+
+#ifdef LIBNODE_BYTE_ORDER_X86
+
+// the shuffle reversing each unit of size bytes in a 16-byte lane
+static const UByte* reverseShuffle(Size size) {
+    static const UByte SHUFFLES[3][16] = {
+        { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+        { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+        { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 },
+    };
+    switch (size) {
+    case 2:  return SHUFFLES[0];
+    case 4:  return SHUFFLES[1];
+    default: return SHUFFLES[2];
+    }
+}
+
+// -- ssse3 --
+
+LIBNODE_BYTE_ORDER_TARGET("ssse3")
+static void swapCopySsse3(
+    UByte* dst, const UByte* src, Size count, Size size) {
+    const __m128i shuffle = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(reverseShuffle(size)));
+    Size len = count * size;
+    Size i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + i),
+            _mm_shuffle_epi8(v, shuffle));
+    }
+    swapCopyScalar(dst + i, src + i, (len - i) / size, size);
+}
+
+// -- avx2 --
+
+LIBNODE_BYTE_ORDER_TARGET("avx2")
+static void swapCopyAvx2(
+    UByte* dst, const UByte* src, Size count, Size size) {
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(reverseShuffle(size))));
+    Size len = count * size;
+    Size i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(dst + i),
+            _mm256_shuffle_epi8(v, shuffle));
+    }
+    _mm256_zeroupper();
+    swapCopyScalar(dst + i, src + i, (len - i) / size, size);
+}
+
+#endif  // LIBNODE_BYTE_ORDER_X86
+
+// -- dispatch --
+
+void swapCopy(UByte* dst, const UByte* src, Size count, Size size) {
+    if (size != 2 && size != 4 && size != 8) {
+        swapCopyScalar(dst, src, count, size);
+        return;
+    }
+
+#ifdef LIBNODE_BYTE_ORDER_X86
+    Isa level = isa();
+    if (level >= ISA_AVX2) {
+        swapCopyAvx2(dst, src, count, size);
+        return;
+    } else if (level >= ISA_SSSE3) {
+        swapCopySsse3(dst, src, count, size);
+        return;
+    }
+#endif
+    swapCopyScalar(dst, src, count, size);
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
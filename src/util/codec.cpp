@@ -0,0 +1,613 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/detail/util/codec.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBNODE_CODEC_X86
+# define LIBNODE_CODEC_TARGET(T) __attribute__((target(T)))
+# include <immintrin.h>
+#endif
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+static const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 0xff for the invalid chars
+static const UByte BASE64_VALUES[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255,  62, 255, 255, 255,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,
+     60,  61, 255, 255, 255, 255, 255, 255,
+    255,   0,   1,   2,   3,   4,   5,   6,
+      7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,
+     23,  24,  25, 255, 255, 255, 255, 255,
+    255,  26,  27,  28,  29,  30,  31,  32,
+     33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,
+     49,  50,  51, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+// -- scalar --
+
+static inline Int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else {
+        return -1;
+    }
+}
+
+static void hexEncodeScalar(const UByte* src, Size len, char* dst) {
+    for (Size i = 0; i < len; i++) {
+        dst[i * 2] = HEX_DIGITS[src[i] >> 4];
+        dst[i * 2 + 1] = HEX_DIGITS[src[i] & 0x0f];
+    }
+}
+
+static Boolean hexDecodeScalar(const char* src, Size len, UByte* dst) {
+    for (Size i = 0; i < len; i += 2) {
+        Int msb = hexValue(src[i]);
+        Int lsb = hexValue(src[i + 1]);
+        if (msb < 0 || lsb < 0) return false;
+        dst[i >> 1] = static_cast<UByte>((msb << 4) | lsb);
+    }
+    return true;
+}
+
+static void base64EncodeScalar(const UByte* src, Size len, char* dst) {
+    Size i = 0;
+    for (; i + 3 <= len; i += 3) {
+        UInt n = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+        *dst++ = BASE64_CHARS[(n >> 18) & 0x3f];
+        *dst++ = BASE64_CHARS[(n >> 12) & 0x3f];
+        *dst++ = BASE64_CHARS[(n >> 6) & 0x3f];
+        *dst++ = BASE64_CHARS[n & 0x3f];
+    }
+
+    Size rest = len - i;
+    if (rest) {
+        UInt n = src[i] << 16;
+        if (rest == 2) n |= src[i + 1] << 8;
+        *dst++ = BASE64_CHARS[(n >> 18) & 0x3f];
+        *dst++ = BASE64_CHARS[(n >> 12) & 0x3f];
+        *dst++ = rest == 2 ? BASE64_CHARS[(n >> 6) & 0x3f] : '=';
+        *dst++ = '=';
+    }
+}
+
+// src is not padded, and len % 4 != 1
+static Boolean base64DecodeScalar(const char* src, Size len, UByte* dst) {
+    Size i = 0;
+    for (; i + 4 <= len; i += 4) {
+        UInt a = BASE64_VALUES[static_cast<UByte>(src[i])];
+        UInt b = BASE64_VALUES[static_cast<UByte>(src[i + 1])];
+        UInt c = BASE64_VALUES[static_cast<UByte>(src[i + 2])];
+        UInt d = BASE64_VALUES[static_cast<UByte>(src[i + 3])];
+        if ((a | b | c | d) & 0x80) return false;
+
+        UInt n = (a << 18) | (b << 12) | (c << 6) | d;
+        *dst++ = static_cast<UByte>(n >> 16);
+        *dst++ = static_cast<UByte>(n >> 8);
+        *dst++ = static_cast<UByte>(n);
+    }
+
+    Size rest = len - i;
+    if (rest) {
+        UInt a = BASE64_VALUES[static_cast<UByte>(src[i])];
+        UInt b = BASE64_VALUES[static_cast<UByte>(src[i + 1])];
+        UInt c = rest == 3 ? BASE64_VALUES[static_cast<UByte>(src[i + 2])] : 0;
+        if ((a | b | c) & 0x80) return false;
+
+        UInt n = (a << 18) | (b << 12) | (c << 6);
+        *dst++ = static_cast<UByte>(n >> 16);
+        if (rest == 3) *dst++ = static_cast<UByte>(n >> 8);
+    }
+    return true;
+}
+
+#ifdef LIBNODE_CODEC_X86
+
+// -- sse2 --
+
+// n + '0', or n - 10 + 'a' for n > 9
+LIBNODE_CODEC_TARGET("sse2")
+static inline __m128i hexDigits128(__m128i n) {
+    __m128i alpha = _mm_and_si128(
+        _mm_cmpgt_epi8(n, _mm_set1_epi8(9)),
+        _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+}
+
+LIBNODE_CODEC_TARGET("sse2")
+static void hexEncodeSse2(const UByte* src, Size len, char* dst) {
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    Size i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = hexDigits128(_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i lo = hexDigits128(_mm_and_si128(in, mask));
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * 2);
+        _mm_storeu_si128(out, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(hi, lo));
+    }
+    hexEncodeScalar(src + i, len - i, dst + i * 2);
+}
+
+// 16 chars to 8 bytes in the low 16-bit lanes, or false if invalid
+LIBNODE_CODEC_TARGET("sse2")
+static inline Boolean hexValues128(__m128i in, __m128i* values) {
+    __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_cmpeq_epi8(
+        _mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i alpha = _mm_sub_epi8(in, _mm_set1_epi8('a'));
+    __m128i isAlpha = _mm_cmpeq_epi8(
+        _mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xffff) {
+        return false;
+    }
+
+    __m128i n = _mm_or_si128(
+        _mm_and_si128(isDigit, digit),
+        _mm_and_si128(isAlpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+
+    // each 16-bit lane holds the high nibble in its low byte
+    __m128i hi = _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0xff)), 4);
+    __m128i lo = _mm_srli_epi16(n, 8);
+    *values = _mm_or_si128(hi, lo);
+    return true;
+}
+
+LIBNODE_CODEC_TARGET("sse2")
+static Boolean hexDecodeSse2(const char* src, Size len, UByte* dst) {
+    Size i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+        __m128i v0, v1;
+        if (!hexValues128(_mm_loadu_si128(in), &v0) ||
+            !hexValues128(_mm_loadu_si128(in + 1), &v1)) {
+            return false;
+        }
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + (i >> 1)),
+            _mm_packus_epi16(v0, v1));
+    }
+    return hexDecodeScalar(src + i, len - i, dst + (i >> 1));
+}
+
+// -- ssse3 --
+// base64 after Wojciech Mula's "Base64 encoding and decoding with SIMD"
+
+// 12 bytes to 16 sextets
+LIBNODE_CODEC_TARGET("ssse3")
+static inline __m128i base64Sextets128(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+LIBNODE_CODEC_TARGET("ssse3")
+static inline __m128i base64Chars128(__m128i sextets) {
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i index = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+    index = _mm_or_si128(index, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    const __m128i shift = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, index), sextets);
+}
+
+LIBNODE_CODEC_TARGET("ssse3")
+static void base64EncodeSsse3(const UByte* src, Size len, char* dst) {
+    Size i = 0;
+    for (; i + 16 <= len; i += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst),
+            base64Chars128(base64Sextets128(in)));
+        dst += 16;
+    }
+    base64EncodeScalar(src + i, len - i, dst);
+}
+
+// 16 chars to sextets, or false if invalid
+LIBNODE_CODEC_TARGET("ssse3")
+static inline Boolean base64Values128(__m128i in, __m128i* values) {
+    const __m128i shiftLut = _mm_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i maskLut = _mm_setr_epi8(
+        static_cast<char>(0xa8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8),
+        static_cast<char>(0xf0),
+        0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m128i bitLut = _mm_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+        0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m128i hi = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    __m128i lo = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+    __m128i valid = _mm_and_si128(
+        _mm_shuffle_epi8(maskLut, lo),
+        _mm_shuffle_epi8(bitLut, hi));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128()))) {
+        return false;
+    }
+
+    // '/' is the only char in its range shifted by 16
+    __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    __m128i shift = _mm_or_si128(
+        _mm_andnot_si128(slash, _mm_shuffle_epi8(shiftLut, hi)),
+        _mm_and_si128(slash, _mm_set1_epi8(16)));
+    *values = _mm_add_epi8(in, shift);
+    return true;
+}
+
+// 16 sextets to 12 bytes
+LIBNODE_CODEC_TARGET("ssse3")
+static inline __m128i base64Bytes128(__m128i values) {
+    __m128i ab = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i abc = _mm_madd_epi16(ab, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(abc, _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+LIBNODE_CODEC_TARGET("ssse3")
+static Boolean base64DecodeSsse3(const char* src, Size len, UByte* dst) {
+    // 16 bytes are stored for every 12 decoded
+    Size i = 0;
+    for (; i + 24 <= len; i += 16) {
+        __m128i values;
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (!base64Values128(in, &values)) return false;
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst),
+            base64Bytes128(values));
+        dst += 12;
+    }
+    return base64DecodeScalar(src + i, len - i, dst);
+}
+
+// -- avx2 --
+
+LIBNODE_CODEC_TARGET("avx2")
+static inline __m256i broadcast256(__m128i v) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(v), v, 1);
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static inline __m256i hexDigits256(__m256i n) {
+    __m256i alpha = _mm256_and_si256(
+        _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)),
+        _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), alpha);
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static void hexEncodeAvx2(const UByte* src, Size len, char* dst) {
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    Size i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i in =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i hi =
+            hexDigits256(_mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+        __m256i lo = hexDigits256(_mm256_and_si256(in, mask));
+
+        // the unpacks work within the 128-bit lanes
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        __m256i* out = reinterpret_cast<__m256i*>(dst + i * 2);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    _mm256_zeroupper();
+    hexEncodeSse2(src + i, len - i, dst + i * 2);
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static inline Boolean hexValues256(__m256i in, __m256i* values) {
+    __m256i digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+    __m256i isDigit = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i alpha = _mm256_sub_epi8(in, _mm256_set1_epi8('a'));
+    __m256i isAlpha = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1) {
+        return false;
+    }
+
+    __m256i n = _mm256_or_si256(
+        _mm256_and_si256(isDigit, digit),
+        _mm256_and_si256(
+            isAlpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+    __m256i hi = _mm256_slli_epi16(
+        _mm256_and_si256(n, _mm256_set1_epi16(0xff)), 4);
+    __m256i lo = _mm256_srli_epi16(n, 8);
+    *values = _mm256_or_si256(hi, lo);
+    return true;
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static Boolean hexDecodeAvx2(const char* src, Size len, UByte* dst) {
+    Size i = 0;
+    for (; i + 64 <= len; i += 64) {
+        const __m256i* in = reinterpret_cast<const __m256i*>(src + i);
+        __m256i v0, v1;
+        if (!hexValues256(_mm256_loadu_si256(in), &v0) ||
+            !hexValues256(_mm256_loadu_si256(in + 1), &v1)) {
+            return false;
+        }
+
+        // the pack interleaves the 128-bit lanes of v0 and v1
+        __m256i packed = _mm256_packus_epi16(v0, v1);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(dst + (i >> 1)),
+            _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    _mm256_zeroupper();
+    return hexDecodeSse2(src + i, len - i, dst + (i >> 1));
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static void base64EncodeAvx2(const UByte* src, Size len, char* dst) {
+    const __m256i shuffle = broadcast256(_mm_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i shift = broadcast256(_mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0));
+
+    // 12 bytes are encoded in each 128-bit lane
+    Size i = 0;
+    for (; i + 28 <= len; i += 24) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuffle);
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i sextets = _mm256_or_si256(t1, t3);
+
+        __m256i index = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+        index = _mm256_or_si256(
+            index, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(dst),
+            _mm256_add_epi8(_mm256_shuffle_epi8(shift, index), sextets));
+        dst += 32;
+    }
+    _mm256_zeroupper();
+    base64EncodeSsse3(src + i, len - i, dst);
+}
+
+LIBNODE_CODEC_TARGET("avx2")
+static Boolean base64DecodeAvx2(const char* src, Size len, UByte* dst) {
+    const __m256i shiftLut = broadcast256(_mm_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i maskLut = broadcast256(_mm_setr_epi8(
+        static_cast<char>(0xa8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8), static_cast<char>(0xf8),
+        static_cast<char>(0xf8),
+        static_cast<char>(0xf0),
+        0x54, 0x50, 0x50, 0x50, 0x54));
+    const __m256i bitLut = broadcast256(_mm_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+        0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i pack = broadcast256(_mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    // 32 bytes are stored for every 24 decoded
+    Size i = 0;
+    for (; i + 48 <= len; i += 32) {
+        __m256i in =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i hi = _mm256_and_si256(
+            _mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+        __m256i lo = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+        __m256i valid = _mm256_and_si256(
+            _mm256_shuffle_epi8(maskLut, lo),
+            _mm256_shuffle_epi8(bitLut, hi));
+        if (_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(valid, _mm256_setzero_si256()))) {
+            return false;
+        }
+
+        __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        __m256i shift = _mm256_or_si256(
+            _mm256_andnot_si256(slash, _mm256_shuffle_epi8(shiftLut, hi)),
+            _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        __m256i values = _mm256_add_epi8(in, shift);
+
+        __m256i ab =
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i abc = _mm256_madd_epi16(ab, _mm256_set1_epi32(0x00011000));
+        __m256i bytes = _mm256_permutevar8x32_epi32(
+            _mm256_shuffle_epi8(abc, pack), gather);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), bytes);
+        dst += 24;
+    }
+    _mm256_zeroupper();
+    return base64DecodeSsse3(src + i, len - i, dst);
+}
+
+static Isa detect() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ISA_AVX2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        return ISA_SSSE3;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return ISA_SSE2;
+    } else {
+        return ISA_SCALAR;
+    }
+}
+
+#else  // LIBNODE_CODEC_X86
+
+static Isa detect() {
+    return ISA_SCALAR;
+}
+
+#endif  // LIBNODE_CODEC_X86
+
+// -- dispatch --
+
+static Isa& currentIsa() {
+    static Isa isa = detectedIsa();
+    return isa;
+}
+
+Isa detectedIsa() {
+    static Isa isa = detect();
+    return isa;
+}
+
+Isa isa() {
+    return currentIsa();
+}
+
+Isa setIsa(Isa isa) {
+    if (isa > detectedIsa()) isa = detectedIsa();
+    currentIsa() = isa;
+    return isa;
+}
+
+void hexEncode(const UByte* src, Size len, char* dst) {
+    switch (isa()) {
+#ifdef LIBNODE_CODEC_X86
+    case ISA_AVX2:
+        hexEncodeAvx2(src, len, dst);
+        break;
+    case ISA_SSSE3:
+    case ISA_SSE2:
+        hexEncodeSse2(src, len, dst);
+        break;
+#endif
+    default:
+        hexEncodeScalar(src, len, dst);
+    }
+}
+
+Boolean hexDecode(const char* src, Size len, UByte* dst) {
+    if (len & 1) return false;
+
+    switch (isa()) {
+#ifdef LIBNODE_CODEC_X86
+    case ISA_AVX2:
+        return hexDecodeAvx2(src, len, dst);
+    case ISA_SSSE3:
+    case ISA_SSE2:
+        return hexDecodeSse2(src, len, dst);
+#endif
+    default:
+        return hexDecodeScalar(src, len, dst);
+    }
+}
+
+Size base64EncodedLength(Size len) {
+    return (len + 2) / 3 * 4;
+}
+
+void base64Encode(const UByte* src, Size len, char* dst) {
+    switch (isa()) {
+#ifdef LIBNODE_CODEC_X86
+    case ISA_AVX2:
+        base64EncodeAvx2(src, len, dst);
+        break;
+    case ISA_SSSE3:
+        base64EncodeSsse3(src, len, dst);
+        break;
+#endif
+    default:
+        base64EncodeScalar(src, len, dst);
+    }
+}
+
+// the unpadded length of src
+static Size base64Chars(const char* src, Size len) {
+    Size pad = 0;
+    if (len && src[len - 1] == '=') pad++;
+    if (len > 1 && src[len - 2] == '=') pad++;
+    if (pad && (len & 3)) return NO_POS;
+
+    Size chars = len - pad;
+    if ((chars & 3) == 1) return NO_POS;
+    if (pad && chars < 2) return NO_POS;
+    return chars;
+}
+
+Size base64DecodedLength(const char* src, Size len) {
+    Size chars = base64Chars(src, len);
+    if (chars == NO_POS) return NO_POS;
+
+    return chars / 4 * 3 + ((chars & 3) ? (chars & 3) - 1 : 0);
+}
+
+Boolean base64Decode(const char* src, Size len, UByte* dst) {
+    Size chars = base64Chars(src, len);
+    if (chars == NO_POS) return false;
+
+    switch (isa()) {
+#ifdef LIBNODE_CODEC_X86
+    case ISA_AVX2:
+        return base64DecodeAvx2(src, chars, dst);
+    case ISA_SSSE3:
+        return base64DecodeSsse3(src, chars, dst);
+#endif
+    default:
+        return base64DecodeScalar(src, chars, dst);
+    }
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
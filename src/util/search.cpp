@@ -0,0 +1,178 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/detail/util/search.h>
+#include <libnode/detail/util/codec.h>
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBNODE_SEARCH_X86
+# define LIBNODE_SEARCH_TARGET(T) __attribute__((target(T)))
+# include <immintrin.h>
+#endif
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+// -- scalar --
+
+static Size searchScalar(
+    const UByte* haystack,
+    Size length,
+    Size i,
+    const UByte* needle,
+    Size needleLength) {
+    Size last = length - needleLength;
+    while (i <= last) {
+        const void* found = memchr(haystack + i, needle[0], last - i + 1);
+        if (!found) return NO_POS;
+
+        i = static_cast<const UByte*>(found) - haystack;
+        if (!memcmp(haystack + i + 1, needle + 1, needleLength - 1)) {
+            return i;
+        }
+        i++;
+    }
+    return NO_POS;
+}
+
+#ifdef LIBNODE_SEARCH_X86
+
+// the first and the last bytes of the needle filter the candidates,
+// after Wojciech Mula's "SIMD-friendly algorithms for substring searching"
+
+// a block without the first byte is skipped at the speed of memchr.
+// returns end if there is no more first byte.
+static inline Size skip(const UByte* haystack, Size end, Size i, UByte c) {
+    const void* found = memchr(haystack + i, c, end - i);
+    return found ? static_cast<const UByte*>(found) - haystack : end;
+}
+
+// -- sse2 --
+
+LIBNODE_SEARCH_TARGET("sse2")
+static Size searchSse2(
+    const UByte* haystack,
+    Size length,
+    const UByte* needle,
+    Size needleLength) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const __m128i last = _mm_set1_epi8(
+        static_cast<char>(needle[needleLength - 1]));
+    Size tail = needleLength - 1;
+    Size i = 0;
+    while (i + tail + 16 <= length) {
+        __m128i head = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(haystack + i));
+        UInt mask = _mm_movemask_epi8(_mm_cmpeq_epi8(head, first));
+        if (!mask) {
+            i = skip(haystack, length - tail, i + 16, needle[0]);
+            continue;
+        }
+
+        __m128i end = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(haystack + i + tail));
+        mask &= _mm_movemask_epi8(_mm_cmpeq_epi8(end, last));
+        while (mask) {
+            Size j = i + __builtin_ctz(mask);
+            if (!memcmp(haystack + j + 1, needle + 1, needleLength - 2)) {
+                return j;
+            }
+            mask &= mask - 1;
+        }
+        i += 16;
+    }
+    return searchScalar(haystack, length, i, needle, needleLength);
+}
+
+// -- avx2 --
+
+LIBNODE_SEARCH_TARGET("avx2")
+static Size searchAvx2(
+    const UByte* haystack,
+    Size length,
+    const UByte* needle,
+    Size needleLength) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const __m256i last = _mm256_set1_epi8(
+        static_cast<char>(needle[needleLength - 1]));
+    Size tail = needleLength - 1;
+    Size i = 0;
+    while (i + tail + 32 <= length) {
+        __m256i head = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(haystack + i));
+        UInt mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(head, first));
+        if (!mask) {
+            i = skip(haystack, length - tail, i + 32, needle[0]);
+            continue;
+        }
+
+        __m256i end = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(haystack + i + tail));
+        mask &= _mm256_movemask_epi8(_mm256_cmpeq_epi8(end, last));
+        while (mask) {
+            Size j = i + __builtin_ctz(mask);
+            if (!memcmp(haystack + j + 1, needle + 1, needleLength - 2)) {
+                _mm256_zeroupper();
+                return j;
+            }
+            mask &= mask - 1;
+        }
+        i += 32;
+    }
+    _mm256_zeroupper();
+    return searchScalar(haystack, length, i, needle, needleLength);
+}
+
+#endif  // LIBNODE_SEARCH_X86
+
+// -- dispatch --
+
+Size search(
+    const UByte* haystack,
+    Size length,
+    const UByte* needle,
+    Size needleLength) {
+    if (!needleLength) return 0;
+    if (needleLength > length) return NO_POS;
+
+    if (needleLength == 1) {
+        const void* found = memchr(haystack, needle[0], length);
+        return found ? static_cast<const UByte*>(found) - haystack : NO_POS;
+    }
+
+#ifdef LIBNODE_SEARCH_X86
+    Isa level = isa();
+    if (level >= ISA_AVX2) {
+        return searchAvx2(haystack, length, needle, needleLength);
+    } else if (level >= ISA_SSE2) {
+        return searchSse2(haystack, length, needle, needleLength);
+    }
+#endif
+    return searchScalar(haystack, length, 0, needle, needleLength);
+}
+
+void fill(UByte* dst, Size length, const UByte* pattern, Size patternLength) {
+    if (!length || !patternLength) return;
+
+    if (patternLength == 1) {
+        memset(dst, pattern[0], length);
+        return;
+    }
+
+    // doubles the filled part until it covers dst
+    Size filled = patternLength < length ? patternLength : length;
+    memcpy(dst, pattern, filled);
+    while (filled < length) {
+        Size n = filled < length - filled ? filled : length - filled;
+        memcpy(dst + filled, dst, n);
+        filled += n;
+    }
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj
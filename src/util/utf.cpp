@@ -0,0 +1,574 @@
+// Copyright (c) 2015 Plenluno All rights reserved.
+
+#include <libnode/detail/util/utf.h>
+#include <libnode/detail/util/codec.h>
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBNODE_UTF_X86
+# define LIBNODE_UTF_TARGET(T) __attribute__((target(T)))
+# include <immintrin.h>
+#endif
+
+namespace libj {
+namespace node {
+namespace detail {
+namespace util {
+
+static const UInt REPLACEMENT_CHAR = 0xfffd;
+
+// -- scalar --
+
+static inline Boolean isSurrogate(UInt c) {
+    return (c & 0xfffff800) == 0xd800;
+}
+
+// reads the code point at *i and moves *i past it
+static inline UInt codePoint(const UShort* src, Size len, Size* i) {
+    UInt c = src[(*i)++];
+    if (!isSurrogate(c)) return c;
+
+    if (c < 0xdc00 && *i < len) {
+        UInt d = src[*i];
+        if (d >= 0xdc00 && d < 0xe000) {
+            (*i)++;
+            return 0x10000 + ((c - 0xd800) << 10) + (d - 0xdc00);
+        }
+    }
+    return REPLACEMENT_CHAR;
+}
+
+static inline UInt codePoint(const UInt* src, Size, Size* i) {
+    UInt c = src[(*i)++];
+    if (c > 0x10ffff || isSurrogate(c)) {
+        return REPLACEMENT_CHAR;
+    } else {
+        return c;
+    }
+}
+
+static inline Size utf8Width(UInt c) {
+    if (c < 0x80) {
+        return 1;
+    } else if (c < 0x800) {
+        return 2;
+    } else if (c < 0x10000) {
+        return 3;
+    } else {
+        return 4;
+    }
+}
+
+// the bytes of the chars from *i to end
+template<typename U>
+static inline Size utf8Bytes(const U* src, Size len, Size* i, Size end) {
+    Size n = 0;
+    while (*i < end) n += utf8Width(codePoint(src, len, i));
+    return n;
+}
+
+// false if the char at *i does not fit in dst
+template<typename U>
+static inline Boolean utf8Char(
+    const U* src, Size len, Size* i, UByte* dst, Size dstLen, Size* n) {
+    if (src[*i] < 0x80) {
+        if (*n >= dstLen) return false;
+        dst[(*n)++] = static_cast<UByte>(src[(*i)++]);
+        return true;
+    }
+
+    Size j = *i;
+    UInt c = codePoint(src, len, &j);
+    Size w = utf8Width(c);
+    if (*n + w > dstLen) return false;
+
+    UByte* p = dst + *n;
+    switch (w) {
+    case 2:
+        p[0] = static_cast<UByte>(0xc0 | (c >> 6));
+        p[1] = static_cast<UByte>(0x80 | (c & 0x3f));
+        break;
+    case 3:
+        p[0] = static_cast<UByte>(0xe0 | (c >> 12));
+        p[1] = static_cast<UByte>(0x80 | ((c >> 6) & 0x3f));
+        p[2] = static_cast<UByte>(0x80 | (c & 0x3f));
+        break;
+    default:
+        p[0] = static_cast<UByte>(0xf0 | (c >> 18));
+        p[1] = static_cast<UByte>(0x80 | ((c >> 12) & 0x3f));
+        p[2] = static_cast<UByte>(0x80 | ((c >> 6) & 0x3f));
+        p[3] = static_cast<UByte>(0x80 | (c & 0x3f));
+        break;
+    }
+    *i = j;
+    *n += w;
+    return true;
+}
+
+template<typename U>
+static Size utf8EncodeScalar(
+    const U* src, Size len, Size i, UByte* dst, Size dstLen, Size n) {
+    while (i < len && utf8Char(src, len, &i, dst, dstLen, &n)) {}
+    return n;
+}
+
+static inline void putUtf16(UByte* dst, UInt c, Boolean bigEndian) {
+    if (bigEndian) {
+        dst[0] = static_cast<UByte>(c >> 8);
+        dst[1] = static_cast<UByte>(c);
+    } else {
+        dst[0] = static_cast<UByte>(c);
+        dst[1] = static_cast<UByte>(c >> 8);
+    }
+}
+
+static inline void putUtf32(UByte* dst, UInt c, Boolean bigEndian) {
+    if (bigEndian) {
+        dst[0] = static_cast<UByte>(c >> 24);
+        dst[1] = static_cast<UByte>(c >> 16);
+        dst[2] = static_cast<UByte>(c >> 8);
+        dst[3] = static_cast<UByte>(c);
+    } else {
+        dst[0] = static_cast<UByte>(c);
+        dst[1] = static_cast<UByte>(c >> 8);
+        dst[2] = static_cast<UByte>(c >> 16);
+        dst[3] = static_cast<UByte>(c >> 24);
+    }
+}
+
+static void copyUtf16Scalar(
+    const UShort* src, Size len, UByte* dst, Boolean bigEndian) {
+    for (Size i = 0; i < len; i++) {
+        putUtf16(dst + (i << 1), src[i], bigEndian);
+    }
+}
+
+static void copyUtf32Scalar(
+    const UInt* src, Size len, UByte* dst, Boolean bigEndian) {
+    for (Size i = 0; i < len; i++) {
+        putUtf32(dst + (i << 2), src[i], bigEndian);
+    }
+}
+
+#ifdef LIBNODE_UTF_X86
+
+// -- sse2 --
+
+// the lanes of acc count the units as -1s
+LIBNODE_UTF_TARGET("sse2")
+static inline Size countedUnits(__m128i acc) {
+    __m128i sum = _mm_madd_epi16(acc, _mm_set1_epi16(1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    return static_cast<Size>(-_mm_cvtsi128_si32(sum));
+}
+
+// flushed before a lane of the counts can overflow
+static const Size COUNT_BLOCKS = 8192;
+
+LIBNODE_UTF_TARGET("sse2")
+static Size utf8LengthSse2(const UShort* src, Size len) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask80 = _mm_set1_epi16(static_cast<Short>(0xff80));
+    const __m128i mask800 = _mm_set1_epi16(static_cast<Short>(0xf800));
+    const __m128i surrogate = _mm_set1_epi16(static_cast<Short>(0xd800));
+    __m128i narrow = zero;
+    Size blocks = 0;
+    Size i = 0;
+    Size n = 0;
+    while (i + 8 <= len) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_and_si128(v, mask800);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(hi, surrogate))) {
+            n += utf8Bytes(src, len, &i, i + 8);
+            continue;
+        }
+
+        // 3 bytes per unit, less one below 0x800 and another below 0x80
+        narrow = _mm_add_epi16(narrow, _mm_add_epi16(
+            _mm_cmpeq_epi16(hi, zero),
+            _mm_cmpeq_epi16(_mm_and_si128(v, mask80), zero)));
+        n += 24;
+        i += 8;
+        if (++blocks == COUNT_BLOCKS) {
+            n -= countedUnits(narrow);
+            narrow = zero;
+            blocks = 0;
+        }
+    }
+    n -= countedUnits(narrow);
+    return n + utf8Bytes(src, len, &i, len);
+}
+
+LIBNODE_UTF_TARGET("sse2")
+static Size utf8LengthSse2(const UInt* src, Size len) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(static_cast<Int>(0xffffff80));
+    Size i = 0;
+    Size n = 0;
+    while (i + 4 <= len) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(v, mask), zero);
+        if (_mm_movemask_epi8(ascii) == 0xffff) {
+            n += 4;
+            i += 4;
+        } else {
+            n += utf8Bytes(src, len, &i, i + 4);
+        }
+    }
+    return n + utf8Bytes(src, len, &i, len);
+}
+
+LIBNODE_UTF_TARGET("sse2")
+static Size utf8EncodeSse2(
+    const UShort* src, Size len, UByte* dst, Size dstLen) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16(static_cast<Short>(0xff80));
+    Size i = 0;
+    Size n = 0;
+    while (i + 16 <= len) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+        __m128i v0 = _mm_loadu_si128(in);
+        __m128i v1 = _mm_loadu_si128(in + 1);
+        __m128i ascii = _mm_cmpeq_epi16(
+            _mm_and_si128(_mm_or_si128(v0, v1), mask), zero);
+        if (n + 16 <= dstLen && _mm_movemask_epi8(ascii) == 0xffff) {
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + n),
+                _mm_packus_epi16(v0, v1));
+            i += 16;
+            n += 16;
+            continue;
+        }
+
+        Size end = i + 16;
+        while (i < end) {
+            if (!utf8Char(src, len, &i, dst, dstLen, &n)) return n;
+        }
+    }
+    return utf8EncodeScalar(src, len, i, dst, dstLen, n);
+}
+
+LIBNODE_UTF_TARGET("sse2")
+static Size utf8EncodeSse2(
+    const UInt* src, Size len, UByte* dst, Size dstLen) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(static_cast<Int>(0xffffff80));
+    Size i = 0;
+    Size n = 0;
+    while (i + 16 <= len) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+        __m128i v0 = _mm_loadu_si128(in);
+        __m128i v1 = _mm_loadu_si128(in + 1);
+        __m128i v2 = _mm_loadu_si128(in + 2);
+        __m128i v3 = _mm_loadu_si128(in + 3);
+        __m128i all = _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3));
+        __m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(all, mask), zero);
+        if (n + 16 <= dstLen && _mm_movemask_epi8(ascii) == 0xffff) {
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + n),
+                _mm_packus_epi16(
+                    _mm_packs_epi32(v0, v1),
+                    _mm_packs_epi32(v2, v3)));
+            i += 16;
+            n += 16;
+            continue;
+        }
+
+        Size end = i + 16;
+        while (i < end) {
+            if (!utf8Char(src, len, &i, dst, dstLen, &n)) return n;
+        }
+    }
+    return utf8EncodeScalar(src, len, i, dst, dstLen, n);
+}
+
+// x86 is little-endian, so only the big-endian copies swap
+LIBNODE_UTF_TARGET("sse2")
+static void copyUtf16Sse2(
+    const UShort* src, Size len, UByte* dst, Boolean bigEndian) {
+    if (!bigEndian) {
+        memcpy(dst, src, len << 1);
+        return;
+    }
+
+    Size i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + (i << 1)),
+            _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+    copyUtf16Scalar(src + i, len - i, dst + (i << 1), bigEndian);
+}
+
+// -- avx2 --
+
+LIBNODE_UTF_TARGET("avx2")
+static inline Size countedUnits(__m256i acc) {
+    return countedUnits(_mm_add_epi16(
+        _mm256_castsi256_si128(acc),
+        _mm256_extracti128_si256(acc, 1)));
+}
+
+LIBNODE_UTF_TARGET("avx2")
+static Size utf8LengthAvx2(const UShort* src, Size len) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask80 = _mm256_set1_epi16(static_cast<Short>(0xff80));
+    const __m256i mask800 = _mm256_set1_epi16(static_cast<Short>(0xf800));
+    const __m256i surrogate = _mm256_set1_epi16(static_cast<Short>(0xd800));
+    __m256i narrow = zero;
+    Size blocks = 0;
+    Size i = 0;
+    Size n = 0;
+    while (i + 16 <= len) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + i));
+        __m256i hi = _mm256_and_si256(v, mask800);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(hi, surrogate))) {
+            n += utf8Bytes(src, len, &i, i + 16);
+            continue;
+        }
+
+        narrow = _mm256_add_epi16(narrow, _mm256_add_epi16(
+            _mm256_cmpeq_epi16(hi, zero),
+            _mm256_cmpeq_epi16(_mm256_and_si256(v, mask80), zero)));
+        n += 48;
+        i += 16;
+        if (++blocks == COUNT_BLOCKS) {
+            n -= countedUnits(narrow);
+            narrow = zero;
+            blocks = 0;
+        }
+    }
+    n -= countedUnits(narrow);
+    _mm256_zeroupper();
+    return n + utf8Bytes(src, len, &i, len);
+}
+
+LIBNODE_UTF_TARGET("avx2")
+static Size utf8EncodeAvx2(
+    const UShort* src, Size len, UByte* dst, Size dstLen) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask = _mm256_set1_epi16(static_cast<Short>(0xff80));
+    Size i = 0;
+    Size n = 0;
+    while (i + 32 <= len) {
+        const __m256i* in = reinterpret_cast<const __m256i*>(src + i);
+        __m256i v0 = _mm256_loadu_si256(in);
+        __m256i v1 = _mm256_loadu_si256(in + 1);
+        __m256i ascii = _mm256_cmpeq_epi16(
+            _mm256_and_si256(_mm256_or_si256(v0, v1), mask), zero);
+        if (n + 32 <= dstLen && _mm256_movemask_epi8(ascii) == -1) {
+            // packus works within the 128-bit lanes
+            __m256i packed = _mm256_permute4x64_epi64(
+                _mm256_packus_epi16(v0, v1), 0xd8);
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(dst + n), packed);
+            i += 32;
+            n += 32;
+            continue;
+        }
+
+        Size end = i + 32;
+        while (i < end) {
+            if (!utf8Char(src, len, &i, dst, dstLen, &n)) {
+                _mm256_zeroupper();
+                return n;
+            }
+        }
+    }
+    _mm256_zeroupper();
+    return utf8EncodeScalar(src, len, i, dst, dstLen, n);
+}
+
+LIBNODE_UTF_TARGET("avx2")
+static void copyUtf16Avx2(
+    const UShort* src, Size len, UByte* dst, Boolean bigEndian) {
+    if (!bigEndian) {
+        memcpy(dst, src, len << 1);
+        return;
+    }
+
+    Size i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(dst + (i << 1)),
+            _mm256_or_si256(
+                _mm256_slli_epi16(v, 8),
+                _mm256_srli_epi16(v, 8)));
+    }
+    _mm256_zeroupper();
+    copyUtf16Scalar(src + i, len - i, dst + (i << 1), bigEndian);
+}
+
+#endif  // LIBNODE_UTF_X86
+
+// -- dispatch --
+
+Size utf8Length(const UShort* src, Size len) {
+#ifdef LIBNODE_UTF_X86
+    Isa level = isa();
+    if (level >= ISA_AVX2) return utf8LengthAvx2(src, len);
+    if (level >= ISA_SSE2) return utf8LengthSse2(src, len);
+#endif
+    Size i = 0;
+    return utf8Bytes(src, len, &i, len);
+}
+
+Size utf8Length(const UInt* src, Size len) {
+#ifdef LIBNODE_UTF_X86
+    if (isa() >= ISA_SSE2) return utf8LengthSse2(src, len);
+#endif
+    Size i = 0;
+    return utf8Bytes(src, len, &i, len);
+}
+
+Size utf8Encode(const UShort* src, Size len, UByte* dst, Size dstLen) {
+#ifdef LIBNODE_UTF_X86
+    Isa level = isa();
+    if (level >= ISA_AVX2) return utf8EncodeAvx2(src, len, dst, dstLen);
+    if (level >= ISA_SSE2) return utf8EncodeSse2(src, len, dst, dstLen);
+#endif
+    return utf8EncodeScalar(src, len, 0, dst, dstLen, 0);
+}
+
+Size utf8Encode(const UInt* src, Size len, UByte* dst, Size dstLen) {
+#ifdef LIBNODE_UTF_X86
+    if (isa() >= ISA_SSE2) return utf8EncodeSse2(src, len, dst, dstLen);
+#endif
+    return utf8EncodeScalar(src, len, 0, dst, dstLen, 0);
+}
+
+// a lone surrogate is replaced by U+FFFD, which is one unit as well
+Size utf16Length(const UShort*, Size len) {
+    return len << 1;
+}
+
+Size utf16Length(const UInt* src, Size len) {
+    Size n = 0;
+    for (Size i = 0; i < len;) {
+        n += codePoint(src, len, &i) < 0x10000 ? 2 : 4;
+    }
+    return n;
+}
+
+static void copyUtf16(
+    const UShort* src, Size len, UByte* dst, Boolean bigEndian) {
+#ifdef LIBNODE_UTF_X86
+    Isa level = isa();
+    if (level >= ISA_AVX2) {
+        copyUtf16Avx2(src, len, dst, bigEndian);
+    } else if (level >= ISA_SSE2) {
+        copyUtf16Sse2(src, len, dst, bigEndian);
+    } else {
+        copyUtf16Scalar(src, len, dst, bigEndian);
+    }
+#else
+    copyUtf16Scalar(src, len, dst, bigEndian);
+#endif
+}
+
+// the runs between surrogates are copied as they are
+Size utf16Encode(
+    const UShort* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian) {
+    Size n = 0;
+    Size i = 0;
+    while (i < len) {
+        Size j = i;
+        Size end = i + ((dstLen - n) >> 1);
+        if (end > len) end = len;
+        while (j < end && !isSurrogate(src[j])) j++;
+        copyUtf16(src + i, j - i, dst + n, bigEndian);
+        n += (j - i) << 1;
+        i = j;
+        if (i == end) break;
+
+        UInt c = codePoint(src, len, &j);
+        if (c < 0x10000) {
+            putUtf16(dst + n, c, bigEndian);
+            n += 2;
+        } else {
+            if (n + 4 > dstLen) break;
+            putUtf16(dst + n, src[i], bigEndian);
+            putUtf16(dst + n + 2, src[i + 1], bigEndian);
+            n += 4;
+        }
+        i = j;
+    }
+    return n;
+}
+
+Size utf16Encode(
+    const UInt* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian) {
+    Size n = 0;
+    for (Size i = 0; i < len;) {
+        UInt c = codePoint(src, len, &i);
+        if (c < 0x10000) {
+            if (n + 2 > dstLen) break;
+            putUtf16(dst + n, c, bigEndian);
+            n += 2;
+        } else {
+            if (n + 4 > dstLen) break;
+            c -= 0x10000;
+            putUtf16(dst + n, 0xd800 + (c >> 10), bigEndian);
+            putUtf16(dst + n + 2, 0xdc00 + (c & 0x3ff), bigEndian);
+            n += 4;
+        }
+    }
+    return n;
+}
+
+Size utf32Length(const UShort* src, Size len) {
+    Size n = 0;
+    for (Size i = 0; i < len; n += 4) {
+        codePoint(src, len, &i);
+    }
+    return n;
+}
+
+Size utf32Length(const UInt*, Size len) {
+    return len << 2;
+}
+
+Size utf32Encode(
+    const UShort* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian) {
+    Size n = 0;
+    for (Size i = 0; i < len && n + 4 <= dstLen; n += 4) {
+        putUtf32(dst + n, codePoint(src, len, &i), bigEndian);
+    }
+    return n;
+}
+
+// the runs of valid code points are copied as they are
+Size utf32Encode(
+    const UInt* src, Size len, UByte* dst, Size dstLen, Boolean bigEndian) {
+    Size count = dstLen >> 2;
+    if (count > len) count = len;
+
+    Size i = 0;
+    while (i < count) {
+        Size j = i;
+        while (j < count && src[j] <= 0x10ffff && !isSurrogate(src[j])) j++;
+#ifdef LIBNODE_UTF_X86
+        if (!bigEndian) {
+            memcpy(dst + (i << 2), src + i, (j - i) << 2);
+        } else {
+            copyUtf32Scalar(src + i, j - i, dst + (i << 2), bigEndian);
+        }
+#else
+        copyUtf32Scalar(src + i, j - i, dst + (i << 2), bigEndian);
+#endif
+        if (j < count) putUtf32(dst + (j << 2), REPLACEMENT_CHAR, bigEndian);
+        i = j + 1;
+    }
+    return count << 2;
+}
+
+}  // namespace util
+}  // namespace detail
+}  // namespace node
+}  // namespace libj